@@ -0,0 +1,222 @@
+#include "pch.h"
+#include "BakkesHost.h"
+
+#include <chrono>
+
+#include "bakkesmod/wrappers/GameObject/CarWrapper.h"
+#include "bakkesmod/wrappers/GameObject/CameraWrapper.h"
+#include "bakkesmod/wrappers/GameObject/BoostWrapper.h"
+#include "bakkesmod/wrappers/GameObject/BallWrapper.h"
+#include "bakkesmod/wrappers/GameObject/CarComponent/CarComponentWrapper.h"
+#include "bakkesmod/wrappers/GameEvent/ServerWrapper.h"
+#include "bakkesmod/wrappers/GameEvent/ReplayServerWrapper.h"
+#include "bakkesmod/wrappers/ReplayWrapper.h"
+
+namespace {
+    void FillCarState(CarWrapper& car, CarState& state) {
+        Vector location = car.GetLocation();
+        Vector velocity = car.GetVelocity();
+        state.location = { location.X, location.Y, location.Z };
+        state.velocity = { velocity.X, velocity.Y, velocity.Z };
+        state.onGround = car.GetbOnGround();
+        state.onWall = car.IsOnWall();
+        state.supersonic = car.GetbSuperSonic();
+
+        auto boost = car.GetBoostComponent();
+        state.boost = boost.IsNull() ? 0.0f : boost.GetCurrentBoostAmount();
+    }
+}
+
+BakkesHost::BakkesHost(std::shared_ptr<GameWrapper> gameWrapper, std::shared_ptr<CVarManagerWrapper> cvarManager)
+    : gameWrapper(std::move(gameWrapper)), cvarManager(std::move(cvarManager)) {
+}
+
+void BakkesHost::HookEvent(const std::string& eventName, std::function<void()> callback) {
+    gameWrapper->HookEvent(eventName, [callback = std::move(callback)](std::string eventName) { callback(); });
+}
+
+void BakkesHost::HookEventWithCaller(const std::string& eventName, std::function<void(CarHandle caller)> callback) {
+    // Car components (double jump, dodge) report the car that owns them
+    bool component = eventName.find("CarComponent_") != std::string::npos;
+    gameWrapper->HookEventWithCaller<ActorWrapper>(eventName,
+        [callback = std::move(callback), component](ActorWrapper caller, void* params, std::string eventName) {
+            if (caller.IsNull()) {
+                callback(0);
+                return;
+            }
+            if (!component) {
+                callback(caller.memory_address);
+                return;
+            }
+            CarWrapper car = CarComponentWrapper(caller.memory_address).GetCar();
+            callback(car.IsNull() ? 0 : car.memory_address);
+        });
+}
+
+void BakkesHost::UnhookEvent(const std::string& eventName) {
+    gameWrapper->UnhookEvent(eventName);
+}
+
+void BakkesHost::SetTimeout(std::function<void()> callback, float delaySeconds) {
+    gameWrapper->SetTimeout([callback = std::move(callback)](GameWrapper* gw) { callback(); }, delaySeconds);
+}
+
+void BakkesHost::Execute(std::function<void()> callback) {
+    gameWrapper->Execute([callback = std::move(callback)](GameWrapper* gw) { callback(); });
+}
+
+double BakkesHost::GetTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool BakkesHost::GetLocalCarState(CarState& state) {
+    auto car = gameWrapper->GetLocalCar();
+    if (!car || car.IsNull()) return false;
+
+    FillCarState(car, state);
+    return true;
+}
+
+CarHandle BakkesHost::GetFocusCar() {
+    auto car = gameWrapper->GetLocalCar();
+    if (car && !car.IsNull()) return car.memory_address;
+
+    // Spectating: whatever the camera is following
+    auto camera = gameWrapper->GetCamera();
+    if (!camera || camera.IsNull()) return 0;
+    return reinterpret_cast<CarHandle>(camera.GetViewTarget().Target);
+}
+
+ServerWrapper BakkesHost::GetServer() {
+    if (gameWrapper->IsInReplay()) return gameWrapper->GetGameEventAsReplay();
+    return gameWrapper->GetCurrentGameState();
+}
+
+bool BakkesHost::GetCarState(CarHandle car, CarState& state) {
+    ServerWrapper server = GetServer();
+    if (!server || car == 0) return false;
+
+    ArrayWrapper<CarWrapper> serverCars = server.GetCars();
+    for (int i = 0; i < serverCars.Count(); ++i) {
+        CarWrapper match = serverCars.Get(i);
+        if (match.IsNull() || match.memory_address != car) continue;
+
+        FillCarState(match, state);
+        return true;
+    }
+    return false;
+}
+
+size_t BakkesHost::GetCars(MatchCar* cars, size_t capacity) {
+    ServerWrapper server = GetServer();
+    if (!server) return 0;
+
+    ArrayWrapper<CarWrapper> serverCars = server.GetCars();
+    size_t count = 0;
+    for (int i = 0; i < serverCars.Count() && count < capacity; ++i) {
+        CarWrapper car = serverCars.Get(i);
+        if (car.IsNull()) continue;
+
+        MatchCar& out = cars[count++];
+        out.handle = car.memory_address;
+        out.team = car.GetTeamNum2() == 1 ? 1 : 0;
+        FillCarState(car, out.state);
+    }
+    return count;
+}
+
+bool BakkesHost::GetReplayTime(double& time) {
+    if (!gameWrapper->IsInReplay()) return false;
+    ReplayServerWrapper replay = gameWrapper->GetGameEventAsReplay();
+    if (!replay) return false;
+
+    time = replay.GetReplayTimeElapsed();
+    return true;
+}
+
+std::string BakkesHost::GetReplayId() {
+    if (!gameWrapper->IsInReplay()) return {};
+    ReplayServerWrapper replay = gameWrapper->GetGameEventAsReplay();
+    if (!replay) return {};
+
+    ReplayWrapper data = replay.GetReplay();
+    return data.IsNull() ? std::string() : data.GetId().ToString();
+}
+
+bool BakkesHost::GetBallState(BallState& state) {
+    ServerWrapper server = GetServer();
+    if (!server) return false;
+
+    BallWrapper ball = server.GetBall();
+    if (!ball) return false;
+
+    Vector location = ball.GetLocation();
+    Vector velocity = ball.GetVelocity();
+    state.location = { location.X, location.Y, location.Z };
+    state.velocity = { velocity.X, velocity.Y, velocity.Z };
+    return true;
+}
+
+bool BakkesHost::SetUsingBehindView(bool enable) {
+    auto playerController = gameWrapper->GetPlayerController();
+    if (!playerController || playerController.IsNull()) return false;
+
+    playerController.SetUsingBehindView(enable);
+    return true;
+}
+
+bool BakkesHost::SetUsingSecondaryCamera(bool enable) {
+    auto playerController = gameWrapper->GetPlayerController();
+    if (!playerController || playerController.IsNull()) return false;
+
+    playerController.SetUsingSecondaryCamera(enable);
+    return true;
+}
+
+bool BakkesHost::GetCameraSwivel(CamRotator& swivel) {
+    auto camera = gameWrapper->GetCamera();
+    if (!camera || camera.IsNull()) return false;
+
+    Rotator current = camera.GetCurrentSwivel();
+    swivel = { current.Pitch, current.Yaw, current.Roll };
+    return true;
+}
+
+bool BakkesHost::SetCameraSwivel(const CamRotator& swivel) {
+    auto camera = gameWrapper->GetCamera();
+    if (!camera || camera.IsNull()) return false;
+
+    camera.SetCurrentSwivel(Rotator(swivel.Pitch, swivel.Yaw, swivel.Roll));
+    return true;
+}
+
+bool BakkesHost::GetCameraSettings(CamSettings& settings) {
+    auto camera = gameWrapper->GetCamera();
+    if (!camera || camera.IsNull()) return false;
+
+    ProfileCameraSettings current = camera.GetCameraSettings();
+    settings = { current.FOV, current.Distance, current.Height, current.Pitch };
+    return true;
+}
+
+bool BakkesHost::SetCameraSettings(const CamSettings& settings) {
+    auto camera = gameWrapper->GetCamera();
+    if (!camera || camera.IsNull()) return false;
+
+    // Stiffness and swivel/transition speeds stay as the player set them
+    ProfileCameraSettings current = camera.GetCameraSettings();
+    current.FOV = settings.fov;
+    current.Distance = settings.distance;
+    current.Height = settings.height;
+    current.Pitch = settings.angle;
+    camera.SetCameraSettings(current);
+    return true;
+}
+
+void BakkesHost::Log(const std::string& message) {
+    cvarManager->log(message);
+}
+
+std::filesystem::path BakkesHost::GetDataFolder() {
+    return gameWrapper->GetDataFolder();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <memory>
+
+#include "bakkesmod/wrappers/GameWrapper.h"
+#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
+#include "bakkesmod/wrappers/GameEvent/ServerWrapper.h"
+
+#include "Core/CamHost.h"
+
+// CamHost backed by the BakkesMod SDK; the only place the core engine
+// touches gameWrapper/cvarManager.
+class BakkesHost : public CamHost {
+public:
+    BakkesHost(std::shared_ptr<GameWrapper> gameWrapper, std::shared_ptr<CVarManagerWrapper> cvarManager);
+
+    void HookEvent(const std::string& eventName, std::function<void()> callback) override;
+    void HookEventWithCaller(const std::string& eventName, std::function<void(CarHandle caller)> callback) override;
+    void UnhookEvent(const std::string& eventName) override;
+    void SetTimeout(std::function<void()> callback, float delaySeconds) override;
+    void Execute(std::function<void()> callback) override;
+    double GetTime() override;
+    bool GetLocalCarState(CarState& state) override;
+    CarHandle GetFocusCar() override;
+    bool GetCarState(CarHandle car, CarState& state) override;
+    size_t GetCars(MatchCar* cars, size_t capacity) override;
+    bool GetReplayTime(double& time) override;
+    std::string GetReplayId() override;
+    bool GetBallState(BallState& state) override;
+    bool SetUsingBehindView(bool enable) override;
+    bool SetUsingSecondaryCamera(bool enable) override;
+    bool GetCameraSwivel(CamRotator& swivel) override;
+    bool SetCameraSwivel(const CamRotator& swivel) override;
+    bool GetCameraSettings(CamSettings& settings) override;
+    bool SetCameraSettings(const CamSettings& settings) override;
+    void Log(const std::string& message) override;
+    std::filesystem::path GetDataFolder() override;
+
+private:
+    // The game being played, or the replay being watched
+    ServerWrapper GetServer();
+
+    std::shared_ptr<GameWrapper> gameWrapper;
+    std::shared_ptr<CVarManagerWrapper> cvarManager;
+};
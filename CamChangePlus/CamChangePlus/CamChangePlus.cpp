@@ -7,10 +7,15 @@ BAKKESMOD_PLUGIN(CamChangePlus, "Camera control based on in-game events", plugin
 std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
 
 void CamChangePlus::onLoad() {
+    _globalCvarManager = cvarManager;
     cvarManager->log("[CamChangePlus] Plugin Loaded.");
 
+    host = std::make_unique<BakkesHost>(gameWrapper, cvarManager);
+    engine = std::make_unique<SequenceEngine>(*host);
+    engine->SetLatencyMonitor(&latencyMonitor);
+
     // Hook game events
-    HookGameEvents();
+    engine->HookGameEvents();
 
     // Register commands
     RegisterCommands();
@@ -32,174 +37,156 @@ void CamChangePlus::onLoad() {
 }
 
 void CamChangePlus::onUnload() {
-    cvarManager->log("[CamChangePlus] Plugin Unloaded.");
-}
-
-void CamChangePlus::HookGameEvents() {
-    cvarManager->log("[CamChangePlus] Hooking game events...");
-
-    gameWrapper->HookEvent("Function TAGame.Car_TA.OnHitBall", [this](...) { OnBallTouch(); });
-    gameWrapper->HookEvent("Function TAGame.GameEvent_Soccar_TA.EventGoalScored", [this](...) { OnExplosion(); });
-    gameWrapper->HookEvent("Function TAGame.Car_TA.OnJumpPressed", [this](...) { OnJump(); });
-    gameWrapper->HookEvent("Function CarComponent_DoubleJump_TA.Active.BeginState", [this](...) { OnDoubleJump(); });
-    gameWrapper->HookEvent("Function TAGame.CarComponent_Dodge_TA.EventActivateDodge", [this](...) { OnFlip(); });
-
-    cvarManager->log("[CamChangePlus] Game events hooked successfully.");
-}
-
-void CamChangePlus::OnBallTouch() {
-    auto now = std::chrono::steady_clock::now();
-    double timeSinceLastTouch = std::chrono::duration<double>(now - lastBallTouchTime).count();
-
-    if (timeSinceLastTouch >= ballTouchCooldown) {
-        lastBallTouchTime = now;
-        cvarManager->log("[CamChangePlus] Ball Touch Detected!");
-        ProcessEventActions("Ball Touch");
+    if (engine) {
+        engine->UnhookGameEvents();
+        engine->SetTraceRecorder(nullptr);
     }
+    traceRecorder.Close();
+    cvarManager->log("[CamChangePlus] Plugin Unloaded.");
 }
 
-void CamChangePlus::OnExplosion() {
-    cvarManager->log("[CamChangePlus] Goal Explosion Detected!");
-    ProcessEventActions("Explosion");
-}
-
-void CamChangePlus::OnJump() {
-    auto car = gameWrapper->GetLocalCar();
-    if (!car || car.IsNull()) return;
-
-    bool onGround = car.GetbOnGround();
-
-    // If onGround == 1, it means a jump happened
-    if (onGround) {
-        cvarManager->log("[CamChangePlus] Jump Detected!");
-        ProcessEventActions("Jump");
-    }
-}
-
-void CamChangePlus::OnDoubleJump() {
-    auto car = gameWrapper->GetLocalCar();
-    if (!car || car.IsNull()) return;
-
-    bool onGround = car.GetbOnGround();
-
-    // If onGround == 0, it means a double jump happened
-    if (!onGround) {
-        cvarManager->log("[CamChangePlus] Double Jump Detected!");
-        ProcessEventActions("Double Jump");
-    }
-}
-
-void CamChangePlus::OnFlip() {
-    if (hasFlipped) return;
-
-    cvarManager->log("[CamChangePlus] Flip/Dodge Detected!");
-    ProcessEventActions("Flip");
-}
-
-void CamChangePlus::ToggleReverseCam() {
-    gameWrapper->Execute([this](GameWrapper* gw) {
-        auto playerController = gw->GetPlayerController();
-        if (!playerController) return;
-
-        isUsingBehindView = !isUsingBehindView;
-        playerController.SetUsingBehindView(isUsingBehindView);
-        cvarManager->log("[CamChangePlus] Reverse Cam: " + std::string(isUsingBehindView ? "Enabled" : "Disabled"));
-        });
-}
-
-void CamChangePlus::ToggleBallCam(bool enable) {
-    gameWrapper->Execute([this, enable](GameWrapper* gw) {
-        auto playerController = gw->GetPlayerController();
-        if (!playerController) return;
-
-        playerController.SetUsingSecondaryCamera(enable);
-        cvarManager->log("[CamChangePlus] Ball Cam: " + std::string(enable ? "Enabled" : "Disabled"));
-        });
-}
-
-void CamChangePlus::AdjustCameraYaw(float yawPercentage) {
-    // Clamp the input between -100 and 100
-    yawPercentage = std::max(-100.0f, std::min(100.0f, yawPercentage));
-
-    // Convert percentage to actual yaw range (-23500 to 23500)
-    float mappedYaw = (yawPercentage / 100.0f) * 23500.0f;
-
-    // If 0, stop forcing yaw (restore default swivel behavior)
-    if (yawPercentage == 0.0f) {
-        gameWrapper->Execute([this](GameWrapper* gw) {
-            gameWrapper->UnhookEvent("Function TAGame.Camera_TA.ApplySwivel");
-            cvarManager->log("[CamChangePlus] Restored normal camera swivel (yaw = 0%).");
-            });
-        return;
-    }
+void CamChangePlus::RegisterCommands() {
+    // Command to manually adjust camera yaw
+    cvarManager->registerNotifier("camchange_yaw", [this](std::vector<std::string> args) {
+        if (args.size() < 2) {
+            cvarManager->log("[CamChangePlus] Error: Please specify a yaw value.");
+            return;
+        }
 
-    // Store the mapped yaw value
-    storedYaw = mappedYaw;
+        try {
+            float yawValue = std::stof(args[1]);  // Convert the input to a float
+            float duration = args.size() > 2 ? std::stof(args[2]) : 0.0f;
+            EaseCurve curve = args.size() > 3 ? FindEaseCurveByName(args[3]) : EaseCurve::Linear;
+            engine->Camera().AdjustCameraYaw(yawValue, duration, curve);  // Adjust the camera yaw
+            cvarManager->log("[CamChangePlus] Adjusting camera yaw by: " + std::to_string(yawValue));
+        }
+        catch (const std::exception& e) {
+            cvarManager->log("[CamChangePlus] Error: Invalid yaw value. Please enter a valid number.");
+        }
+        }, "Manually adjust camera yaw: camchange_yaw <percent> [seconds] [Linear|Cubic|Spring]", PERMISSION_ALL);
 
-    gameWrapper->Execute([this, yawPercentage](GameWrapper* gw) {
-        auto playerController = gw->GetPlayerController();
-        if (!playerController || playerController.IsNull()) {
-            cvarManager->log("[CamChangePlus] Error: PlayerController is null.");
+    // Command to key one camera rig channel
+    cvarManager->registerNotifier("camchange_rig", [this](std::vector<std::string> args) {
+        if (args.size() < 3) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_rig <yaw|pitch|fov|distance|height|angle|release> <value> [seconds] [hermite]");
+            if (args.size() == 2 && args[1] == "release") engine->Camera().ReleaseRig();
             return;
         }
 
-        // Unhook previous event to prevent stacking
-        gameWrapper->UnhookEvent("Function TAGame.Camera_TA.ApplySwivel");
+        static const char* channels[] = { "yaw", "pitch", "fov", "distance", "height", "angle" };
+        auto channel = RigChannel::Count;
+        for (size_t i = 0; i < RigChannelCount; ++i) {
+            if (args[1] == channels[i]) channel = static_cast<RigChannel>(i);
+        }
+        if (channel == RigChannel::Count) {
+            cvarManager->log("[CamChangePlus] Error: Unknown rig channel " + args[1]);
+            return;
+        }
 
-        // Hook into ApplySwivel (constant yaw enforcement)
-        gameWrapper->HookEvent("Function TAGame.Camera_TA.ApplySwivel", [this, yawPercentage](...) {
-            gameWrapper->Execute([this, yawPercentage](GameWrapper* gw) {
-                auto camera = gw->GetCamera();
-                if (!camera || camera.IsNull()) {
-                    cvarManager->log("[CamChangePlus] Error: Camera is null.");
-                    return;
-                }
+        try {
+            float value = std::stof(args[2]);
+            float duration = args.size() > 3 ? std::stof(args[3]) : 0.0f;
+            SplineMode mode = args.size() > 4 && args[4] == "hermite" ? SplineMode::Hermite : SplineMode::CatmullRom;
+            engine->Camera().KeyRig(channel, value, duration, mode);
+        }
+        catch (const std::exception& e) {
+            cvarManager->log("[CamChangePlus] Error: Invalid rig value. Please enter a valid number.");
+        }
+        }, "Key a camera rig channel: camchange_rig <channel> <value> [seconds] [hermite], or camchange_rig release", PERMISSION_ALL);
 
-                // Get the current swivel settings
-                auto swivel = camera.GetCurrentSwivel();
+    // Command to override yaw on the manual modifier layer
+    cvarManager->registerNotifier("camchange_override", [this](std::vector<std::string> args) {
+        if (args.size() < 2) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_override <yaw percent, 0 clears> [weight 0-1]");
+            return;
+        }
 
-                // Apply the mapped yaw
-                swivel.Yaw = storedYaw;
+        try {
+            float yawValue = std::stof(args[1]);
+            float weight = args.size() > 2 ? std::stof(args[2]) : 1.0f;
+            engine->Camera().SetManualYaw(yawValue, weight);
+        }
+        catch (const std::exception& e) {
+            cvarManager->log("[CamChangePlus] Error: Invalid override value. Please enter a valid number.");
+        }
+        }, "Manual yaw override over the sequence: camchange_override <percent> [weight]", PERMISSION_ALL);
 
-                // Set the new swivel
-                camera.SetCurrentSwivel(swivel);
+    // Command to shake the camera
+    cvarManager->registerNotifier("camchange_shake", [this](std::vector<std::string> args) {
+        if (args.size() < 2) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_shake <amplitude percent, 0 stops> [seconds] [hz]");
+            return;
+        }
 
-                // Log only when yaw changes
-                if (storedYaw != lastLoggedYaw) {
-                    cvarManager->log("[CamChangePlus] Applied Camera Yaw: " + std::to_string(swivel.Yaw) +
-                        " (Percentage: " + std::to_string(yawPercentage) + "%)");
-                    lastLoggedYaw = storedYaw;
-                }
-                });
-            });
-        });
+        try {
+            float amplitude = std::stof(args[1]);
+            if (amplitude == 0.0f) {
+                engine->Camera().StopShake();
+                return;
+            }
+            float duration = args.size() > 2 ? std::stof(args[2]) : 0.0f;
+            float frequency = args.size() > 3 ? std::stof(args[3]) : CameraController::defaultShakeFrequency;
+            engine->Camera().Shake(amplitude, duration, frequency);
+        }
+        catch (const std::exception& e) {
+            cvarManager->log("[CamChangePlus] Error: Invalid shake value. Please enter a valid number.");
+        }
+        }, "Shake the camera: camchange_shake <amplitude percent> [seconds] [hz]", PERMISSION_ALL);
 
-    // Log the change when the command is used
-    cvarManager->log("[CamChangePlus] Updated camera yaw to: " + std::to_string(yawPercentage) +
-        "% (Mapped value: " + std::to_string(storedYaw) + ")");
-}
+    // Command to change an event's debounce policy
+    cvarManager->registerNotifier("camchange_debounce", [this](std::vector<std::string> args) {
+        if (args.size() < 3) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_debounce <event, e.g. BallTouch> <seconds, 0 off> [leading|trailing] [coalesce]");
+            return;
+        }
 
-void CamChangePlus::RegisterCommands() {
-    // Command to manually adjust camera yaw
-    cvarManager->registerNotifier("camchange_yaw", [this](std::vector<std::string> args) {
-        if (args.size() < 2) {
-            cvarManager->log("[CamChangePlus] Error: Please specify a yaw value.");
+        // Event names without their spaces, so they fit in one argument
+        auto event = GameEvent::Invalid;
+        for (size_t i = 0; i < GameEventCount; ++i) {
+            std::string name = GetEventName(static_cast<GameEvent>(i));
+            name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+            if (name == args[1]) event = static_cast<GameEvent>(i);
+        }
+        if (event == GameEvent::Invalid) {
+            cvarManager->log("[CamChangePlus] Error: Unknown event " + args[1]);
             return;
         }
 
         try {
-            float yawValue = std::stof(args[1]);  // Convert the input to a float
-            AdjustCameraYaw(yawValue);  // Adjust the camera yaw
-            cvarManager->log("[CamChangePlus] Adjusting camera yaw by: " + std::to_string(yawValue));
+            EventPolicy policy;
+            policy.cooldown = std::stof(args[2]);
+            policy.edge = args.size() > 3 && args[3] == "trailing" ? DebounceEdge::Trailing : DebounceEdge::Leading;
+            policy.coalesce = args.size() > 4 && args[4] == "coalesce";
+            engine->GetEventFilter().SetPolicy(event, policy);
         }
         catch (const std::exception& e) {
-            cvarManager->log("[CamChangePlus] Error: Invalid yaw value. Please enter a valid number.");
+            cvarManager->log("[CamChangePlus] Error: Invalid cooldown. Please enter a valid number.");
+        }
+        }, "Debounce an event: camchange_debounce <event> <seconds> [leading|trailing] [coalesce]", PERMISSION_ALL);
+
+    // Command to scan the replay being watched into an event index
+    cvarManager->registerNotifier("camchange_scanreplay", [this](std::vector<std::string> args) {
+        if (args.size() < 2 || (args[1] != "start" && args[1] != "stop")) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_scanreplay start|stop");
+            return;
+        }
+        if (args[1] == "start") engine->StartReplayScan();
+        else engine->StopReplayScan();
+        }, "Index a replay's events for hook-free playback: camchange_scanreplay start|stop", PERMISSION_ALL);
+
+    // Command to choose what playback does when the shot finishes
+    cvarManager->registerNotifier("camchange_playback", [this](std::vector<std::string> args) {
+        if (args.size() < 2 || (args[1] != "once" && args[1] != "loop" && args[1] != "rearm")) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_playback once|loop|rearm");
+            return;
         }
-        }, "Manually adjust camera yaw", PERMISSION_ALL);
+        engine->SetPlaybackMode(FindPlaybackModeByName(args[1]));
+        cvarManager->log("[CamChangePlus] Playback mode: " + args[1]);
+        }, "Play the shot once, loop it keeping the camera, or re-arm it from the default camera: camchange_playback once|loop|rearm", PERMISSION_ALL);
 
     // Command to toggle reverse camera view
     cvarManager->registerNotifier("camchange_reversecam", [this](std::vector<std::string> args) {
-        ToggleReverseCam();  // Toggle the reverse camera
+        engine->Camera().ToggleReverseCam();  // Toggle the reverse camera
         cvarManager->log("[CamChangePlus] Reverse camera toggled.");
         }, "Toggle reverse camera", PERMISSION_ALL);
 
@@ -212,133 +199,70 @@ void CamChangePlus::RegisterCommands() {
 
         try {
             bool enable = std::stoi(args[1]) != 0;  // Convert input to a boolean
-            ToggleBallCam(enable);  // Toggle the ball camera
+            engine->Camera().ToggleBallCam(enable);  // Toggle the ball camera
             cvarManager->log("[CamChangePlus] Ball camera " + std::string(enable ? "enabled" : "disabled"));
         }
         catch (const std::exception& e) {
             cvarManager->log("[CamChangePlus] Error: Invalid input for ball camera. Please use 1 (enable) or 0 (disable).");
         }
         }, "Toggle ball camera", PERMISSION_ALL);
-}
-
-void CamChangePlus::ProcessEventActions(const std::string& event) {
-    if (!tasRunning || currentTasIndex >= eventActions.size()) {
-        return;
-    }
 
-    const auto& currentAction = eventActions[currentTasIndex];
-
-    // Ensure that only the correct action in order gets executed
-    if (currentAction.eventName == event) {
-        ScheduleAction(currentAction.actionName, currentAction.delay, currentAction.customValue);
-        currentTasIndex++;  // Move to the next action in sequence
-
-        // If TAS has finished executing all actions, reset
-        if (currentTasIndex >= eventActions.size()) {
-            ResetToDefault();
+    // Command to record events and fired actions into a ring file
+    cvarManager->registerNotifier("camchange_record", [this](std::vector<std::string> args) {
+        if (args.size() < 2 || (args[1] != "start" && args[1] != "stop")) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_record start|stop");
+            return;
         }
-    }
-}
-
-void CamChangePlus::ExecuteAction(const std::string& action, float value = 50.0f) {
-    static bool yawDirectionRight = true; // true = right, false = left
-
-    if (action == "Enable Reverse Cam") {
-        if (!isUsingBehindView) ToggleReverseCam();
-    }
-    else if (action == "Disable Reverse Cam") {
-        if (isUsingBehindView) ToggleReverseCam();
-    }
-    else if (action == "Toggle Reverse Cam") {
-        ToggleReverseCam();
-    }
-    else if (action == "Toggle Swivel Direction") {
-        yawDirectionRight = !yawDirectionRight;
-        cvarManager->log("[CamChangePlus] Yaw direction set to " + std::string(yawDirectionRight ? "Right" : "Left"));
-    }
-    else if (action == "Adjust Camera Yaw") {
-        float yawValue = yawDirectionRight ? value : -value; // Use toggled direction
-        AdjustCameraYaw(yawValue);
-    }
-
-    cvarManager->log("[CamChangePlus] Executed Action: " + action + " with value: " + std::to_string(value));
-}
-
-void CamChangePlus::ScheduleAction(const std::string& action, float delay, float value) {
-    gameWrapper->SetTimeout([this, action, value](GameWrapper* gw) {
-        ExecuteAction(action, value);
-        }, delay);
-}
-
-void CamChangePlus::ResetToDefault() {
-    cvarManager->log("[CamChangePlus] Resetting to default settings...");
 
-    // Turn off Reverse Cam if it was enabled
-    if (isUsingBehindView) {
-        ToggleReverseCam();
-    }
-
-    // Reset Camera Yaw to 0
-    AdjustCameraYaw(0.0f);
-
-    // Stop TAS execution
-    tasRunning = false;
-    currentTasIndex = 0;
-
-    cvarManager->log("[CamChangePlus] TAS reset complete.");
-}
-
-void CamChangePlus::StartSequencePlayback() {
-    if (eventActions.empty()) {
-        cvarManager->log("[CamChangePlus] No actions mapped!");
-        return;
-    }
+        if (args[1] == "stop") {
+            engine->SetTraceRecorder(nullptr);
+            cvarManager->log("[CamChangePlus] Trace stopped: " + std::to_string(traceRecorder.GetWriteCount()) + " records in " + traceRecorder.GetPath().string());
+            traceRecorder.Close();
+            return;
+        }
 
-    tasRunning = true;
-    currentTasIndex = 0;
-    cvarManager->log("[CamChangePlus] TAS Started!");
+        std::filesystem::path tracePath = gameWrapper->GetDataFolder() / "CamChangePlus_trace.bin";
+        if (!traceRecorder.Open(tracePath, traceCapacity)) {
+            cvarManager->log("[CamChangePlus] Error: Could not open trace file " + tracePath.string());
+            return;
+        }
+        engine->SetTraceRecorder(&traceRecorder);
+        cvarManager->log("[CamChangePlus] Recording trace to " + tracePath.string());
+        }, "Record a binary event trace: camchange_record start|stop", PERMISSION_ALL);
+
+#ifdef CAMCHANGE_ENABLE_TRACING
+    // Command to capture trace zones and dump them as Chrome trace JSON
+    cvarManager->registerNotifier("camchange_trace", [this](std::vector<std::string> args) {
+        if (args.size() < 2 || (args[1] != "start" && args[1] != "stop")) {
+            cvarManager->log("[CamChangePlus] Usage: camchange_trace start|stop");
+            return;
+        }
 
-    // Start monitoring for TAS completion
-    gameWrapper->SetTimeout([this](GameWrapper* gw) {
-        if (tasRunning && currentTasIndex >= eventActions.size()) {
-            ResetToDefault();
+        if (args[1] == "start") {
+            TraceProfiler::Start();
+            cvarManager->log("[CamChangePlus] Trace zones recording.");
+            return;
         }
-        }, 1.0f); // Check for completion every second
-}
 
-void CamChangePlus::StopSequencePlayback() {
-    cvarManager->log("[CamChangePlus] TAS Stopped by user.");
-    ResetToDefault();
+        TraceProfiler::Stop();
+        std::filesystem::path tracePath = gameWrapper->GetDataFolder() / "CamChangePlus_trace.json";
+        if (TraceProfiler::WriteChromeTrace(tracePath)) {
+            cvarManager->log("[CamChangePlus] Wrote " + std::to_string(TraceProfiler::GetZoneCount()) + " zones to " + tracePath.string());
+        }
+        else {
+            cvarManager->log("[CamChangePlus] Error: Could not write " + tracePath.string());
+        }
+        }, "Record trace zones and export Chrome trace JSON: camchange_trace start|stop", PERMISSION_ALL);
+#endif
 }
 
 void CamChangePlus::SaveMappingsToFile() {
-    json j;
-    std::string filepath = gameWrapper->GetDataFolder().string() + "/CamChangePlus_shots.json";
-
-    // Load existing file if it exists
-    std::ifstream fileRead(filepath);
-    if (fileRead.is_open()) {
-        fileRead >> j;
-        fileRead.close();
-    }
-
-    // Store current sequence
-    j["shots"][currentSequenceName] = json::array();
-    for (const auto& action : eventActions) {
-        j["shots"][currentSequenceName].push_back({
-            {"eventName", action.eventName},
-            {"actionName", action.actionName},
-            {"delay", action.delay},
-            {"customValue", action.customValue}
-            });
-    }
+    CCP_TRACE_SCOPE("SaveMappingsToFile");
+    ShotLibrary library(ShotLibrary::DefaultPath(gameWrapper->GetDataFolder()));
+    const std::string& sequenceName = engine->GetSequenceName();
 
-    // Save back to file
-    std::ofstream fileWrite(filepath);
-    if (fileWrite.is_open()) {
-        fileWrite << j.dump(4);
-        fileWrite.close();
-        cvarManager->log("[CamChangePlus] Saved sequence: " + currentSequenceName);
+    if (library.Save(sequenceName, engine->GetActions())) {
+        cvarManager->log("[CamChangePlus] Saved sequence: " + sequenceName);
     }
     else {
         cvarManager->log("[CamChangePlus] Error: Could not save file.");
@@ -346,29 +270,16 @@ void CamChangePlus::SaveMappingsToFile() {
 }
 
 void CamChangePlus::LoadMappingsFromFile(const std::string& sequenceName) {
-    json j;
-    std::string filepath = gameWrapper->GetDataFolder().string() + "/CamChangePlus_shots.json";
-
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    CCP_TRACE_SCOPE("LoadMappingsFromFile");
+    ShotLibrary library(ShotLibrary::DefaultPath(gameWrapper->GetDataFolder()));
+    if (!library.Exists()) {
         cvarManager->log("[CamChangePlus] Error: No saved shots found.");
         return;
     }
 
-    file >> j;
-    file.close();
-
-    if (j.contains("shots") && j["shots"].contains(sequenceName)) {
-        eventActions.clear();
-        for (const auto& mapping : j["shots"][sequenceName]) {
-            eventActions.push_back({
-                mapping["eventName"],
-                mapping["actionName"],
-                mapping["delay"],
-                mapping["customValue"]
-                });
-        }
-        currentSequenceName = sequenceName;
+    std::vector<ActionMapping> actions;
+    if (library.Load(sequenceName, actions)) {
+        engine->SetSequence(sequenceName, std::move(actions));
         cvarManager->log("[CamChangePlus] Loaded sequence: " + sequenceName);
     }
     else {
@@ -407,7 +318,123 @@ void CamChangePlus::RenderSettings() {
 }
 
 
+void CamChangePlus::RenderPerformanceTab() {
+    constexpr int historySize = 120;
+    static float p50History[historySize] = {};
+    static float p99History[historySize] = {};
+    static int historyOffset = 0;
+    static double lastSampleTime = 0.0;
+
+    const LatencyHistogram& endToEnd = latencyMonitor.Get(LatencyStage::HookToApplied);
+
+    // Sample the end-to-end percentiles four times a second for the trend plot
+    double now = ImGui::GetTime();
+    if (now - lastSampleTime >= 0.25) {
+        lastSampleTime = now;
+        p50History[historyOffset] = endToEnd.GetPercentile(50.0) / 1000.0f;
+        p99History[historyOffset] = endToEnd.GetPercentile(99.0) / 1000.0f;
+        historyOffset = (historyOffset + 1) % historySize;
+    }
+
+    ImGui::Text("Hook to camera latency (ms, intended delays excluded)");
+    ImGui::Separator();
+
+    ImGui::Columns(5, "LatencyColumns");
+    ImGui::Text("Stage"); ImGui::NextColumn();
+    ImGui::Text("Count"); ImGui::NextColumn();
+    ImGui::Text("p50"); ImGui::NextColumn();
+    ImGui::Text("p99"); ImGui::NextColumn();
+    ImGui::Text("Max"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (size_t i = 0; i < LatencyStageCount; ++i) {
+        const LatencyHistogram& histogram = latencyMonitor.Get(static_cast<LatencyStage>(i));
+        ImGui::Text("%s", GetLatencyStageName(static_cast<LatencyStage>(i))); ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(histogram.GetCount())); ImGui::NextColumn();
+        ImGui::Text("%.2f", histogram.GetPercentile(50.0) / 1000.0); ImGui::NextColumn();
+        ImGui::Text("%.2f", histogram.GetPercentile(99.0) / 1000.0); ImGui::NextColumn();
+        ImGui::Text("%.2f", histogram.GetMax() / 1000.0); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::Separator();
+
+    // Per-tick snapshot + event detector pass against its fixed budget
+    const LatencyHistogram& tickScan = engine->GetTickScanCost();
+    ImGui::Text("Tick scan (us): p50 %llu  p99 %llu  max %llu  |  budget %llu, %llu of %llu ticks over",
+        static_cast<unsigned long long>(tickScan.GetPercentile(50.0)),
+        static_cast<unsigned long long>(tickScan.GetPercentile(99.0)),
+        static_cast<unsigned long long>(tickScan.GetMax()),
+        static_cast<unsigned long long>(SequenceEngine::tickScanBudgetUs),
+        static_cast<unsigned long long>(engine->GetTickScanOverBudget()),
+        static_cast<unsigned long long>(tickScan.GetCount()));
+    ImGui::Text("Game hooks installed: %zu  |  other cars' hook calls dropped: %llu", engine->GetHooks().GetInstalledCount(),
+        static_cast<unsigned long long>(engine->GetOtherCarEvents()));
+    ImGui::Text("Sequence tasks: %zu  |  coroutine frames: %llu started, %llu from the pool", engine->GetRuntime().GetTaskCount(),
+        static_cast<unsigned long long>(FramePool::GetAllocations()), static_cast<unsigned long long>(FramePool::GetReused()));
+
+    // Debounce counters for events that have suppressed anything
+    std::string suppressed;
+    for (size_t i = 0; i < GameEventCount; ++i) {
+        const EventFilterStats& stats = engine->GetEventFilter().GetStats(static_cast<GameEvent>(i));
+        if (stats.suppressed == 0) continue;
+        if (!suppressed.empty()) suppressed += ", ";
+        suppressed += std::string(GetEventName(static_cast<GameEvent>(i))) + " " + std::to_string(stats.suppressed);
+    }
+    ImGui::Text("Debounced: %s", suppressed.empty() ? "none" : suppressed.c_str());
+
+    if (engine->IsScanningReplay()) {
+        ImGui::Text("Scanning replay: %zu events up to %.1fs", engine->GetReplayIndex().GetEntries().size(),
+            engine->GetReplayIndex().GetDuration());
+    }
+    else if (engine->IsPlayingFromIndex()) {
+        ImGui::Text("Playing from the replay index: %zu cues", engine->GetCueSheet().GetCues().size());
+    }
+
+    const ReplayTimeline& timeline = engine->GetReplayTimeline();
+    if (timeline.GetCheckpointCount() > 0) {
+        ImGui::Text("Replay checkpoints: %zu  |  journaled events: %zu  |  watched up to %.1fs",
+            timeline.GetCheckpointCount(), timeline.GetEventCount(), timeline.GetFrontier());
+    }
+    ImGui::Separator();
+
+    // Distribution of the end-to-end stage over its occupied buckets
+    size_t firstBucket = LatencyHistogram::bucketCount;
+    size_t lastBucket = 0;
+    for (size_t i = 0; i < LatencyHistogram::bucketCount; ++i) {
+        if (endToEnd.GetBucket(i) == 0) continue;
+        firstBucket = std::min(firstBucket, i);
+        lastBucket = i;
+    }
+    if (firstBucket <= lastBucket) {
+        static std::vector<float> bucketValues;
+        bucketValues.clear();
+        for (size_t i = firstBucket; i <= lastBucket; ++i) {
+            bucketValues.push_back(static_cast<float>(endToEnd.GetBucket(i)));
+        }
+        std::string range = std::to_string(LatencyHistogram::BucketLowerBound(firstBucket) / 1000.0f) + " - " +
+            std::to_string(LatencyHistogram::BucketUpperBound(lastBucket) / 1000.0f) + " ms";
+        ImGui::PlotHistogram2("Hook -> Applied", bucketValues.data(), static_cast<int>(bucketValues.size()), 0,
+            range.c_str(), 0.0f, FLT_MAX, ImVec2(0, 120));
+    }
+    else {
+        ImGui::Text("No camera changes measured yet.");
+    }
+
+    const char* names[] = { "p50", "p99" };
+    const ImColor colors[] = { ImColor(90, 200, 90), ImColor(230, 120, 60) };
+    const void* datas[] = { p50History, p99History };
+    ImGui::PlotMultiLines("Trend (ms)", 2, names, colors,
+        [](const void* data, int idx) { return static_cast<const float*>(data)[(idx + historyOffset) % historySize]; },
+        datas, historySize, 0.0f, FLT_MAX, ImVec2(0, 120));
+
+    if (ImGui::Button("Reset", ImVec2(100, 25))) {
+        latencyMonitor.Reset();
+        engine->ResetTickScanCost();
+        engine->GetEventFilter().ResetStats();
+    }
+}
+
 void CamChangePlus::RenderWindow() {
+    CCP_TRACE_SCOPE("RenderWindow");
     if (!isWindowOpen_) return;
 
     ImGui::SetNextWindowSize(ImVec2(850, 550), ImGuiCond_FirstUseEver);
@@ -425,150 +452,241 @@ void CamChangePlus::RenderWindow() {
     static bool tasRunning = false;
 
     if (ImGui::Begin("CamChangePlus - Shot Sequence Builder", &isWindowOpen_, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoResize)) {
-        static float leftPanelWidth = 220.0f;
-        static int selectedMapping = -1;
-
-        // Sidebar for managing sequences
-        ImGui::BeginChild("LeftPanel", ImVec2(leftPanelWidth, 0), true);
-        ImGui::Text("Sequences");
-        ImGui::Separator();
-
-        static char sequenceName[256] = "";
-        ImGui::InputText("##SequenceName", sequenceName, IM_ARRAYSIZE(sequenceName));
-        ImGui::SameLine();
-        if (ImGui::Button("Add", ImVec2(50, 25))) {
-            if (strlen(sequenceName) > 0) {
-                bool nameExists = false;
-                for (const auto& seq : eventMappings) {
-                    if (seq.first == sequenceName) {
-                        nameExists = true;
-                        break;
-                    }
-                }
-                if (nameExists) {
-                    showDuplicateNamePopup = true;
-                }
-                else {
-                    eventMappings.emplace_back(sequenceName, std::vector<std::pair<std::string, std::string>>());
-                }
-            }
-            else {
-                showErrorPopup = true;
+        static bool showPerformanceTab = false;
+        if (ImGui::BeginTabBar("##CamChangePlusTabs")) {
+            if (ImGui::BeginTabItem("Shot Sequences")) {
+                showPerformanceTab = false;
+                ImGui::EndTabItem();
             }
-        }
-
-        ImGui::Separator();
-
-        // List of existing sequences
-        for (size_t i = 0; i < eventMappings.size(); ++i) {
-            if (ImGui::Selectable(eventMappings[i].first.c_str(), selectedMapping == i)) {
-                selectedMapping = i;
+            if (ImGui::BeginTabItem("Performance")) {
+                showPerformanceTab = true;
+                ImGui::EndTabItem();
             }
+            ImGui::EndTabBar();
         }
 
-        if (selectedMapping >= 0 && eventMappings.size() > 1) {
-            if (ImGui::Button("Delete Sequence", ImVec2(ImGui::GetContentRegionAvail().x, 25))) {
-                eventMappings.erase(eventMappings.begin() + selectedMapping);
-                selectedMapping = -1;
-            }
-        }
-        else if (selectedMapping >= 0 && eventMappings.size() == 1) {
-            if (ImGui::Button("Delete Sequence", ImVec2(ImGui::GetContentRegionAvail().x, 25))) {
-                showDeleteLastSequencePopup = true;
-            }
+        if (showPerformanceTab) {
+            RenderPerformanceTab();
         }
+        else {
+            static float leftPanelWidth = 220.0f;
+            static int selectedMapping = -1;
 
-        ImGui::EndChild();
-        ImGui::SameLine();
+            // Sidebar for managing sequences
+            ImGui::BeginChild("LeftPanel", ImVec2(leftPanelWidth, 0), true);
+            ImGui::Text("Sequences");
+            ImGui::Separator();
 
-        // Main panel for editing sequences
-        ImGui::BeginChild("RightPanel", ImVec2(0, 0), true);
+            static char sequenceName[256] = "";
+            ImGui::InputText("##SequenceName", sequenceName, IM_ARRAYSIZE(sequenceName));
+            ImGui::SameLine();
+            if (ImGui::Button("Add", ImVec2(50, 25))) {
+                if (strlen(sequenceName) > 0) {
+                    bool nameExists = false;
+                    for (const auto& seq : eventMappings) {
+                        if (seq.first == sequenceName) {
+                            nameExists = true;
+                            break;
+                        }
+                    }
+                    if (nameExists) {
+                        showDuplicateNamePopup = true;
+                    }
+                    else {
+                        eventMappings.emplace_back(sequenceName, std::vector<std::pair<std::string, std::string>>());
+                    }
+                }
+                else {
+                    showErrorPopup = true;
+                }
+            }
 
-        if (selectedMapping >= 0 && selectedMapping < eventMappings.size()) {
-            ImGui::Text("Editing Sequence: %s", eventMappings[selectedMapping].first.c_str());
             ImGui::Separator();
 
-            static const char* availableEvents[] = { "Ball Touch", "Jump", "Double Jump", "Flip", "Explosion" };
-            static const char* availableActions[] = { "Toggle Reverse Cam", "Set Yaw", "Enable Ball Cam" };
-
-            static int selectedEvent = 0;
-            static int selectedAction = 0;
-            static float customYaw = 0.0f;
-            static float delay = 0.0f;
+            // List of existing sequences
+            for (size_t i = 0; i < eventMappings.size(); ++i) {
+                if (ImGui::Selectable(eventMappings[i].first.c_str(), selectedMapping == i)) {
+                    selectedMapping = i;
+                }
+            }
 
-            ImGui::Text("Add New Mapping");
-            ImGui::Combo("##Event", &selectedEvent, availableEvents, IM_ARRAYSIZE(availableEvents));
-            ImGui::SameLine();
-            ImGui::Text("Event");
+            if (selectedMapping >= 0 && eventMappings.size() > 1) {
+                if (ImGui::Button("Delete Sequence", ImVec2(ImGui::GetContentRegionAvail().x, 25))) {
+                    eventMappings.erase(eventMappings.begin() + selectedMapping);
+                    selectedMapping = -1;
+                }
+            }
+            else if (selectedMapping >= 0 && eventMappings.size() == 1) {
+                if (ImGui::Button("Delete Sequence", ImVec2(ImGui::GetContentRegionAvail().x, 25))) {
+                    showDeleteLastSequencePopup = true;
+                }
+            }
 
-            ImGui::Combo("##Action", &selectedAction, availableActions, IM_ARRAYSIZE(availableActions));
+            ImGui::EndChild();
             ImGui::SameLine();
-            ImGui::Text("Action");
 
-            if (selectedAction == 1) {  // Set Yaw
-                ImGui::SliderFloat("Yaw %", &customYaw, -100.0f, 100.0f, "%.1f%%");
-            }
+            // Main panel for editing sequences
+            ImGui::BeginChild("RightPanel", ImVec2(0, 0), true);
+
+            if (selectedMapping >= 0 && selectedMapping < eventMappings.size()) {
+                ImGui::Text("Editing Sequence: %s", eventMappings[selectedMapping].first.c_str());
+                ImGui::Separator();
+
+                static const char* availableEvents[] = { "Ball Touch", "Jump", "Double Jump", "Flip", "Explosion",
+                    "Predicted Wall Hit", "Predicted Goal Line", "Predicted Floor Bounce",
+                    "Landing", "Wall Contact", "Aerial Start", "Boost Empty", "Boost Full", "Supersonic",
+                    "Ball Fast", "Ball High", "Demolition", "Kickoff Start" };
+                static const char* availableActions[] = { "Toggle Reverse Cam", "Set Yaw", "Enable Ball Cam",
+                    "Rig Yaw", "Rig Pitch", "Rig FOV", "Rig Distance", "Rig Height", "Rig Angle", "Camera Shake" };
+                constexpr int firstRigAction = 3;
+                constexpr int shakeAction = 9;
+
+                static int selectedEvent = 0;
+                static int selectedAction = 0;
+                static float customYaw = 0.0f;
+                static float rigValue = 0.0f;
+                static bool rigHermite = false;
+                static float delay = 0.0f;
+                static float transition = 0.0f;
+                static int selectedCurve = 0;
+                static int selectedBinding = 0;
+                static char condition[128] = "";
+                static char after[64] = "";
+                static bool joinAny = false;
+                static float timeout = 0.0f;
+                static int race = 0;
+
+                ImGui::Text("Add New Mapping");
+                ImGui::Combo("##Event", &selectedEvent, availableEvents, IM_ARRAYSIZE(availableEvents));
+                ImGui::SameLine();
+                ImGui::Text("Event");
 
-            ImGui::InputFloat("Delay (s)", &delay, 0.1f, 1.0f, "%.2f");
+                if (IsCarEvent(FindEventByName(availableEvents[selectedEvent]))) {
+                    ImGui::Combo("##Car", &selectedBinding, [](void*, int i, const char** out) {
+                        *out = GetCarBindingName(static_cast<CarBinding>(i));
+                        return true;
+                        }, nullptr, static_cast<int>(CarBindingCount));
+                    ImGui::SameLine();
+                    ImGui::Text("Car");
+                }
 
-            if (ImGui::Button("Add Mapping", ImVec2(150, 25))) {
-                std::string actionDetail = availableActions[selectedAction];
-                if (selectedAction == 1) {
-                    actionDetail += " (" + std::to_string(customYaw) + "%)";
+                ImGui::Combo("##Action", &selectedAction, availableActions, IM_ARRAYSIZE(availableActions));
+                ImGui::SameLine();
+                ImGui::Text("Action");
+
+                if (selectedAction == 1) {  // Set Yaw
+                    ImGui::SliderFloat("Yaw %", &customYaw, -100.0f, 100.0f, "%.1f%%");
+                    ImGui::InputFloat("Transition (s)", &transition, 0.1f, 0.5f, "%.2f");
+                    ImGui::Combo("Curve", &selectedCurve, [](void*, int i, const char** out) {
+                        *out = GetEaseCurveName(static_cast<EaseCurve>(i));
+                        return true;
+                        }, nullptr, static_cast<int>(EaseCurveCount));
+                }
+                else if (selectedAction >= firstRigAction) {
+                    ImGui::InputFloat("Value", &rigValue, 1.0f, 10.0f, "%.1f");
+                    ImGui::InputFloat("Transition (s)", &transition, 0.1f, 0.5f, "%.2f");
+                    if (selectedAction != shakeAction) ImGui::Checkbox("Settle on key (Hermite)", &rigHermite);
                 }
 
-                // Ensure the selected sequence exists
-                if (selectedMapping >= 0 && selectedMapping < eventMappings.size()) {
-                    eventMappings[selectedMapping].second.push_back(
-                        std::make_pair(
-                            std::string(availableEvents[selectedEvent]),
-                            "→ " + actionDetail + " (Delay: " + std::to_string(delay) + "s)"
-                        )
-                    );
+                ImGui::InputFloat("Delay (s)", &delay, 0.1f, 1.0f, "%.2f");
+
+                // Optional predicate over the car and ball, e.g. car.speed > 1800 && ball.z > 600
+                ImGui::InputText("Condition", condition, IM_ARRAYSIZE(condition));
+                Predicate conditionCheck;
+                if (!conditionCheck.Compile(condition)) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", conditionCheck.GetError().c_str());
                 }
-            }
 
-            ImGui::Separator();
-            ImGui::Text("Current Mappings:");
+                // Branching: step numbers to wait for (0 = the start), empty follows the previous step
+                ImGui::InputText("After steps", after, IM_ARRAYSIZE(after));
+                ImGui::Checkbox("Any of them", &joinAny);
+                ImGui::InputFloat("Timeout (s)", &timeout, 0.5f, 1.0f, "%.2f");
+                ImGui::InputInt("Race group", &race);
+
+                if (ImGui::Button("Add Mapping", ImVec2(150, 25))) {
+                    std::string actionDetail = availableActions[selectedAction];
+                    if (selectedAction == 1) {
+                        actionDetail += " (" + std::to_string(customYaw) + "%";
+                        if (transition > 0.0f) {
+                            actionDetail += ", " + std::to_string(transition) + "s " + GetEaseCurveName(static_cast<EaseCurve>(selectedCurve));
+                        }
+                        actionDetail += ")";
+                    }
+                    else if (selectedAction >= firstRigAction) {
+                        actionDetail += " (" + std::to_string(rigValue) + " over " + std::to_string(transition) + "s" +
+                            (rigHermite && selectedAction != shakeAction ? ", Hermite" : "") + ")";
+                    }
 
-            ImGui::BeginChild("MappingsList", ImVec2(0, 150), true);
-            for (size_t i = 0; i < eventMappings[selectedMapping].second.size(); ++i) {
-                ImGui::Text("%s %s",
-                    eventMappings[selectedMapping].second[i].first.c_str(),
-                    eventMappings[selectedMapping].second[i].second.c_str());
+                    std::string eventDetail = availableEvents[selectedEvent];
+                    if (selectedBinding != 0 && IsCarEvent(FindEventByName(eventDetail))) {
+                        eventDetail += std::string(" [") + GetCarBindingName(static_cast<CarBinding>(selectedBinding)) + "]";
+                    }
+                    if (!conditionCheck.IsEmpty()) {
+                        eventDetail += std::string(" if ") + condition;
+                    }
+                    if (after[0] != '\0') {
+                        eventDetail += std::string(joinAny ? " after any of " : " after ") + after;
+                    }
+                    if (timeout > 0.0f) {
+                        eventDetail += " within " + std::to_string(timeout) + "s";
+                    }
+                    if (race > 0) {
+                        eventDetail += " (race " + std::to_string(race) + ")";
+                    }
 
-                ImGui::SameLine();
-                if (ImGui::Button(("Delete##" + std::to_string(i)).c_str(), ImVec2(50, 20))) {
-                    eventMappings[selectedMapping].second.erase(eventMappings[selectedMapping].second.begin() + i);
-                    break;
+                    // Ensure the selected sequence exists
+                    if (selectedMapping >= 0 && selectedMapping < eventMappings.size()) {
+                        eventMappings[selectedMapping].second.push_back(
+                            std::make_pair(
+                                eventDetail,
+                                "→ " + actionDetail + " (Delay: " + std::to_string(delay) + "s)"
+                            )
+                        );
+                    }
                 }
 
-                // Move Up Button
-                if (i > 0) {
+                ImGui::Separator();
+                ImGui::Text("Current Mappings:");
+
+                ImGui::BeginChild("MappingsList", ImVec2(0, 150), true);
+                for (size_t i = 0; i < eventMappings[selectedMapping].second.size(); ++i) {
+                    ImGui::Text("%s %s",
+                        eventMappings[selectedMapping].second[i].first.c_str(),
+                        eventMappings[selectedMapping].second[i].second.c_str());
+
                     ImGui::SameLine();
-                    if (ImGui::Button(("▲##MoveUp" + std::to_string(i)).c_str(), ImVec2(20, 20))) {
-                        std::swap(eventMappings[selectedMapping].second[i], eventMappings[selectedMapping].second[i - 1]);
+                    if (ImGui::Button(("Delete##" + std::to_string(i)).c_str(), ImVec2(50, 20))) {
+                        eventMappings[selectedMapping].second.erase(eventMappings[selectedMapping].second.begin() + i);
+                        break;
                     }
-                }
-                // Move Down Button
-                if (i < eventMappings[selectedMapping].second.size() - 1) {
-                    ImGui::SameLine();
-                    if (ImGui::Button(("▼##MoveDown" + std::to_string(i)).c_str(), ImVec2(20, 20))) {
-                        std::swap(eventMappings[selectedMapping].second[i], eventMappings[selectedMapping].second[i + 1]);
+
+                    // Move Up Button
+                    if (i > 0) {
+                        ImGui::SameLine();
+                        if (ImGui::Button(("▲##MoveUp" + std::to_string(i)).c_str(), ImVec2(20, 20))) {
+                            std::swap(eventMappings[selectedMapping].second[i], eventMappings[selectedMapping].second[i - 1]);
+                        }
+                    }
+                    // Move Down Button
+                    if (i < eventMappings[selectedMapping].second.size() - 1) {
+                        ImGui::SameLine();
+                        if (ImGui::Button(("▼##MoveDown" + std::to_string(i)).c_str(), ImVec2(20, 20))) {
+                            std::swap(eventMappings[selectedMapping].second[i], eventMappings[selectedMapping].second[i + 1]);
+                        }
                     }
                 }
+                ImGui::EndChild();
+
+                if (ImGui::Button("Save")) SaveMappingsToFile();
+                ImGui::SameLine();
+                if (ImGui::Button("Load")) LoadMappingsFromFile(sequenceName);
+            }
+            else {
+                ImGui::Text("Select or create a sequence to edit.");
             }
-            ImGui::EndChild();
 
-            if (ImGui::Button("Save")) SaveMappingsToFile();
-            ImGui::SameLine();
-            if (ImGui::Button("Load")) LoadMappingsFromFile(sequenceName);
-        }
-        else {
-            ImGui::Text("Select or create a sequence to edit.");
+            ImGui::EndChild();
         }
-
-        ImGui::EndChild();
         ImGui::End();
     }
 
@@ -18,6 +18,7 @@ using json = nlohmann::json;
 #include "GuiBase.h"  // ✅ Ensure this is included
 #include "imgui/imgui.h" // Core ImGui functions
 #include "imgui/imgui_internal.h" // Internal ImGui features, if needed
+#include "imgui/imguivariouscontrols.h" // PlotHistogram2 / PlotMultiLines
 // Include necessary headers for game interactions
 #include "bakkesmod/wrappers/GameWrapper.h"
 #include "bakkesmod/wrappers/WrapperStructs.h"
@@ -29,22 +30,20 @@ using json = nlohmann::json;
 #include "bakkesmod/wrappers/GameObject/CarComponent/DoubleJumpComponentWrapper.h"
 #include "bakkesmod/wrappers/GameObject/CarComponent/DodgeComponentWrapper.h"
 
+// Portable camera engine and its BakkesMod host
+#include "Core/SequenceEngine.h"
+#include "Core/ShotLibrary.h"
+#include "Core/Profiler.h"
+#include "BakkesHost.h"
+
 #include "version.h"
 constexpr auto plugin_version = stringify(VERSION_MAJOR) "." stringify(VERSION_MINOR) "." stringify(VERSION_PATCH) "." stringify(VERSION_BUILD);
 
-struct ActionMapping {
-    std::string eventName;
-    std::string actionName;
-    float delay;
-    float customValue; // Custom value (e.g., swivel speed, FOV change)
-};
-
 class CamChangePlus : public BakkesMod::Plugin::BakkesModPlugin, public PluginWindowBase, public SettingsWindowBase {
 public:
     virtual void onLoad() override;
     virtual void onUnload() override;
 
-    std::vector<ActionMapping> eventActions;
     void SaveMappingsToFile();
     void LoadMappingsFromFile(const std::string& filename);
     
@@ -60,33 +59,17 @@ private:
     //
     void RenderWindow();
     void RenderSettings();
-    void ExecuteAction(const std::string& action, float value);
-    void ProcessEventActions(const std::string& event);
-    void ScheduleAction(const std::string& action, float delay, float value);
-    void StartSequencePlayback();
-    void StopSequencePlayback();
-    void ResetToDefault();
-
-    // ===========================
-    //        Game Hooks
-    // ===========================
-    void HookGameEvents();
-
-    // ===========================
-    //        Event Handlers
-    // ===========================
-    void OnBallTouch();
-    void OnExplosion();
-    void OnJump();
-    void OnDoubleJump();
-    void OnFlip();
+    void RenderPerformanceTab();
 
     // ===========================
-    //      Camera Controls
+    //      Camera Engine
     // ===========================
-    void ToggleReverseCam();
-    void ToggleBallCam(bool enable);
-    void AdjustCameraYaw(float yaw);
+    // Hooks, event handlers, sequencing and camera state live in the core
+    std::unique_ptr<BakkesHost> host;
+    std::unique_ptr<SequenceEngine> engine;
+    TraceRecorder traceRecorder;
+    LatencyMonitor latencyMonitor;
+    constexpr static uint64_t traceCapacity = 1 << 20; // 64 MB of 64-byte records
 
     // ===========================
     //    Console Commands (For Testing)
@@ -97,20 +80,6 @@ private:
     //    Internal State Variables
     // ===========================
 
-    float storedYaw = 0.0f;
-    float lastLoggedYaw = 0.0f;
-    bool isUsingBehindView = false;
-    bool hasJumped = false;
-    bool hasDoubleJumped = false;
-    bool hasFlipped = false;
-    bool wasOnGround = true;
-    bool tasRunning = false;  // Track whether TAS mode is active
-    size_t currentTasIndex = 0; // Track the current action being executed
-    bool prevJumpState = false;  // Tracks the previous state of GetbJumped()
-    bool prevOnGround = true;
-    std::string currentSequenceName = "New Shot"; // Stores the currently selected shot name
     bool showCamChangeWindow = false; // Tracks if the window is open
-    std::chrono::steady_clock::time_point lastBallTouchTime;
-    constexpr static double ballTouchCooldown = 0.2; // 200ms cooldown
     std::vector<std::pair<std::string, std::vector<std::pair<std::string, std::string>>>> eventMappings;
 };
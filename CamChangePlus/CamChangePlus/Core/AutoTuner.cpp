@@ -0,0 +1,98 @@
+#include "AutoTuner.h"
+
+#include <algorithm>
+
+AutoTuner::AutoTuner(ThreadPool& pool, const std::vector<BatchTrace>& traces) : pool(pool), traces(traces) {
+}
+
+double AutoTuner::Cost(const std::string& sequenceName, const std::vector<ActionMapping>& sequence) {
+    return CostBatch(sequenceName, { sequence }).front();
+}
+
+std::vector<double> AutoTuner::CostBatch(const std::string& sequenceName, const std::vector<std::vector<ActionMapping>>& candidates) {
+    size_t traceCount = traces.size();
+    std::vector<RunScore> scores(candidates.size() * traceCount);
+
+    pool.ParallelFor(scores.size(), [&](size_t index) {
+        const auto& sequence = candidates[index / traceCount];
+        const auto& trace = traces[index % traceCount];
+
+        auto targets = trace.targets.find(sequenceName);
+        if (targets == trace.targets.end()) return;
+        scores[index] = ScoreRun(trace.replay.Run(sequence), trace.replay.GetStartTime(), &targets->second);
+        });
+    evaluations += scores.size();
+
+    std::vector<double> costs(candidates.size(), 0.0);
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        double total = 0.0;
+        size_t targetCount = 0;
+        for (size_t t = 0; t < traceCount; ++t) {
+            const RunScore& score = scores[c * traceCount + t];
+            total += score.fireErrorSum + score.valueErrorSum * costOptions.valueWeight + score.missedTargets * costOptions.missPenalty;
+            targetCount += score.fireErrorSamples + score.missedTargets;
+        }
+        costs[c] = targetCount ? total / targetCount : 0.0;
+    }
+    return costs;
+}
+
+TuneResult AutoTuner::Tune(const std::string& sequenceName, std::vector<ActionMapping> sequence, const TuneOptions& options) {
+    costOptions = options;
+    evaluations = 0;
+
+    TuneResult result;
+    double bestCost = Cost(sequenceName, sequence);
+    result.initialCost = bestCost;
+
+    size_t half = std::max<size_t>(options.candidates, 3) / 2;
+    std::vector<std::vector<ActionMapping>> candidates;
+
+    for (size_t sweep = 0; sweep < options.maxSweeps; ++sweep) {
+        double sweepStartCost = bestCost;
+
+        for (size_t step = 0; step < sequence.size(); ++step) {
+            ActionValueRange valueRange = GetActionValueRange(FindActionByName(sequence[step].actionName));
+            // Only predicted events are raised ahead of time, so only their steps can fire early
+            float minDelay = IsPredictedEvent(FindEventByName(sequence[step].eventName)) ? -options.maxLead : 0.0f;
+            for (int parameter = 0; parameter < (options.tuneValues ? 2 : 1); ++parameter) {
+                bool isDelay = parameter == 0;
+                if (!isDelay && valueRange.IsEmpty()) continue;
+                float stride = isDelay ? options.initialDelayStep : options.initialValueStep;
+                float minStride = isDelay ? options.minDelayStep : options.minValueStep;
+
+                // Line search: try a symmetric fan around the current value,
+                // recentre on the best point, narrow when the centre wins
+                while (stride >= minStride) {
+                    float center = isDelay ? sequence[step].delay : sequence[step].customValue;
+                    candidates.assign(half * 2, sequence);
+                    size_t slot = 0;
+                    for (int k = -static_cast<int>(half); k <= static_cast<int>(half); ++k) {
+                        if (k == 0) continue;
+                        float x = center + k * stride;
+                        x = isDelay ? std::clamp(x, minDelay, options.maxDelay) : std::clamp(x, valueRange.min, valueRange.max);
+                        (isDelay ? candidates[slot].at(step).delay : candidates[slot].at(step).customValue) = x;
+                        slot++;
+                    }
+
+                    auto costs = CostBatch(sequenceName, candidates);
+                    size_t best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+                    if (costs[best] < bestCost) {
+                        bestCost = costs[best];
+                        sequence = candidates[best];
+                    }
+                    else {
+                        stride /= static_cast<float>(std::max<size_t>(half, 2));
+                    }
+                }
+            }
+        }
+
+        if (bestCost >= sweepStartCost) break;
+    }
+
+    result.sequence = std::move(sequence);
+    result.finalCost = bestCost;
+    result.evaluations = evaluations;
+    return result;
+}
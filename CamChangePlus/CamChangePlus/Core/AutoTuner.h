@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "BatchEvaluator.h"
+#include "Sequence.h"
+#include "ThreadPool.h"
+
+struct TuneOptions {
+    size_t maxSweeps = 6;          // Passes over every coordinate
+    size_t candidates = 9;         // Points tried per line search round, evaluated in parallel
+    float initialDelayStep = 0.5f; // Seconds
+    float minDelayStep = 0.002f;
+    float maxDelay = 10.0f;
+    float maxLead = 2.0f;          // Seconds a predicted event's step may fire ahead of it (negative delay); the predictor's horizon
+    bool tuneValues = false;       // Also search customValue within the action's range (only steps with value targets matter)
+    float initialValueStep = 20.0f;
+    float minValueStep = 0.25f;
+    float valueWeight = 0.01f;     // Seconds of cost per unit of value error
+    float missPenalty = 1.0f;      // Seconds of cost per target whose step never fired
+};
+
+struct TuneResult {
+    std::vector<ActionMapping> sequence;
+    double initialCost = 0.0;
+    double finalCost = 0.0;
+    size_t evaluations = 0;        // Sequence x trace replays run
+};
+
+// Fits ActionMapping::delay (and optionally customValue) to target fire
+// times by coordinate descent. Each line search round replays every
+// candidate on every trace as one parallel batch.
+class AutoTuner {
+public:
+    AutoTuner(ThreadPool& pool, const std::vector<BatchTrace>& traces);
+
+    // Mean cost per target for one candidate sequence
+    double Cost(const std::string& sequenceName, const std::vector<ActionMapping>& sequence);
+    TuneResult Tune(const std::string& sequenceName, std::vector<ActionMapping> sequence, const TuneOptions& options = {});
+
+private:
+    // Scores every candidate on every trace in one ParallelFor
+    std::vector<double> CostBatch(const std::string& sequenceName, const std::vector<std::vector<ActionMapping>>& candidates);
+
+    ThreadPool& pool;
+    const std::vector<BatchTrace>& traces;
+    TuneOptions costOptions;
+    size_t evaluations = 0;
+};
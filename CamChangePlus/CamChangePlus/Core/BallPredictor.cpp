@@ -0,0 +1,177 @@
+#include "BallPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Profiler.h"
+#include "SimdF4.h"
+
+namespace {
+    // Velocity jitter direction per lane; lane 0 is the measured ball
+    constexpr float laneJitter[BallPredictor::laneCount][3] = {
+        {  0.0f,  0.0f,  0.0f },
+        {  1.0f,  0.0f,  0.0f },
+        { -1.0f,  0.0f,  0.0f },
+        {  0.0f,  1.0f,  0.0f },
+        {  0.0f, -1.0f,  0.0f },
+        {  0.0f,  0.0f,  1.0f },
+        {  0.0f,  0.0f, -1.0f },
+        {  0.6f,  0.6f,  0.6f },
+    };
+
+    struct alignas(16) Lanes {
+        float px[BallPredictor::laneCount];
+        float py[BallPredictor::laneCount];
+        float pz[BallPredictor::laneCount];
+        float vx[BallPredictor::laneCount];
+        float vy[BallPredictor::laneCount];
+        float vz[BallPredictor::laneCount];
+    };
+}
+
+GameEvent GetPredictedEvent(BallHitKind kind) {
+    switch (kind) {
+    case BallHitKind::Wall:        return GameEvent::PredictedWallHit;
+    case BallHitKind::GoalLine:    return GameEvent::PredictedGoalLine;
+    case BallHitKind::FloorBounce: return GameEvent::PredictedFloorBounce;
+    default:                       return GameEvent::Invalid;
+    }
+}
+
+BallHitKind GetBallHitKind(GameEvent event) {
+    switch (event) {
+    case GameEvent::PredictedWallHit:     return BallHitKind::Wall;
+    case GameEvent::PredictedGoalLine:    return BallHitKind::GoalLine;
+    case GameEvent::PredictedFloorBounce: return BallHitKind::FloorBounce;
+    default:                              return BallHitKind::Count;
+    }
+}
+
+void BallPredictor::Predict(const BallState& ball, BallPrediction& prediction) const {
+    CCP_TRACE_SCOPE("BallPredictor::Predict");
+    prediction = {};
+
+    Lanes lanes;
+    float speed = std::sqrt(ball.velocity.X * ball.velocity.X + ball.velocity.Y * ball.velocity.Y + ball.velocity.Z * ball.velocity.Z);
+    float velocityScale = speed > maxSpeed ? maxSpeed / speed : 1.0f;
+    float jitter = speed * velocityScale * options.velocitySpread;
+    for (size_t lane = 0; lane < laneCount; ++lane) {
+        lanes.px[lane] = ball.location.X;
+        lanes.py[lane] = ball.location.Y;
+        lanes.pz[lane] = ball.location.Z;
+        lanes.vx[lane] = ball.velocity.X * velocityScale + laneJitter[lane][0] * jitter;
+        lanes.vy[lane] = ball.velocity.Y * velocityScale + laneJitter[lane][1] * jitter;
+        lanes.vz[lane] = ball.velocity.Z * velocityScale + laneJitter[lane][2] * jitter;
+    }
+
+    // First step each lane saw each kind of hit; -1 for never
+    int firstHit[BallHitKindCount][laneCount];
+    std::fill(&firstHit[0][0], &firstHit[0][0] + BallHitKindCount * laneCount, -1);
+    int unresolved = static_cast<int>(BallHitKindCount * laneCount);
+
+    const float dt = options.timeStep;
+    const int steps = std::max(1, static_cast<int>(options.horizon / dt));
+    const F4 gravityStep = Splat(gravity * dt);
+    const F4 dragFactor = Splat(1.0f - drag * dt);
+    const F4 step = Splat(dt);
+    const F4 bounce = Splat(-restitution);
+    const F4 two = Splat(2.0f);
+    const F4 floorZ = Splat(radius);
+    const F4 ceilingZ = Splat(ceiling - radius);
+    const F4 sideX = Splat(sideWall - radius);
+    const F4 backY = Splat(backWall - radius);
+    const F4 goalY = Splat(backWall + radius);
+    const F4 goalX = Splat(goalHalfWidth);
+    const F4 goalZ = Splat(goalHeight - radius);
+    const F4 bounceSpeed = Splat(-minBounceSpeed);
+
+    auto record = [&](BallHitKind kind, int bits, size_t block, int stepIndex, F4 px, F4 py, F4 pz) {
+        for (int i = 0; bits; ++i, bits >>= 1) {
+            if (!(bits & 1)) continue;
+            int& first = firstHit[static_cast<size_t>(kind)][block + i];
+            if (first >= 0) continue;
+
+            first = stepIndex;
+            unresolved--;
+            if (block + i == 0) {
+                alignas(16) float x[4], y[4], z[4];
+                Store(x, px);
+                Store(y, py);
+                Store(z, pz);
+                prediction.hits[static_cast<size_t>(kind)].location = { x[0], y[0], z[0] };
+            }
+        }
+    };
+
+    int stepIndex = 0;
+    for (; stepIndex < steps && unresolved > 0; ++stepIndex) {
+        for (size_t block = 0; block < laneCount; block += 4) {
+            F4 px = Load(lanes.px + block), py = Load(lanes.py + block), pz = Load(lanes.pz + block);
+            F4 vx = Load(lanes.vx + block), vy = Load(lanes.vy + block), vz = Load(lanes.vz + block);
+
+            vz = vz + gravityStep;
+            vx = vx * dragFactor;
+            vy = vy * dragFactor;
+            vz = vz * dragFactor;
+            px = px + vx * step;
+            py = py + vy * step;
+            pz = pz + vz * step;
+
+            // Floor: reflect, and count it as a bounce only when it hits hard enough
+            F4 below = Less(pz, floorZ);
+            int floorBits = MoveMask(And(below, Less(vz, bounceSpeed)));
+            pz = Select(below, two * floorZ - pz, pz);
+            vz = Select(below, vz * bounce, vz);
+
+            F4 above = Less(ceilingZ, pz);
+            pz = Select(above, two * ceilingZ - pz, pz);
+            vz = Select(above, vz * bounce, vz);
+
+            // Side walls
+            F4 ax = Abs(px);
+            F4 side = Less(sideX, ax);
+            px = Select(side, px - CopySign(two * (ax - sideX), px), px);
+            vx = Select(side, vx * bounce, vx);
+
+            // Back walls, except inside the goal mouth where the ball crosses the line
+            F4 ay = Abs(py);
+            F4 inMouth = And(Less(Abs(px), goalX), Less(pz, goalZ));
+            F4 back = AndNot(inMouth, Less(backY, ay));
+            py = Select(back, py - CopySign(two * (ay - backY), py), py);
+            vy = Select(back, vy * bounce, vy);
+            int goalBits = MoveMask(And(inMouth, Less(goalY, ay)));
+            int wallBits = MoveMask(Or(side, back));
+
+            if (floorBits) record(BallHitKind::FloorBounce, floorBits, block, stepIndex, px, py, pz);
+            if (wallBits) record(BallHitKind::Wall, wallBits, block, stepIndex, px, py, pz);
+            if (goalBits) record(BallHitKind::GoalLine, goalBits, block, stepIndex, px, py, pz);
+
+            Store(lanes.px + block, px);
+            Store(lanes.py + block, py);
+            Store(lanes.pz + block, pz);
+            Store(lanes.vx + block, vx);
+            Store(lanes.vy + block, vy);
+            Store(lanes.vz + block, vz);
+        }
+    }
+    prediction.steps = stepIndex;
+
+    for (size_t kind = 0; kind < BallHitKindCount; ++kind) {
+        int hits = 0;
+        int stepSum = 0;
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            if (firstHit[kind][lane] < 0) continue;
+            hits++;
+            stepSum += firstHit[kind][lane];
+        }
+
+        PredictedHit& hit = prediction.hits[kind];
+        hit.confidence = static_cast<float>(hits) / laneCount;
+        hit.valid = hits > 0 && hit.confidence >= options.agreement;
+        if (!hit.valid) continue;
+
+        // Time on the measured path when it hit, else the ensemble mean
+        float hitStep = firstHit[kind][0] >= 0 ? static_cast<float>(firstHit[kind][0]) : static_cast<float>(stepSum) / hits;
+        hit.time = (hitStep + 1.0f) * dt;
+    }
+}
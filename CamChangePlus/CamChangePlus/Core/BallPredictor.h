@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+#include "CamHost.h"
+#include "GameEvents.h"
+
+// What the predictor looks for along the ball's path
+enum class BallHitKind : uint8_t {
+    Wall,      // Side or back wall outside the goal mouth
+    GoalLine,  // Whole ball past the goal line inside the goal mouth
+    FloorBounce,
+    Count
+};
+
+constexpr size_t BallHitKindCount = static_cast<size_t>(BallHitKind::Count);
+
+// Predicted event for a BallHitKind; GameEvent::Invalid for none
+GameEvent GetPredictedEvent(BallHitKind kind);
+BallHitKind GetBallHitKind(GameEvent event);
+
+struct PredictedHit {
+    bool valid = false;
+    float time = 0.0f;       // Seconds from now
+    float confidence = 0.0f; // Fraction of lanes that saw the hit within the horizon
+    CamVector location;      // Ball position at the hit on the nominal path
+};
+
+struct BallPrediction {
+    std::array<PredictedHit, BallHitKindCount> hits;
+    int steps = 0; // Integration steps taken this tick
+
+    const PredictedHit& Get(BallHitKind kind) const { return hits[static_cast<size_t>(kind)]; }
+};
+
+struct BallPredictorOptions {
+    float horizon = 2.0f;          // Seconds integrated ahead each tick
+    float timeStep = 1.0f / 120.0f;
+    float velocitySpread = 0.04f;  // Relative velocity jitter across lanes
+    float agreement = 0.6f;        // Lanes that must agree before a hit counts
+};
+
+// Rocket League ball physics reduced to gravity, drag and bounces off the
+// arena's bounding planes (no rounded corners or goal interiors). The state
+// is integrated for a small ensemble at once: lane 0 is the measured ball,
+// the other lanes jitter its velocity so a hit is only reported when most
+// of them agree. Lanes are laid out SoA and stepped four at a time with SSE2
+// (scalar fallback elsewhere), so the whole horizon costs a few microseconds.
+class BallPredictor {
+public:
+    constexpr static size_t laneCount = 8;
+
+    explicit BallPredictor(BallPredictorOptions options = {}) : options(options) {
+    }
+
+    void Predict(const BallState& ball, BallPrediction& prediction) const;
+
+    const BallPredictorOptions& GetOptions() const { return options; }
+
+    // Arena constants in unreal units
+    constexpr static float gravity = -650.0f;
+    constexpr static float drag = 0.0305f;       // Fraction of velocity lost per second
+    constexpr static float maxSpeed = 6000.0f;
+    constexpr static float radius = 92.75f;
+    constexpr static float restitution = 0.6f;
+    constexpr static float sideWall = 4096.0f;   // |X|
+    constexpr static float backWall = 5120.0f;   // |Y|
+    constexpr static float ceiling = 2044.0f;
+    constexpr static float goalHalfWidth = 892.755f;
+    constexpr static float goalHeight = 642.775f;
+    constexpr static float minBounceSpeed = 250.0f; // Slower floor contacts are rolling, not bounces
+
+private:
+    BallPredictorOptions options;
+};
@@ -0,0 +1,111 @@
+#include "BatchEvaluator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+bool LoadFireTargets(const std::filesystem::path& filepath, std::vector<BatchTrace>& traces) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream row(line);
+        std::string traceName, sequenceName, step, time, value;
+        if (!std::getline(row, traceName, ',') || !std::getline(row, sequenceName, ',') ||
+            !std::getline(row, step, ',') || !std::getline(row, time, ',')) continue;
+
+        try {
+            FireTarget target{ std::stoul(step), std::stod(time) };
+            if (std::getline(row, value) && !value.empty()) {
+                target.hasValue = true;
+                target.value = std::stof(value);
+            }
+            for (auto& trace : traces) {
+                if (trace.name == traceName) trace.targets[sequenceName].push_back(target);
+            }
+        }
+        catch (const std::exception&) {
+            // Header or malformed row
+        }
+    }
+    return true;
+}
+
+RunScore ScoreRun(const ReplayResult& result, double traceStart, const std::vector<FireTarget>* targets) {
+    RunScore score;
+    score.completed = result.completed;
+    // Only the armed steps stalled; the steps behind them never got the chance
+    if (!result.completed) score.stalledSteps = result.graph.active;
+
+    if (!targets) return score;
+
+    for (const auto& target : *targets) {
+        auto fired = std::find_if(result.timeline.begin(), result.timeline.end(),
+            [&](const TimelineEntry& entry) { return entry.step == target.step; });
+        if (fired == result.timeline.end()) {
+            score.missedTargets++;
+            continue;
+        }
+        score.fireErrorSum += std::abs((fired->time - traceStart) - target.time);
+        score.fireErrorSamples++;
+        if (target.hasValue) score.valueErrorSum += std::abs(fired->value - target.value);
+    }
+    return score;
+}
+
+BatchEvaluator::BatchEvaluator(ThreadPool& pool) : pool(pool) {
+}
+
+void BatchEvaluator::AddTrace(BatchTrace trace) {
+    traces.push_back(std::move(trace));
+}
+
+std::vector<SequenceStats> BatchEvaluator::Evaluate(const std::map<std::string, std::vector<ActionMapping>>& shots) {
+    std::vector<const std::pair<const std::string, std::vector<ActionMapping>>*> sequences;
+    for (const auto& shot : shots) sequences.push_back(&shot);
+
+    size_t traceCount = traces.size();
+    std::vector<RunScore> scores(sequences.size() * traceCount);
+
+    pool.ParallelFor(scores.size(), [&](size_t index) {
+        const auto& [name, sequence] = *sequences[index / traceCount];
+        const auto& trace = traces[index % traceCount];
+
+        auto targets = trace.targets.find(name);
+        scores[index] = ScoreRun(trace.replay.Run(sequence), trace.replay.GetStartTime(),
+            targets != trace.targets.end() ? &targets->second : nullptr);
+        });
+
+    std::vector<SequenceStats> stats;
+    stats.reserve(sequences.size());
+    for (size_t s = 0; s < sequences.size(); ++s) {
+        SequenceStats entry;
+        entry.name = sequences[s]->first;
+        entry.stepCount = sequences[s]->second.size();
+        entry.stallCounts.assign(entry.stepCount, 0);
+
+        double errorSum = 0.0;
+        for (size_t t = 0; t < traceCount; ++t) {
+            const RunScore& score = scores[s * traceCount + t];
+            entry.runs++;
+            if (score.completed) entry.completions++;
+            for (uint64_t stalled = score.stalledSteps; stalled; stalled &= stalled - 1) {
+                entry.stallCounts[std::countr_zero(stalled)]++;
+            }
+            errorSum += score.fireErrorSum;
+            entry.fireErrorSamples += score.fireErrorSamples;
+            entry.missedTargets += score.missedTargets;
+        }
+
+        entry.completionRate = entry.runs ? static_cast<double>(entry.completions) / entry.runs : 0.0;
+        entry.meanFireError = entry.fireErrorSamples ? errorSum / entry.fireErrorSamples : 0.0;
+        if (!entry.stallCounts.empty()) {
+            entry.worstStallStep = std::max_element(entry.stallCounts.begin(), entry.stallCounts.end()) - entry.stallCounts.begin();
+        }
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Sequence.h"
+#include "ThreadPool.h"
+#include "TraceReplay.h"
+
+// Desired fire time (and optionally value) of one step, relative to the
+// start of its trace
+struct FireTarget {
+    size_t step;
+    double time;
+    bool hasValue = false;
+    float value = 0.0f;
+};
+
+// A trace plus, per sequence name, where that sequence's cuts should land
+struct BatchTrace {
+    std::string name;
+    TraceReplay replay;
+    std::map<std::string, std::vector<FireTarget>> targets;
+};
+
+// Outcome of one sequence on one trace
+struct RunScore {
+    bool completed = false;
+    uint64_t stalledSteps = 0;    // Bit per step still armed and waiting when the trace ended
+    double fireErrorSum = 0.0;    // Sum of |fired - target| over matched targets
+    size_t fireErrorSamples = 0;
+    size_t missedTargets = 0;     // Targets whose step never fired
+    double valueErrorSum = 0.0;   // Sum of |value - target value| where requested
+};
+
+struct SequenceStats {
+    std::string name;
+    size_t stepCount = 0;
+    size_t runs = 0;
+    size_t completions = 0;
+    double completionRate = 0.0;
+    double meanFireError = 0.0;   // Seconds, over every target that fired
+    size_t fireErrorSamples = 0;
+    size_t missedTargets = 0;
+    std::vector<size_t> stallCounts; // Runs that ended waiting on each step (each branch's armed step counts)
+    size_t worstStallStep = 0;       // Step with the most stalls
+};
+
+// Reads "trace,sequence,step,time[,value]" CSV rows (time relative to trace
+// start) into the traces whose name matches the first column
+bool LoadFireTargets(const std::filesystem::path& filepath, std::vector<BatchTrace>& traces);
+
+// Scores a single replay result against its targets
+RunScore ScoreRun(const ReplayResult& result, double traceStart, const std::vector<FireTarget>* targets);
+
+// Runs every (sequence x trace) pair on the thread pool and folds the
+// results into per-sequence statistics. Each pair writes into its own slot,
+// so workers share nothing but the read-only traces.
+class BatchEvaluator {
+public:
+    explicit BatchEvaluator(ThreadPool& pool);
+
+    void AddTrace(BatchTrace trace);
+    const std::vector<BatchTrace>& GetTraces() const { return traces; }
+
+    std::vector<SequenceStats> Evaluate(const std::map<std::string, std::vector<ActionMapping>>& shots);
+
+private:
+    ThreadPool& pool;
+    std::vector<BatchTrace> traces;
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <functional>
+#include <filesystem>
+
+// Swivel rotation in Unreal rotator units (65536 == 360 degrees)
+struct CamRotator {
+    int Pitch = 0;
+    int Yaw = 0;
+    int Roll = 0;
+};
+
+struct CamVector {
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+};
+
+// Profile camera settings the rig can animate
+struct CamSettings {
+    float fov = 90.0f;
+    float distance = 270.0f;
+    float height = 100.0f;
+    float angle = -4.0f; // Camera pitch angle in degrees
+};
+
+struct BallState {
+    CamVector location;
+    CamVector velocity;
+};
+
+// Opaque identity of a car (its object address on the live host); 0 = none
+using CarHandle = uintptr_t;
+
+// Snapshot of the local car taken when an event fires and once per tick
+struct CarState {
+    CamVector location;
+    CamVector velocity;
+    float boost = 0.0f;    // 0..1
+    bool onGround = true;  // Wheels on any surface, walls included
+    bool onWall = false;
+    bool supersonic = false;
+};
+
+// One car in the match, for tracking every car at once
+struct MatchCar {
+    CarHandle handle = 0;
+    uint8_t team = 0; // 0 = blue, 1 = orange
+    CarState state;
+};
+
+// Thin interface between the portable camera engine and whatever runs it.
+// The BakkesMod plugin implements this with gameWrapper/cvarManager, the
+// MockHost implements it with a virtual clock so the engine runs headless.
+class CamHost {
+public:
+    virtual ~CamHost() = default;
+
+    // ===========================
+    //        Game Hooks
+    // ===========================
+    virtual void HookEvent(const std::string& eventName, std::function<void()> callback) = 0;
+    // For functions that run once per car: the callback gets the car it ran
+    // on (the owning car for car components), 0 when that can't be resolved.
+    // Removed with UnhookEvent like any other hook.
+    virtual void HookEventWithCaller(const std::string& eventName, std::function<void(CarHandle caller)> callback) = 0;
+    virtual void UnhookEvent(const std::string& eventName) = 0;
+
+    // ===========================
+    //     Timers / Game Thread
+    // ===========================
+    virtual void SetTimeout(std::function<void()> callback, float delaySeconds) = 0;
+    virtual void Execute(std::function<void()> callback) = 0;
+    // Monotonic time in seconds; virtual time for offline hosts
+    virtual double GetTime() = 0;
+
+    // ===========================
+    //        Local Car
+    // ===========================
+    // Returns false when there is no local car
+    virtual bool GetLocalCarState(CarState& state) = 0;
+    // Car the camera is about: the local car, else the spectated one; 0 for none
+    virtual CarHandle GetFocusCar() = 0;
+    // State of one car by handle (a hook's caller, the focus car); false once
+    // it has left or been destroyed
+    virtual bool GetCarState(CarHandle car, CarState& state) = 0;
+    // Every car in the match or replay, up to capacity; returns the count
+    virtual size_t GetCars(MatchCar* cars, size_t capacity) = 0;
+    // Playback position in seconds; false outside replays
+    virtual bool GetReplayTime(double& time) = 0;
+    // Identifies the replay being watched; empty outside replays
+    virtual std::string GetReplayId() = 0;
+    // Returns false when there is no ball (menus, replays without a game)
+    virtual bool GetBallState(BallState& state) = 0;
+
+    // ===========================
+    //      Camera Controls
+    // ===========================
+    // Each returns false when the player controller / camera is unavailable
+    virtual bool SetUsingBehindView(bool enable) = 0;
+    virtual bool SetUsingSecondaryCamera(bool enable) = 0;
+    virtual bool GetCameraSwivel(CamRotator& swivel) = 0;
+    virtual bool SetCameraSwivel(const CamRotator& swivel) = 0;
+    virtual bool GetCameraSettings(CamSettings& settings) = 0;
+    virtual bool SetCameraSettings(const CamSettings& settings) = 0;
+
+    // ===========================
+    //      Logging / Storage
+    // ===========================
+    virtual void Log(const std::string& message) = 0;
+    virtual std::filesystem::path GetDataFolder() = 0;
+};
@@ -0,0 +1,403 @@
+#include "CameraController.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+bool CameraCommandBuffer::IsEmpty() const {
+    if (hasBehindView || hasSecondaryCamera || hasYaw || releaseRig || hasManualYaw || stopShake || hasShake) return false;
+    return std::none_of(rigKeys.begin(), rigKeys.end(), [](const RigKeyCommand& key) { return key.has; });
+}
+
+CameraController::CameraController(CamHost& host) : host(host) {
+}
+
+void CameraController::ToggleReverseCam() {
+    pending.behindView = !IsUsingBehindView();
+    pending.hasBehindView = true;
+    pending.behindViewStamp = actionStamp;
+    RequestCommit();
+}
+
+void CameraController::SetReverseCam(bool enable) {
+    if (IsUsingBehindView() != enable) ToggleReverseCam();
+}
+
+void CameraController::ToggleBallCam(bool enable) {
+    pending.secondaryCamera = enable;
+    pending.hasSecondaryCamera = true;
+    pending.secondaryCameraStamp = actionStamp;
+    RequestCommit();
+}
+
+void CameraController::ToggleSwivelDirection() {
+    yawDirectionRight = !yawDirectionRight;
+    host.Log("[CamChangePlus] Yaw direction set to " + std::string(yawDirectionRight ? "Right" : "Left"));
+}
+
+void CameraController::AdjustCameraYaw(float yawPercentage, float duration, EaseCurve curve) {
+    // Clamp the input between -100 and 100
+    yawPercentage = std::max(-100.0f, std::min(100.0f, yawPercentage));
+
+    // 0 stops forcing yaw (restore default swivel behavior) on commit
+    pending.yawPercentage = yawPercentage;
+    pending.yawDuration = duration;
+    pending.yawCurve = curve;
+    pending.hasYaw = true;
+    pending.yawStamp = actionStamp;
+    RequestCommit();
+
+    if (yawPercentage != 0.0f) {
+        // Log the change when the command is used
+        host.Log("[CamChangePlus] Updated camera yaw to: " + std::to_string(yawPercentage) +
+            "% (Mapped value: " + std::to_string((yawPercentage / 100.0f) * maxYaw) + ")");
+    }
+}
+
+void CameraController::KeyRig(RigChannel channel, float value, float duration, SplineMode mode) {
+    if (channel >= RigChannel::Count) return;
+
+    RigKeyCommand& key = pending.rigKeys[static_cast<size_t>(channel)];
+    key = { true, host.GetTime(), value, duration, mode, actionStamp };
+    RequestCommit();
+}
+
+void CameraController::ReleaseRig() {
+    // Keys requested earlier this tick are released along with the rest
+    pending.releaseRig = true;
+    pending.rigKeys = {};
+    RequestCommit();
+}
+
+void CameraController::SetManualYaw(float yawPercentage, float weight) {
+    pending.manualYawPercentage = std::max(-100.0f, std::min(100.0f, yawPercentage));
+    pending.manualWeight = std::max(0.0f, std::min(1.0f, weight));
+    pending.hasManualYaw = true;
+    RequestCommit();
+}
+
+void CameraController::Shake(float amplitudePercentage, float duration, float frequency) {
+    pending.shakeAmplitude = amplitudePercentage;
+    pending.shakeDuration = duration;
+    pending.shakeFrequency = frequency;
+    pending.hasShake = true;
+    RequestCommit();
+}
+
+void CameraController::StopShake() {
+    pending.stopShake = true;
+    pending.hasShake = false;
+    RequestCommit();
+}
+
+void CameraController::ReleaseHooks() {
+    host.UnhookEvent(applySwivelHook);
+    frameHooked = false;
+    modifiers.Clear();
+    yawModifier = rigModifier = manualModifier = 0;
+    yawForced = false;
+    transitionDuration = 0.0f;
+    releaseOnArrival = false;
+    rig.Clear();
+    rigPose = {};
+    hasBaseSettings = false;
+}
+
+CameraSnapshot CameraController::Capture() const {
+    CameraSnapshot snapshot;
+    snapshot.behindView = IsUsingBehindView();
+    snapshot.hasBallCam = hasBallCam || pending.hasSecondaryCamera;
+    snapshot.ballCam = pending.hasSecondaryCamera ? pending.secondaryCamera : isUsingBallCam;
+    if (pending.hasYaw) snapshot.yawPercentage = pending.yawPercentage;
+    else if (yawForced && !releaseOnArrival) snapshot.yawPercentage = storedYawPercentage;
+    snapshot.yawDirectionRight = yawDirectionRight;
+
+    for (size_t i = 0; i < RigChannelCount; ++i) {
+        auto channel = static_cast<RigChannel>(i);
+        const RigKeyCommand& key = pending.rigKeys[i];
+        if (key.has) {
+            snapshot.rig.values[i] = key.value;
+        }
+        else if (rig.IsActive(channel) && !pending.releaseRig) {
+            const KeyframeTrack& track = rig.GetTrack(channel);
+            size_t cursor = 0;
+            snapshot.rig.values[i] = track.Evaluate(track.GetEndTime(), cursor);
+        }
+        else {
+            continue;
+        }
+        snapshot.rig.activeMask |= 1u << i;
+    }
+    return snapshot;
+}
+
+void CameraController::Restore(const CameraSnapshot& snapshot) {
+    SetReverseCam(snapshot.behindView);
+    if (snapshot.hasBallCam) ToggleBallCam(snapshot.ballCam);
+    AdjustCameraYaw(snapshot.yawPercentage);
+    yawDirectionRight = snapshot.yawDirectionRight;
+
+    ReleaseRig();
+    StopShake();
+    for (size_t i = 0; i < RigChannelCount; ++i) {
+        auto channel = static_cast<RigChannel>(i);
+        if (snapshot.rig.Has(channel)) KeyRig(channel, snapshot.rig.values[i]);
+    }
+}
+
+void CameraController::RequestCommit() {
+    if (commitQueued) return;
+
+    commitQueued = true;
+    host.Execute([this]() { Commit(); });
+}
+
+void CameraController::Commit() {
+    CCP_TRACE_SCOPE("CameraCommit");
+    commitQueued = false;
+    CameraCommandBuffer commands = pending;
+    pending = {};
+
+    if (commands.hasBehindView && commands.behindView != isUsingBehindView &&
+        host.SetUsingBehindView(commands.behindView)) {
+        isUsingBehindView = commands.behindView;
+        RecordApplied(commands.behindViewStamp);
+        host.Log("[CamChangePlus] Reverse Cam: " + std::string(isUsingBehindView ? "Enabled" : "Disabled"));
+    }
+
+    if (commands.hasSecondaryCamera && host.SetUsingSecondaryCamera(commands.secondaryCamera)) {
+        hasBallCam = true;
+        isUsingBallCam = commands.secondaryCamera;
+        RecordApplied(commands.secondaryCameraStamp);
+        host.Log("[CamChangePlus] Ball Cam: " + std::string(commands.secondaryCamera ? "Enabled" : "Disabled"));
+    }
+
+    if (commands.hasYaw) {
+        yawGeneration++;
+        bool easeOut = commands.yawDuration > 0.0f && yawForced;
+        if (commands.yawPercentage == 0.0f && !easeOut) {
+            ReleaseSwivel();
+        }
+        else {
+            // Convert percentage to actual yaw range (-23500 to 23500)
+            StartYawTransition((commands.yawPercentage / 100.0f) * maxYaw, commands.yawDuration, commands.yawCurve);
+            storedYawPercentage = commands.yawPercentage;
+            yawStamp = commands.yawStamp;
+            releaseOnArrival = commands.yawPercentage == 0.0f;
+            yawForced = true;
+            if (!yawModifier) yawModifier = modifiers.Push({ 0, ModifierLayer::Sequence, BlendMode::Override, ModifierChannel_Yaw });
+        }
+    }
+
+    if (commands.releaseRig && rig.IsActive()) {
+        ClearRig();
+        host.Log("[CamChangePlus] Camera rig released.");
+    }
+
+    for (size_t i = 0; i < RigChannelCount; ++i) {
+        const RigKeyCommand& key = commands.rigKeys[i];
+        if (!key.has) continue;
+
+        auto channel = static_cast<RigChannel>(i);
+        float current = rig.IsActive(channel) ? 0.0f : GetRigChannelValue(channel);
+        rig.Key(channel, key.time, current, key.value, key.duration, key.mode);
+        RecordApplied(key.stamp);
+    }
+    if (!rigModifier && (rig.IsActive(RigChannel::Yaw) || rig.IsActive(RigChannel::Pitch))) {
+        // Channels are filled in per frame from the rig pose
+        rigModifier = modifiers.Push({ 0, ModifierLayer::Sequence, BlendMode::Override, 0 });
+    }
+
+    if (commands.hasManualYaw) {
+        if (commands.manualYawPercentage == 0.0f) {
+            modifiers.Remove(manualModifier);
+            manualModifier = 0;
+        }
+        else {
+            if (!manualModifier) manualModifier = modifiers.Push({ 0, ModifierLayer::Manual, BlendMode::Override, ModifierChannel_Yaw });
+            if (CameraModifier* manual = modifiers.Find(manualModifier)) {
+                manual->yaw = commands.manualYawPercentage / 100.0f * maxYaw;
+                manual->weight = commands.manualWeight;
+            }
+        }
+    }
+
+    if (commands.stopShake) modifiers.RemoveLayer(ModifierLayer::Shake);
+    if (commands.hasShake) {
+        CameraModifier shake{ 0, ModifierLayer::Shake, BlendMode::Additive, ModifierChannel_Yaw | ModifierChannel_Pitch };
+        shake.amplitude = commands.shakeAmplitude / 100.0f * maxYaw;
+        shake.frequency = commands.shakeFrequency;
+        shake.startTime = host.GetTime();
+        shake.fadeDuration = commands.shakeDuration;
+        if (!modifiers.Push(shake)) host.Log("[CamChangePlus] Error: Camera modifier stack is full.");
+    }
+
+    UpdateFrameHook();
+}
+
+void CameraController::UpdateFrameHook() {
+    frameHookCheckQueued = false;
+    bool needed = rig.IsActive() || !modifiers.IsEmpty();
+    if (needed && !frameHooked) {
+        // Hook into ApplySwivel once; later changes only update the targets.
+        // The hook writes the camera directly so transitions and rig tracks
+        // cost no Execute per frame.
+        host.HookEvent(applySwivelHook, [this]() { OnCameraFrame(); });
+        frameHooked = true;
+    }
+    else if (!needed && frameHooked) {
+        host.UnhookEvent(applySwivelHook);
+        frameHooked = false;
+    }
+}
+
+void CameraController::OnCameraFrame() {
+    CCP_TRACE_SCOPE("CameraFrame");
+    if (rig.IsActive()) {
+        rig.Evaluate(host.GetTime(), rigPose);
+    }
+    else {
+        rigPose.activeMask = 0;
+    }
+
+    if (!modifiers.IsEmpty()) ApplySwivel();
+    if (rigPose.Has(RigChannel::Fov) || rigPose.Has(RigChannel::Distance) ||
+        rigPose.Has(RigChannel::Height) || rigPose.Has(RigChannel::Angle)) {
+        ApplyRigSettings();
+    }
+}
+
+void CameraController::ReleaseSwivel() {
+    yawForced = false;
+    modifiers.Remove(yawModifier);
+    yawModifier = 0;
+    appliedYaw = 0.0f;
+    transitionDuration = 0.0f;
+    releaseOnArrival = false;
+    UpdateFrameHook();
+    host.Log("[CamChangePlus] Restored normal camera swivel (yaw = 0%).");
+}
+
+void CameraController::StartYawTransition(float targetYaw, float duration, EaseCurve curve) {
+    // Retargeting mid-transition starts from wherever the camera is now
+    transitionFrom = yawForced ? StepYawTransition() : 0.0f;
+    storedYaw = targetYaw;
+    transitionStart = host.GetTime();
+    transitionDuration = duration > 0.0f ? duration : 0.0f;
+    transitionCurve = curve;
+}
+
+float CameraController::StepYawTransition() {
+    if (transitionDuration <= 0.0f) return storedYaw;
+
+    float t = static_cast<float>((host.GetTime() - transitionStart) / transitionDuration);
+    if (t >= 1.0f) {
+        transitionDuration = 0.0f;
+        return storedYaw;
+    }
+    return transitionFrom + (storedYaw - transitionFrom) * EvaluateEase(transitionCurve, t);
+}
+
+void CameraController::ApplySwivel() {
+    CCP_TRACE_SCOPE("ApplySwivel");
+    // Get the current swivel settings
+    CamRotator swivel;
+    if (!host.GetCameraSwivel(swivel)) {
+        host.Log("[CamChangePlus] Error: Camera is null.");
+        return;
+    }
+
+    // Refresh the modifiers this controller drives, then fold the stack:
+    // forced yaw (or its transition), rig swivel, manual override, shakes
+    if (yawForced) {
+        appliedYaw = StepYawTransition();
+        if (CameraModifier* yaw = modifiers.Find(yawModifier)) yaw->yaw = appliedYaw;
+    }
+    if (CameraModifier* rigSwivel = modifiers.Find(rigModifier)) {
+        rigSwivel->channels = (rigPose.Has(RigChannel::Yaw) ? ModifierChannel_Yaw : 0) |
+            (rigPose.Has(RigChannel::Pitch) ? ModifierChannel_Pitch : 0);
+        rigSwivel->yaw = rigPose.values[static_cast<size_t>(RigChannel::Yaw)] / 100.0f * maxYaw;
+        rigSwivel->pitch = rigPose.values[static_cast<size_t>(RigChannel::Pitch)] / 100.0f * maxPitch;
+    }
+
+    if (!modifiers.Compose(host.GetTime(), swivel) && !frameHookCheckQueued) {
+        // A shake faded out and nothing else is left; unhook outside the hook
+        frameHookCheckQueued = true;
+        host.Execute([this]() { UpdateFrameHook(); });
+    }
+    host.SetCameraSwivel(swivel);
+
+    if (!yawForced) return;
+
+    // Eased back to 0%; unhook outside the hook callback
+    if (releaseOnArrival && !IsYawTransitioning()) {
+        releaseOnArrival = false;
+        host.Execute([this, generation = yawGeneration]() {
+            if (generation == yawGeneration) ReleaseSwivel();
+            });
+    }
+
+    if (yawStamp.IsValid()) {
+        RecordApplied(yawStamp);
+        yawStamp = {};
+    }
+
+    // Log only when yaw changes
+    if (storedYaw != lastLoggedYaw) {
+        host.Log("[CamChangePlus] Applied Camera Yaw: " + std::to_string(static_cast<int>(storedYaw)) +
+            " (Percentage: " + std::to_string(storedYawPercentage) + "%)");
+        lastLoggedYaw = storedYaw;
+    }
+}
+
+void CameraController::ApplyRigSettings() {
+    CCP_TRACE_SCOPE("ApplyRigSettings");
+    CamSettings settings;
+    if (!host.GetCameraSettings(settings)) return;
+
+    const auto& values = rigPose.values;
+    if (rigPose.Has(RigChannel::Fov)) settings.fov = values[static_cast<size_t>(RigChannel::Fov)];
+    if (rigPose.Has(RigChannel::Distance)) settings.distance = values[static_cast<size_t>(RigChannel::Distance)];
+    if (rigPose.Has(RigChannel::Height)) settings.height = values[static_cast<size_t>(RigChannel::Height)];
+    if (rigPose.Has(RigChannel::Angle)) settings.angle = values[static_cast<size_t>(RigChannel::Angle)];
+    host.SetCameraSettings(settings);
+}
+
+float CameraController::GetRigChannelValue(RigChannel channel) {
+    if (channel == RigChannel::Yaw || channel == RigChannel::Pitch) {
+        CamRotator swivel;
+        if (!host.GetCameraSwivel(swivel)) return 0.0f;
+        if (channel == RigChannel::Pitch) return swivel.Pitch / maxPitch * 100.0f;
+        return (yawForced ? appliedYaw : static_cast<float>(swivel.Yaw)) / maxYaw * 100.0f;
+    }
+
+    CamSettings settings;
+    if (!host.GetCameraSettings(settings)) return 0.0f;
+    // First settings channel keyed: remember what to restore on release
+    if (!hasBaseSettings) {
+        baseSettings = settings;
+        hasBaseSettings = true;
+    }
+
+    switch (channel) {
+    case RigChannel::Fov:      return settings.fov;
+    case RigChannel::Distance: return settings.distance;
+    case RigChannel::Height:   return settings.height;
+    default:                   return settings.angle;
+    }
+}
+
+void CameraController::ClearRig() {
+    if (hasBaseSettings) {
+        host.SetCameraSettings(baseSettings);
+        hasBaseSettings = false;
+    }
+    rig.Clear();
+    rigPose.activeMask = 0;
+    modifiers.Remove(rigModifier);
+    rigModifier = 0;
+}
+
+void CameraController::RecordApplied(const LatencyStamp& stamp) {
+    if (latency && stamp.IsValid()) latency->RecordApplied(stamp, host.GetTime());
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <array>
+
+#include "CamHost.h"
+#include "LatencyHistogram.h"
+#include "Easing.h"
+#include "CameraRig.h"
+#include "CameraModifiers.h"
+
+// Rig key requested during a tick; keyed into the rig on commit
+struct RigKeyCommand {
+    bool has = false;
+    double time = 0.0;
+    float value = 0.0f;
+    float duration = 0.0f;
+    SplineMode mode = SplineMode::CatmullRom;
+    LatencyStamp stamp;
+};
+
+// Camera writes requested during one tick. Each property keeps only its last
+// writer, and the whole buffer is applied by a single Execute so a
+// multi-action step lands in one frame.
+struct CameraCommandBuffer {
+    bool hasBehindView = false;
+    bool behindView = false;
+    LatencyStamp behindViewStamp;
+
+    bool hasSecondaryCamera = false;
+    bool secondaryCamera = false;
+    LatencyStamp secondaryCameraStamp;
+
+    bool hasYaw = false;
+    float yawPercentage = 0.0f; // 0 releases the forced yaw
+    float yawDuration = 0.0f;
+    EaseCurve yawCurve = EaseCurve::Linear;
+    LatencyStamp yawStamp;
+
+    bool releaseRig = false; // Applied before any rig keys below
+    std::array<RigKeyCommand, RigChannelCount> rigKeys{};
+
+    bool hasManualYaw = false;
+    float manualYawPercentage = 0.0f; // 0 removes the override
+    float manualWeight = 1.0f;
+
+    bool stopShake = false; // Applied before a new shake below
+    bool hasShake = false;
+    float shakeAmplitude = 0.0f; // Percent of maxYaw
+    float shakeFrequency = 0.0f;
+    float shakeDuration = 0.0f;
+
+    bool IsEmpty() const;
+};
+
+// Lasting camera state a sequence leaves behind, captured for replay
+// checkpoints. Transitions are taken at their target; shakes are left out.
+// Ball cam is only restored once a sequence has set it, since the player's
+// own setting can't be read back.
+struct CameraSnapshot {
+    bool behindView = false;
+    bool hasBallCam = false; // Ball cam was set by a sequence at all
+    bool ballCam = false;
+    float yawPercentage = 0.0f; // 0 = not forced
+    bool yawDirectionRight = true;
+    RigPose rig; // Where each keyed channel ends up
+};
+
+// Owns the camera state the plugin forces on the player (reverse cam,
+// ball cam, swivel modifiers, rig tracks) and applies it through the host.
+class CameraController {
+public:
+    explicit CameraController(CamHost& host);
+
+    void ToggleReverseCam();
+    void SetReverseCam(bool enable);
+    void ToggleBallCam(bool enable);
+    // A duration eases from the yaw currently applied to the new one inside
+    // ApplySwivel; 0 snaps. Easing back to 0% releases the swivel on arrival.
+    void AdjustCameraYaw(float yawPercentage, float duration = 0.0f, EaseCurve curve = EaseCurve::Linear);
+    void ToggleSwivelDirection();
+
+    // Keys a rig channel to reach value after duration seconds, splined
+    // through any keys still ahead. Rig yaw/pitch and the forced yaw share the
+    // Sequence modifier layer; whichever started later wins.
+    void KeyRig(RigChannel channel, float value, float duration = 0.0f, SplineMode mode = SplineMode::CatmullRom);
+    // Clears every rig track and restores the camera settings it changed
+    void ReleaseRig();
+
+    // Manual-layer yaw blended over whatever the sequence is doing; 0% removes it
+    void SetManualYaw(float yawPercentage, float weight = 1.0f);
+    // Additive oscillation; a duration fades it out, 0 keeps it until StopShake
+    void Shake(float amplitudePercentage, float duration = 0.0f, float frequency = defaultShakeFrequency);
+    void StopShake();
+
+    // Drops the camera frame hook, e.g. on unload
+    void ReleaseHooks();
+
+    CameraSnapshot Capture() const;
+    // Snaps to the snapshot: transitions and shakes in flight are dropped
+    void Restore(const CameraSnapshot& snapshot);
+
+    // State including writes still waiting in the command buffer
+    bool IsUsingBehindView() const { return pending.hasBehindView ? pending.behindView : isUsingBehindView; }
+    bool IsYawDirectionRight() const { return yawDirectionRight; }
+    float GetStoredYaw() const { return storedYaw; }
+    float GetAppliedYaw() const { return appliedYaw; }
+    bool IsYawForced() const { return yawForced; }
+    bool IsYawTransitioning() const { return transitionDuration > 0.0f; }
+    const CameraRig& GetRig() const { return rig; }
+    const ModifierStack& GetModifiers() const { return modifiers; }
+
+    // Optional; camera writes report when the action that caused them landed
+    void SetLatencyMonitor(LatencyMonitor* monitor) { latency = monitor; }
+    // Stamp of the sequence action currently executing; attached to the next write
+    void SetActionStamp(const LatencyStamp& stamp) { actionStamp = stamp; }
+
+    // Percentage (-100..100) to swivel yaw/pitch units
+    constexpr static float maxYaw = 23500.0f;
+    constexpr static float maxPitch = 16384.0f;
+    constexpr static float defaultShakeFrequency = 8.0f; // Hz
+    // Fires once per camera update; the modifier stack and rig are applied here
+    constexpr static const char* applySwivelHook = "Function TAGame.Camera_TA.ApplySwivel";
+
+private:
+    // Queues one Execute per tick that commits everything buffered so far
+    void RequestCommit();
+    void Commit();
+
+    // Hooked while the rig is active or any swivel modifier is on the stack
+    void UpdateFrameHook();
+    void OnCameraFrame();
+    void ApplySwivel();
+    void ApplyRigSettings();
+
+    void StartYawTransition(float targetYaw, float duration, EaseCurve curve);
+    // Current point of the running transition; ends it once the time is up
+    float StepYawTransition();
+    void ReleaseSwivel();
+
+    void ClearRig();
+    // Where a channel is right now, used to seed its first key
+    float GetRigChannelValue(RigChannel channel);
+
+    void RecordApplied(const LatencyStamp& stamp);
+
+    CamHost& host;
+    LatencyMonitor* latency = nullptr;
+    LatencyStamp actionStamp;
+    LatencyStamp yawStamp; // Lands on the next ApplySwivel
+
+    CameraCommandBuffer pending;
+    bool commitQueued = false;
+    bool frameHooked = false;
+
+    bool yawForced = false;
+    float storedYaw = 0.0f;  // Target of the forced yaw
+    float appliedYaw = 0.0f; // Last forced yaw written to the swivel
+    float lastLoggedYaw = 0.0f;
+    float storedYawPercentage = 0.0f;
+
+    // Running transition (duration 0 = none); plain fields so ApplySwivel
+    // never allocates
+    float transitionFrom = 0.0f;
+    double transitionStart = 0.0;
+    float transitionDuration = 0.0f;
+    EaseCurve transitionCurve = EaseCurve::Linear;
+    bool releaseOnArrival = false;
+    uint32_t yawGeneration = 0; // Bumped per yaw commit; stale releases skip
+
+    // Forced yaw, rig swivel and manual yaw live here as modifiers alongside
+    // shakes; handles are 0 while absent
+    ModifierStack modifiers;
+    uint32_t yawModifier = 0;
+    uint32_t rigModifier = 0;
+    uint32_t manualModifier = 0;
+    bool frameHookCheckQueued = false;
+
+    CameraRig rig;
+    RigPose rigPose;
+    CamSettings baseSettings; // Player's settings before the rig touched them
+    bool hasBaseSettings = false;
+
+    bool isUsingBehindView = false;
+    bool hasBallCam = false;
+    bool isUsingBallCam = false;
+    bool yawDirectionRight = true; // true = right, false = left
+};
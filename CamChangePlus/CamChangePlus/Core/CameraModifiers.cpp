@@ -0,0 +1,110 @@
+#include "CameraModifiers.h"
+
+#include <cmath>
+
+namespace {
+    constexpr const char* layerNames[] = { "Base", "Sequence", "Manual", "Shake" };
+    static_assert(sizeof(layerNames) / sizeof(layerNames[0]) == static_cast<size_t>(ModifierLayer::Count));
+
+    constexpr float twoPi = 6.28318531f;
+
+    float Blend(BlendMode blend, float current, float value, float weight) {
+        return blend == BlendMode::Additive ? current + value * weight : current + (value - current) * weight;
+    }
+}
+
+const char* GetModifierLayerName(ModifierLayer layer) {
+    size_t index = static_cast<size_t>(layer);
+    return index < static_cast<size_t>(ModifierLayer::Count) ? layerNames[index] : "";
+}
+
+uint32_t ModifierStack::Push(const CameraModifier& modifier) {
+    if (count == capacity) return 0;
+
+    // Insert after the last entry of the same or a lower layer
+    size_t position = count;
+    while (position > 0 && modifiers[position - 1].layer > modifier.layer) {
+        modifiers[position] = modifiers[position - 1];
+        position--;
+    }
+
+    modifiers[position] = modifier;
+    modifiers[position].id = nextId++;
+    if (nextId == 0) nextId = 1; // 0 stays the invalid handle
+    count++;
+    return modifiers[position].id;
+}
+
+bool ModifierStack::Remove(uint32_t id) {
+    for (size_t i = 0; i < count; ++i) {
+        if (modifiers[i].id != id) continue;
+
+        for (size_t j = i + 1; j < count; ++j) modifiers[j - 1] = modifiers[j];
+        count--;
+        if (count == 0) hasLast = false;
+        return true;
+    }
+    return false;
+}
+
+void ModifierStack::RemoveLayer(ModifierLayer layer) {
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (modifiers[i].layer != layer) modifiers[kept++] = modifiers[i];
+    }
+    count = kept;
+    if (count == 0) hasLast = false;
+}
+
+CameraModifier* ModifierStack::Find(uint32_t id) {
+    for (size_t i = 0; i < count; ++i) {
+        if (modifiers[i].id == id) return &modifiers[i];
+    }
+    return nullptr;
+}
+
+bool ModifierStack::Compose(double time, CamRotator& swivel) {
+    if (hasLast && swivel.Yaw == lastOutput.Yaw && swivel.Pitch == lastOutput.Pitch) swivel = lastInput;
+    lastInput = swivel;
+
+    float yaw = static_cast<float>(swivel.Yaw);
+    float pitch = static_cast<float>(swivel.Pitch);
+    size_t kept = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const CameraModifier& modifier = modifiers[i];
+        float weight = modifier.weight;
+        float yawValue = modifier.yaw;
+        float pitchValue = modifier.pitch;
+        bool finished = false;
+
+        if (modifier.amplitude != 0.0f) {
+            auto elapsed = static_cast<float>(time - modifier.startTime);
+            if (modifier.fadeDuration > 0.0f) {
+                float remaining = 1.0f - elapsed / modifier.fadeDuration;
+                finished = remaining <= 0.0f;
+                weight *= remaining > 0.0f ? remaining : 0.0f;
+            }
+            // Pitch runs at a different rate so the motion doesn't trace a line
+            float phase = twoPi * modifier.frequency * elapsed;
+            yawValue += modifier.amplitude * std::sin(phase);
+            pitchValue += modifier.amplitude * 0.5f * std::sin(phase * 1.37f + 1.0f);
+        }
+
+        if (modifier.channels & ModifierChannel_Yaw) yaw = Blend(modifier.blend, yaw, yawValue, weight);
+        if (modifier.channels & ModifierChannel_Pitch) pitch = Blend(modifier.blend, pitch, pitchValue, weight);
+
+        // Compact in the same pass; order is preserved
+        if (!finished) {
+            if (kept != i) modifiers[kept] = modifier;
+            kept++;
+        }
+    }
+    count = kept;
+
+    swivel.Yaw = static_cast<int>(yaw);
+    swivel.Pitch = static_cast<int>(pitch);
+    lastOutput = swivel;
+    hasLast = count > 0;
+    return count > 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "CamHost.h"
+
+// Composition order: later layers see (and can override) earlier ones
+enum class ModifierLayer : uint8_t {
+    Base,     // Persistent offsets under everything else
+    Sequence, // Forced yaw and rig tracks driven by shots
+    Manual,   // Console/GUI overrides
+    Shake,    // Oscillation on top of the final framing
+    Count
+};
+
+enum class BlendMode : uint8_t {
+    Override, // Lerp the running result toward the value by weight
+    Additive  // Add value * weight
+};
+
+enum ModifierChannel : uint8_t {
+    ModifierChannel_Yaw = 1 << 0,
+    ModifierChannel_Pitch = 1 << 1,
+};
+
+const char* GetModifierLayerName(ModifierLayer layer);
+
+// One entry of the stack; plain data so the whole stack stays in one array
+struct CameraModifier {
+    uint32_t id = 0;
+    ModifierLayer layer = ModifierLayer::Base;
+    BlendMode blend = BlendMode::Override;
+    uint8_t channels = ModifierChannel_Yaw;
+    float weight = 1.0f;
+    float yaw = 0.0f;   // Swivel units
+    float pitch = 0.0f; // Swivel units
+
+    // Oscillation (amplitude 0 = static value). Adds a sine on top of
+    // yaw/pitch and fades out over fadeDuration (0 = no fade).
+    float amplitude = 0.0f;
+    float frequency = 0.0f;
+    double startTime = 0.0;
+    float fadeDuration = 0.0f;
+};
+
+// Fixed-capacity stack of swivel modifiers kept sorted by layer (insertion
+// order within a layer). Adding, updating or removing entries never touches
+// the game hook; Compose() folds the whole stack in a single pass.
+class ModifierStack {
+public:
+    constexpr static size_t capacity = 16;
+
+    // Returns a handle for later updates, or 0 when the stack is full
+    uint32_t Push(const CameraModifier& modifier);
+    bool Remove(uint32_t id);
+    void RemoveLayer(ModifierLayer layer);
+    // nullptr when the handle is gone; valid until the next Push/Remove
+    CameraModifier* Find(uint32_t id);
+    void Clear() {
+        count = 0;
+        hasLast = false;
+    }
+
+    bool IsEmpty() const { return count == 0; }
+    size_t GetCount() const { return count; }
+    const CameraModifier& operator[](size_t index) const { return modifiers[index]; }
+
+    // Applies every modifier to swivel in layer order. If the swivel is still
+    // what the last Compose wrote, the game didn't touch it and the previous
+    // input is used as the base, so additive layers never accumulate.
+    // Finished fades are dropped afterwards; returns false when nothing is left.
+    bool Compose(double time, CamRotator& swivel);
+
+private:
+    std::array<CameraModifier, capacity> modifiers{};
+    size_t count = 0;
+    uint32_t nextId = 1;
+
+    bool hasLast = false;
+    CamRotator lastInput;
+    CamRotator lastOutput;
+};
@@ -0,0 +1,191 @@
+#include "CameraPath.h"
+
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+namespace {
+    constexpr size_t fieldCount = 6;
+    constexpr uint8_t flagsBit = 1 << fieldCount;
+    constexpr size_t maxSampleBytes = 10 + 1 + fieldCount * 5 + 1;
+    constexpr float settingScale = 100.0f;
+    static_assert(std::tuple_size<decltype(CameraPathState::fields)>::value == fieldCount);
+
+    CameraPathState Quantize(const CameraPathSample& sample) {
+        CameraPathState state;
+        state.tick = sample.tick;
+        state.fields = {
+            sample.yaw,
+            sample.pitch,
+            static_cast<int32_t>(std::lround(sample.fov * settingScale)),
+            static_cast<int32_t>(std::lround(sample.distance * settingScale)),
+            static_cast<int32_t>(std::lround(sample.height * settingScale)),
+            static_cast<int32_t>(std::lround(sample.angle * settingScale)),
+        };
+        state.flags = sample.flags;
+        return state;
+    }
+
+    void WriteVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Returns false on a varint running past end or 10 bytes
+    bool ReadVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 70 && in < end; shift += 7) {
+            uint8_t byte = *in++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    uint64_t ZigZag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    int64_t UnZigZag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+}
+
+// ===========================
+//        Writer
+// ===========================
+
+CameraPathWriter::~CameraPathWriter() {
+    Close();
+}
+
+bool CameraPathWriter::Open(const std::filesystem::path& filepath, double tickRate) {
+    Close();
+    file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    CameraPathHeader header{ CameraPathMagic, CameraPathVersion, tickRate };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer.clear();
+    buffer.reserve(flushSize + maxSampleBytes);
+    previous = {};
+    sampleCount = 0;
+    byteCount = sizeof(header);
+    return static_cast<bool>(file);
+}
+
+void CameraPathWriter::Append(const CameraPathSample& sample) {
+    CameraPathState state = Quantize(sample);
+    WriteVarint(buffer, state.tick - previous.tick);
+
+    uint8_t changed = state.flags != previous.flags ? flagsBit : 0;
+    for (size_t i = 0; i < fieldCount; ++i) {
+        if (state.fields[i] != previous.fields[i]) changed |= static_cast<uint8_t>(1 << i);
+    }
+    buffer.push_back(changed);
+    for (size_t i = 0; i < fieldCount; ++i) {
+        if (changed >> i & 1) WriteVarint(buffer, ZigZag(static_cast<int64_t>(state.fields[i]) - previous.fields[i]));
+    }
+    if (changed & flagsBit) buffer.push_back(state.flags);
+
+    previous = state;
+    sampleCount++;
+    if (buffer.size() >= flushSize) Flush();
+}
+
+void CameraPathWriter::Flush() {
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    byteCount += buffer.size();
+    buffer.clear();
+}
+
+bool CameraPathWriter::Close() {
+    if (!file.is_open()) return false;
+    Flush();
+    bool ok = static_cast<bool>(file);
+    file.close();
+    return ok;
+}
+
+// ===========================
+//        Reader
+// ===========================
+
+bool CameraPathReader::Open(const std::filesystem::path& filepath) {
+    file.close();
+    file.clear();
+    previous = {};
+    position = end = 0;
+    fileDone = false;
+    error.clear();
+
+    file.open(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        error = "cannot open " + filepath.string();
+        return false;
+    }
+
+    CameraPathHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != CameraPathMagic) {
+        error = "not a CamChangePlus camera path";
+        return false;
+    }
+    if (header.version != CameraPathVersion) {
+        error = "unsupported camera path version " + std::to_string(header.version);
+        return false;
+    }
+    tickRate = header.tickRate;
+    buffer.resize(blockSize + maxSampleBytes);
+    return true;
+}
+
+void CameraPathReader::Refill() {
+    if (fileDone || end - position >= maxSampleBytes) return;
+
+    std::memmove(buffer.data(), buffer.data() + position, end - position);
+    end -= position;
+    position = 0;
+    file.read(reinterpret_cast<char*>(buffer.data() + end), static_cast<std::streamsize>(buffer.size() - end));
+    end += static_cast<size_t>(file.gcount());
+    if (!file) fileDone = true;
+}
+
+bool CameraPathReader::Next(CameraPathSample& sample) {
+    Refill();
+    if (position == end) return false;
+
+    const uint8_t* in = buffer.data() + position;
+    const uint8_t* last = buffer.data() + end;
+    uint64_t value;
+    CameraPathState state = previous;
+
+    bool ok = ReadVarint(in, last, value) && in < last;
+    if (ok) {
+        state.tick += value;
+        uint8_t changed = *in++;
+        for (size_t i = 0; ok && i < fieldCount; ++i) {
+            if (!(changed >> i & 1)) continue;
+            ok = ReadVarint(in, last, value);
+            state.fields[i] = static_cast<int32_t>(state.fields[i] + UnZigZag(value));
+        }
+        if (ok && (changed & flagsBit)) {
+            ok = in < last;
+            if (ok) state.flags = *in++;
+        }
+    }
+    if (!ok) {
+        error = "camera path is truncated";
+        position = end;
+        return false;
+    }
+
+    position = static_cast<size_t>(in - buffer.data());
+    previous = state;
+    sample.tick = state.tick;
+    sample.yaw = state.fields[0];
+    sample.pitch = state.fields[1];
+    sample.fov = state.fields[2] / settingScale;
+    sample.distance = state.fields[3] / settingScale;
+    sample.height = state.fields[4] / settingScale;
+    sample.angle = state.fields[5] / settingScale;
+    sample.flags = state.flags;
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "TraceRecorder.h"
+
+enum CameraPathFlags : uint8_t {
+    CameraPathFlag_BehindView = 1 << 0,
+    CameraPathFlag_BallCam    = 1 << 1,
+};
+
+// Camera state at one tick
+struct CameraPathSample {
+    uint64_t tick = 0;
+    int32_t yaw = 0;   // Swivel, rotation units
+    int32_t pitch = 0;
+    float fov = 90.0f; // Settings; stored in hundredths
+    float distance = 270.0f;
+    float height = 100.0f;
+    float angle = -4.0f;
+    uint8_t flags = 0; // CameraPathFlags
+};
+
+// On-disk header, the sample stream follows
+struct CameraPathHeader {
+    uint32_t magic;
+    uint32_t version;
+    double tickRate;
+};
+static_assert(sizeof(CameraPathHeader) == 16, "CameraPathHeader must stay 16 bytes");
+
+constexpr uint32_t CameraPathMagic = 0x43504343; // "CCPC"
+constexpr uint32_t CameraPathVersion = 1;
+
+// Sample stream: each sample is the tick delta as a varint, a byte with a
+// bit per field that changed, then each changed field as a zigzag varint
+// delta (flags as the raw byte). A camera holding still costs two bytes a
+// tick. Deltas are against the previous sample, starting from all zeros.
+struct CameraPathState {
+    uint64_t tick = 0;
+    std::array<int32_t, 6> fields{}; // yaw, pitch, then the settings in hundredths
+    uint8_t flags = 0;
+};
+
+// Writes samples to a file through a memory buffer flushed in large
+// blocks, so baking never waits on a write per tick
+class CameraPathWriter {
+public:
+    CameraPathWriter() = default;
+    ~CameraPathWriter();
+    CameraPathWriter(const CameraPathWriter&) = delete;
+    CameraPathWriter& operator=(const CameraPathWriter&) = delete;
+
+    bool Open(const std::filesystem::path& filepath, double tickRate = TraceTickRate);
+    void Append(const CameraPathSample& sample);
+    bool Close();
+    bool IsOpen() const { return file.is_open(); }
+
+    uint64_t GetSampleCount() const { return sampleCount; }
+    uint64_t GetByteCount() const { return byteCount; }
+
+    constexpr static size_t flushSize = 64 * 1024;
+
+private:
+    void Flush();
+
+    std::ofstream file;
+    std::vector<uint8_t> buffer;
+    CameraPathState previous;
+    uint64_t sampleCount = 0;
+    uint64_t byteCount = 0;
+};
+
+// Reads a camera path back one sample at a time, holding only a block of
+// the file in memory
+class CameraPathReader {
+public:
+    bool Open(const std::filesystem::path& filepath);
+    // False at the end of the stream, or on a corrupt one (see GetError)
+    bool Next(CameraPathSample& sample);
+
+    double GetTickRate() const { return tickRate; }
+    const std::string& GetError() const { return error; }
+
+    constexpr static size_t blockSize = 64 * 1024;
+
+private:
+    // Keeps at least one whole sample ahead of position unless the file ends
+    void Refill();
+
+    std::ifstream file;
+    std::vector<uint8_t> buffer;
+    size_t position = 0;
+    size_t end = 0;
+    bool fileDone = false;
+    CameraPathState previous;
+    double tickRate = TraceTickRate;
+    std::string error;
+};
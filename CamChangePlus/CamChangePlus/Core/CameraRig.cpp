@@ -0,0 +1,164 @@
+#include "CameraRig.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr const char* channelNames[] = { "Yaw", "Pitch", "FOV", "Distance", "Height", "Angle" };
+    static_assert(sizeof(channelNames) / sizeof(channelNames[0]) == RigChannelCount);
+
+    // Keys behind the cursor are only trimmed once this many pile up
+    constexpr size_t trimThreshold = 16;
+}
+
+const char* GetRigChannelName(RigChannel channel) {
+    size_t index = static_cast<size_t>(channel);
+    return index < RigChannelCount ? channelNames[index] : "";
+}
+
+// ===========================
+//        Keyframe Track
+// ===========================
+
+void KeyframeTrack::AddKey(float time, float value) {
+    AddKey(time, value, 0.0f);
+}
+
+void KeyframeTrack::AddKey(float time, float value, float tangent) {
+    // Later keys are replaced by an earlier one; the newest key wins
+    while (!times.empty() && times.back() > time) {
+        times.pop_back();
+        values.pop_back();
+        tangents.pop_back();
+    }
+
+    if (!times.empty() && times.back() == time) {
+        values.back() = value;
+        tangents.back() = tangent;
+    }
+    else {
+        times.push_back(time);
+        values.push_back(value);
+        tangents.push_back(tangent);
+    }
+
+    if (mode == SplineMode::CatmullRom) {
+        // The previous last key now has a neighbour on both sides
+        if (times.size() >= 2) UpdateCatmullRomTangent(times.size() - 2);
+        UpdateCatmullRomTangent(times.size() - 1);
+    }
+}
+
+void KeyframeTrack::UpdateCatmullRomTangent(size_t key) {
+    // End keys get a flat tangent so the camera eases out of and into rest
+    if (key == 0 || key + 1 >= times.size()) {
+        tangents[key] = 0.0f;
+        return;
+    }
+    float span = times[key + 1] - times[key - 1];
+    tangents[key] = span > 0.0f ? (values[key + 1] - values[key - 1]) / span : 0.0f;
+}
+
+size_t KeyframeTrack::DropBefore(float time) {
+    // Keep the last key at or before time; it starts the segment being played
+    auto firstAfter = std::upper_bound(times.begin(), times.end(), time);
+    size_t dropped = firstAfter == times.begin() ? 0 : static_cast<size_t>(firstAfter - times.begin()) - 1;
+    if (dropped == 0) return 0;
+
+    times.erase(times.begin(), times.begin() + dropped);
+    values.erase(values.begin(), values.begin() + dropped);
+    tangents.erase(tangents.begin(), tangents.begin() + dropped);
+    return dropped;
+}
+
+void KeyframeTrack::Clear() {
+    times.clear();
+    values.clear();
+    tangents.clear();
+}
+
+float KeyframeTrack::Evaluate(float time, size_t& cursor) const {
+    size_t count = times.size();
+    if (count == 0) return 0.0f;
+    if (time <= times.front()) return values.front();
+    if (time >= times.back()) {
+        cursor = count - 1;
+        return values.back();
+    }
+
+    // Segment [cursor, cursor + 1] contains time; walk forward from the last
+    // lookup and only search when time went backwards
+    if (cursor + 1 >= count || time < times[cursor]) {
+        cursor = static_cast<size_t>(std::upper_bound(times.begin(), times.end(), time) - times.begin()) - 1;
+    }
+    while (time >= times[cursor + 1]) cursor++;
+
+    float t0 = times[cursor];
+    float span = times[cursor + 1] - t0;
+    float s = (time - t0) / span;
+    float s2 = s * s;
+    float s3 = s2 * s;
+
+    // Cubic Hermite basis
+    float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+    float h10 = s3 - 2.0f * s2 + s;
+    float h01 = -2.0f * s3 + 3.0f * s2;
+    float h11 = s3 - s2;
+    return h00 * values[cursor] + h10 * span * tangents[cursor] +
+        h01 * values[cursor + 1] + h11 * span * tangents[cursor + 1];
+}
+
+// ===========================
+//        Camera Rig
+// ===========================
+
+void CameraRig::Key(RigChannel channel, double time, float currentValue, float value, float duration, SplineMode mode) {
+    size_t index = static_cast<size_t>(channel);
+    KeyframeTrack& track = tracks[index];
+
+    if (!IsActive()) origin = time;
+    float local = LocalTime(time);
+    duration = std::max(duration, 0.0f);
+
+    if (!IsActive(channel)) {
+        track.Clear();
+        track.SetMode(mode);
+        track.AddKey(local, currentValue);
+        cursors[index] = 0;
+        activeMask |= 1u << index;
+    }
+    else if (track.GetEndTime() > local + duration) {
+        // Retargeted before the current path finished: restart from where it is now
+        float from = track.Evaluate(local, cursors[index]);
+        track.Clear();
+        track.SetMode(mode);
+        track.AddKey(local, from);
+        cursors[index] = 0;
+    }
+    else {
+        track.SetMode(mode);
+        // Holding the last key: start the move now, not from when it was reached
+        if (track.GetEndTime() < local) track.AddKey(local, track.Evaluate(local, cursors[index]));
+    }
+
+    track.AddKey(local + duration, value);
+}
+
+void CameraRig::Clear() {
+    for (auto& track : tracks) track.Clear();
+    cursors.fill(0);
+    activeMask = 0;
+}
+
+void CameraRig::Evaluate(double time, RigPose& pose) {
+    float local = LocalTime(time);
+    pose.activeMask = activeMask;
+
+    for (size_t i = 0; i < RigChannelCount; ++i) {
+        if (!((activeMask >> i) & 1u)) continue;
+
+        pose.values[i] = tracks[i].Evaluate(local, cursors[i]);
+        if (cursors[i] >= trimThreshold) {
+            cursors[i] -= tracks[i].DropBefore(local);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ===========================
+//        Keyframe Track
+// ===========================
+
+enum class SplineMode : uint8_t {
+    CatmullRom, // Tangents from the neighbouring keys; passes smoothly through every key
+    Hermite     // Tangents given per key (0 settles on each key)
+};
+
+// One animated float. Keys live in parallel arrays (times, values, tangents)
+// so a lookup only walks the time column. Evaluation takes a cursor owned by
+// the caller: playback moving forward costs O(1) amortized, and a jump
+// backwards falls back to a binary search.
+class KeyframeTrack {
+public:
+    void SetMode(SplineMode splineMode) { mode = splineMode; }
+    SplineMode GetMode() const { return mode; }
+
+    // Keys are appended in time order; a key at or before the last one
+    // replaces every key from that time on
+    void AddKey(float time, float value);
+    void AddKey(float time, float value, float tangent);
+    // Drops keys no longer needed to evaluate at or after time; returns how
+    // many were dropped so cursors can be shifted
+    size_t DropBefore(float time);
+    void Clear();
+
+    bool IsEmpty() const { return times.empty(); }
+    size_t GetKeyCount() const { return times.size(); }
+    float GetStartTime() const { return times.empty() ? 0.0f : times.front(); }
+    float GetEndTime() const { return times.empty() ? 0.0f : times.back(); }
+
+    // Holds the first/last value outside the keyed range
+    float Evaluate(float time, size_t& cursor) const;
+
+private:
+    void UpdateCatmullRomTangent(size_t key);
+
+    SplineMode mode = SplineMode::CatmullRom;
+    std::vector<float> times;
+    std::vector<float> values;
+    std::vector<float> tangents; // d(value)/d(time)
+};
+
+// ===========================
+//        Camera Rig
+// ===========================
+
+enum class RigChannel : uint8_t {
+    Yaw,      // Swivel, percent of CameraController::maxYaw
+    Pitch,    // Swivel, percent of CameraController::maxPitch
+    Fov,      // Camera settings, degrees
+    Distance, // Camera settings, unreal units
+    Height,   // Camera settings, unreal units
+    Angle,    // Camera settings, degrees
+    Count
+};
+
+constexpr size_t RigChannelCount = static_cast<size_t>(RigChannel::Count);
+
+const char* GetRigChannelName(RigChannel channel);
+
+struct RigPose {
+    std::array<float, RigChannelCount> values{};
+    uint32_t activeMask = 0; // Bit per channel that has keys
+
+    bool Has(RigChannel channel) const { return (activeMask >> static_cast<size_t>(channel)) & 1u; }
+};
+
+// Keyframe tracks for every controllable camera property, keyed live by the
+// sequence engine and evaluated once per camera frame. Times are seconds on
+// the host clock relative to the rig's origin.
+class CameraRig {
+public:
+    // Adds a key reaching value at time + duration. An idle channel is first
+    // seeded with currentValue at time so it starts from where the camera is.
+    void Key(RigChannel channel, double time, float currentValue, float value, float duration, SplineMode mode);
+    void Clear();
+
+    bool IsActive() const { return activeMask != 0; }
+    bool IsActive(RigChannel channel) const { return (activeMask >> static_cast<size_t>(channel)) & 1u; }
+    const KeyframeTrack& GetTrack(RigChannel channel) const { return tracks[static_cast<size_t>(channel)]; }
+
+    // Also trims keys that are fully in the past
+    void Evaluate(double time, RigPose& pose);
+
+private:
+    float LocalTime(double time) const { return static_cast<float>(time - origin); }
+
+    std::array<KeyframeTrack, RigChannelCount> tracks;
+    std::array<size_t, RigChannelCount> cursors{};
+    uint32_t activeMask = 0;
+    double origin = 0.0; // Track time 0; kept near now so floats stay precise
+};
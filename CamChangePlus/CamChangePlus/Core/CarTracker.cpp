@@ -0,0 +1,115 @@
+#include "CarTracker.h"
+
+#include "Profiler.h"
+#include "SimdF4.h"
+
+void CarTracker::Reset() {
+    present = 0;
+    departed = 0;
+    eventCount = 0;
+}
+
+void CarTracker::Emit(GameEvent event, size_t lane) {
+    events[eventCount++] = { event, handles[lane], teams[lane] };
+}
+
+void CarTracker::Update(const MatchCar* cars, size_t count, float dt) {
+    CCP_TRACE_SCOPE("CarTracker::Update");
+    eventCount = 0;
+
+    // Match cars to the lanes they had; the rest wait for a free lane
+    uint8_t matched = 0;
+    size_t pending[capacity];
+    size_t pendingCount = 0;
+    for (size_t i = 0; i < count && i < capacity; ++i) {
+        size_t lane = 0;
+        while (lane < capacity && !((present & ~matched) >> lane & 1 && handles[lane] == cars[i].handle)) lane++;
+        if (lane == capacity) {
+            pending[pendingCount++] = i;
+            continue;
+        }
+        matched |= static_cast<uint8_t>(1 << lane);
+        positionZ[lane] = cars[i].state.location.Z;
+        velocityZ[lane] = cars[i].state.velocity.Z;
+        grounded[lane] = cars[i].state.onGround ? 1.0f : 0.0f;
+        teams[lane] = cars[i].team;
+    }
+
+    // Cars that were here last update and aren't any more; their lanes are
+    // reused last so the team of a car the demolition hook reports on the
+    // same tick can still be looked up
+    departed = present & ~matched;
+    uint8_t fresh = 0;
+    for (size_t p = 0; p < pendingCount; ++p) {
+        size_t lane = 0;
+        while (lane < capacity && (matched | fresh | departed) >> lane & 1) lane++;
+        if (lane == capacity) {
+            lane = 0;
+            while ((matched | fresh) >> lane & 1) lane++;
+            departed &= static_cast<uint8_t>(~(1 << lane));
+        }
+        const MatchCar& car = cars[pending[p]];
+        fresh |= static_cast<uint8_t>(1 << lane);
+        handles[lane] = car.handle;
+        teams[lane] = car.team;
+        positionZ[lane] = car.state.location.Z;
+        velocityZ[lane] = car.state.velocity.Z;
+        grounded[lane] = car.state.onGround ? 1.0f : 0.0f;
+        wasGrounded[lane] = grounded[lane];
+        wasAerial[lane] = 0.0f;
+        airTime[lane] = 0.0f;
+    }
+    present = matched | fresh;
+
+    // One pass over every lane; empty lanes compute garbage that the
+    // matched mask drops
+    const F4 half = Splat(0.5f);
+    const F4 zero = Splat(0.0f);
+    const F4 one = Splat(1.0f);
+    const F4 step = Splat(dt);
+    const F4 jumpSpeed = Splat(options.jumpSpeed);
+    const F4 landingAirTime = Splat(options.landingAirTime);
+    const F4 aerialHeight = Splat(options.aerialHeight);
+
+    int jumped = 0, landed = 0, aerial = 0;
+    for (size_t block = 0; block < capacity; block += 4) {
+        F4 onGround = Less(half, Load(grounded + block));
+        F4 wasOnGround = Less(half, Load(wasGrounded + block));
+        F4 inAir = Less(Load(grounded + block), half);
+        F4 air = Load(airTime + block);
+
+        F4 jump = And(And(wasOnGround, inAir), Less(jumpSpeed, Load(velocityZ + block)));
+        F4 land = And(AndNot(wasOnGround, onGround), Less(landingAirTime, air + Splat(1e-4f)));
+        F4 high = And(inAir, Less(aerialHeight, Load(positionZ + block) + Splat(1e-4f)));
+        F4 aerialEdge = AndNot(Less(half, Load(wasAerial + block)), high);
+
+        jumped |= MoveMask(jump) << block;
+        landed |= MoveMask(land) << block;
+        aerial |= MoveMask(aerialEdge) << block;
+
+        Store(airTime + block, Select(onGround, zero, air + step));
+        Store(wasGrounded + block, Load(grounded + block));
+        Store(wasAerial + block, Select(high, one, zero));
+    }
+
+    // Fresh lanes only primed this update
+    for (size_t lane = 0; lane < capacity; ++lane) {
+        if (!(matched >> lane & 1)) continue;
+        if (jumped >> lane & 1) Emit(GameEvent::Jump, lane);
+        if (landed >> lane & 1) Emit(GameEvent::Landing, lane);
+        if (aerial >> lane & 1) Emit(GameEvent::AerialStart, lane);
+    }
+}
+
+int CarTracker::FindTeam(CarHandle car) const {
+    for (size_t lane = 0; lane < capacity; ++lane) {
+        if (((present | departed) >> lane & 1) && handles[lane] == car) return teams[lane];
+    }
+    return -1;
+}
+
+size_t CarTracker::GetCarCount() const {
+    size_t count = 0;
+    for (size_t lane = 0; lane < capacity; ++lane) count += present >> lane & 1;
+    return count;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "CamHost.h"
+#include "GameEvents.h"
+
+struct CarTrackerOptions {
+    float jumpSpeed = 250.0f;     // Upward speed on leaving the ground that makes it a jump, not a roll-off
+    float landingAirTime = 0.25f; // Seconds airborne before touching down counts as a landing
+    float aerialHeight = 300.0f;
+};
+
+// An event one tracked car raised during the last update
+struct CarEvent {
+    GameEvent event;
+    CarHandle car;
+    uint8_t team;
+};
+
+// State of every car in the match in structure-of-arrays lanes, one lane per
+// car, stepped four lanes at a time with SSE2 (scalar fallback elsewhere).
+// Jump, landing and aerial edges come out of the same few vector ops
+// whatever the car count. Cars keep their lane across updates by handle; a
+// car's first update only primes its lane. A lane whose car vanished raises
+// nothing: cars leave and respawn under new handles as well as get
+// demolished, so demolitions come from the caller-aware hook instead.
+class CarTracker {
+public:
+    constexpr static size_t capacity = 8; // 4v4
+    constexpr static EventMask trackedEvents = EventBit(GameEvent::Jump) | EventBit(GameEvent::Landing) |
+        EventBit(GameEvent::AerialStart);
+
+    explicit CarTracker(CarTrackerOptions options = {}) : options(options) {
+    }
+
+    // dt: seconds since the previous update. Cars past capacity are ignored.
+    void Update(const MatchCar* cars, size_t count, float dt);
+    void Reset();
+
+    // Events of the last update, in lane order
+    const CarEvent* GetEvents() const { return events.data(); }
+    size_t GetEventCount() const { return eventCount; }
+
+    // Team of a car tracked, or gone since the last update; -1 otherwise
+    int FindTeam(CarHandle car) const;
+    size_t GetCarCount() const;
+
+    const CarTrackerOptions& GetOptions() const { return options; }
+
+private:
+    void Emit(GameEvent event, size_t lane);
+
+    CarTrackerOptions options;
+
+    // Lanes; grounded/aerial hold 1.0f or 0.0f so they load straight into vectors
+    alignas(16) float positionZ[capacity]{};
+    alignas(16) float velocityZ[capacity]{};
+    alignas(16) float grounded[capacity]{};
+    alignas(16) float wasGrounded[capacity]{};
+    alignas(16) float wasAerial[capacity]{};
+    alignas(16) float airTime[capacity]{}; // Seconds airborne up to the previous update
+
+    std::array<CarHandle, capacity> handles{};
+    std::array<uint8_t, capacity> teams{};
+    uint8_t present = 0;  // Lane holds a car
+    uint8_t departed = 0; // Lane's car vanished in the last update
+
+    std::array<CarEvent, capacity * 4> events{};
+    size_t eventCount = 0;
+};
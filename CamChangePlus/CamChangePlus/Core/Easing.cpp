@@ -0,0 +1,69 @@
+#include "Easing.h"
+
+#include <array>
+#include <cmath>
+
+namespace {
+    constexpr const char* curveNames[] = { "Linear", "Ease In/Out", "Cubic", "Spring" };
+    static_assert(sizeof(curveNames) / sizeof(curveNames[0]) == EaseCurveCount);
+
+    constexpr int lutSegments = 256;
+    using CurveTable = std::array<float, lutSegments + 1>;
+
+    float SampleCurve(EaseCurve curve, float t) {
+        switch (curve) {
+        case EaseCurve::EaseInOut:
+            return t * t * (3.0f - 2.0f * t);
+        case EaseCurve::Cubic:
+            // Cubic ease-out: fast start, gentle landing
+            return 1.0f - (1.0f - t) * (1.0f - t) * (1.0f - t);
+        case EaseCurve::Spring: {
+            // Underdamped spring released at t = 0; ~1.5 wobbles, settled by t = 1
+            constexpr float damping = 6.0f;
+            constexpr float frequency = 3.0f * 3.14159265f;
+            return 1.0f - std::exp(-damping * t) * std::cos(frequency * t);
+        }
+        default:
+            return t;
+        }
+    }
+
+    const std::array<CurveTable, EaseCurveCount>& Tables() {
+        static const std::array<CurveTable, EaseCurveCount> tables = []() {
+            std::array<CurveTable, EaseCurveCount> built{};
+            for (size_t curve = 0; curve < EaseCurveCount; ++curve) {
+                for (int i = 0; i <= lutSegments; ++i) {
+                    built[curve][i] = SampleCurve(static_cast<EaseCurve>(curve), static_cast<float>(i) / lutSegments);
+                }
+                // Every curve ends exactly on the target
+                built[curve][0] = 0.0f;
+                built[curve][lutSegments] = 1.0f;
+            }
+            return built;
+        }();
+        return tables;
+    }
+}
+
+const char* GetEaseCurveName(EaseCurve curve) {
+    size_t index = static_cast<size_t>(curve);
+    return index < EaseCurveCount ? curveNames[index] : "";
+}
+
+EaseCurve FindEaseCurveByName(std::string_view name) {
+    for (size_t i = 0; i < EaseCurveCount; ++i) {
+        if (name == curveNames[i]) return static_cast<EaseCurve>(i);
+    }
+    return EaseCurve::Linear;
+}
+
+float EvaluateEase(EaseCurve curve, float t) {
+    if (!(t > 0.0f)) return 0.0f;
+    if (t >= 1.0f) return 1.0f;
+
+    const CurveTable& table = Tables()[static_cast<size_t>(curve) < EaseCurveCount ? static_cast<size_t>(curve) : 0];
+    float position = t * lutSegments;
+    int index = static_cast<int>(position);
+    float fraction = position - index;
+    return table[index] + (table[index + 1] - table[index]) * fraction;
+}
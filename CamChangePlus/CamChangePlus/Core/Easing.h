@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Shapes for timed camera transitions. Each curve maps 0..1 progress to
+// 0..1 of the way from the start value to the target (Spring overshoots).
+enum class EaseCurve : uint8_t {
+    Linear,
+    EaseInOut,
+    Cubic,
+    Spring,
+    Count
+};
+
+constexpr size_t EaseCurveCount = static_cast<size_t>(EaseCurve::Count);
+
+const char* GetEaseCurveName(EaseCurve curve);
+// Unknown names fall back to Linear
+EaseCurve FindEaseCurveByName(std::string_view name);
+
+// Looks the curve up in a table built once on first use, so calling this
+// every frame never allocates or touches transcendental math.
+float EvaluateEase(EaseCurve curve, float t);
@@ -0,0 +1,50 @@
+#include "EventDetector.h"
+
+namespace {
+    constexpr float boostEpsilon = 0.001f;
+
+    // bool -> event bit without a branch
+    inline EventMask Bit(GameEvent event, bool set) {
+        return static_cast<EventMask>(set) << static_cast<size_t>(event);
+    }
+}
+
+EventMask EventDetector::Scan(const WorldSnapshot& snapshot) {
+    const CarState& car = snapshot.car;
+    const BallState& ball = snapshot.ball;
+    double time = snapshot.time;
+
+    bool onGround = car.onGround;
+    bool landed = onGround & (time - lastGroundedTime >= options.landingAirTime);
+
+    float ballSpeedSquared = ball.velocity.X * ball.velocity.X + ball.velocity.Y * ball.velocity.Y + ball.velocity.Z * ball.velocity.Z;
+    float fastOn = options.ballSpeed * options.ballSpeed;
+    float fastOff = fastOn * options.release * options.release;
+    bool wasFast = (level & EventBit(GameEvent::BallFast)) != 0;
+    bool wasHigh = (level & EventBit(GameEvent::BallHigh)) != 0;
+
+    EventMask next =
+        Bit(GameEvent::Landing, landed) |
+        Bit(GameEvent::WallContact, onGround & car.onWall) |
+        Bit(GameEvent::AerialStart, !onGround & (car.location.Z >= options.aerialHeight)) |
+        Bit(GameEvent::BoostEmpty, car.boost <= boostEpsilon) |
+        Bit(GameEvent::BoostFull, car.boost >= 1.0f - boostEpsilon) |
+        Bit(GameEvent::Supersonic, car.supersonic) |
+        Bit(GameEvent::BallFast, (ballSpeedSquared >= fastOn) | (wasFast & (ballSpeedSquared >= fastOff))) |
+        Bit(GameEvent::BallHigh, (ball.location.Z >= options.ballHeight) | (wasHigh & (ball.location.Z >= options.ballHeight * options.release)));
+
+    // Sources missing this tick keep their previous bits
+    EventMask valid = (snapshot.hasCar ? carEvents : 0) | (snapshot.hasBall ? ballEvents : 0);
+    next = (next & valid) | (level & ~valid);
+
+    bool gap = time - lastScanTime > options.maxGap;
+    EventMask fired = primed && !gap ? next & ~level : 0;
+
+    // Grounded time only advances while the car is actually there
+    lastGroundedTime = snapshot.hasCar & onGround ? time : lastGroundedTime;
+    if (!primed || gap) lastGroundedTime = time;
+    lastScanTime = time;
+    level = next;
+    primed = true;
+    return fired;
+}
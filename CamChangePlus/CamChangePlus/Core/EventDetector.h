@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+#include "CamHost.h"
+#include "GameEvents.h"
+
+// Car and ball state read once per tick and shared by every detector
+struct WorldSnapshot {
+    double time = 0.0;
+    bool hasCar = false;
+    CarState car;
+    bool hasBall = false;
+    BallState ball;
+};
+
+struct EventDetectorOptions {
+    float landingAirTime = 0.25f; // Seconds off the ground before touching down counts as a landing
+    float aerialHeight = 300.0f;  // Car height that turns being airborne into an aerial
+    float ballSpeed = 2500.0f;    // Ball Fast threshold (uu/s)
+    float ballHeight = 1000.0f;   // Ball High threshold (uu)
+    float release = 0.9f;         // Thresholds release at this fraction, so they don't flicker
+    float maxGap = 0.5f;          // Longer gaps between scans (menus, pauses) re-prime instead of firing
+};
+
+// Tick events as state machines over one snapshot. Every detector reduces
+// to a level bit (on the ground after a long enough flight, boost at 0,
+// ball above its threshold with hysteresis, ...), and an event is the rising
+// edge of its bit: fired = level & ~previous. Bits whose source is missing
+// this tick (no car, no ball) hold their previous value, so respawns and
+// goal resets don't produce edges.
+class EventDetector {
+public:
+    explicit EventDetector(EventDetectorOptions options = {}) : options(options) {
+    }
+
+    // Events that started this tick; the first scan (or the first after a
+    // gap) only primes the state and returns 0
+    EventMask Scan(const WorldSnapshot& snapshot);
+    void Reset() { primed = false; }
+
+    // Level bits after the last scan, e.g. "currently supersonic"
+    EventMask GetActive() const { return level; }
+
+    const EventDetectorOptions& GetOptions() const { return options; }
+    void SetOptions(const EventDetectorOptions& newOptions) { options = newOptions; }
+
+    constexpr static EventMask carEvents = EventBit(GameEvent::Landing) | EventBit(GameEvent::WallContact) |
+        EventBit(GameEvent::AerialStart) | EventBit(GameEvent::BoostEmpty) | EventBit(GameEvent::BoostFull) |
+        EventBit(GameEvent::Supersonic);
+    constexpr static EventMask ballEvents = EventBit(GameEvent::BallFast) | EventBit(GameEvent::BallHigh);
+
+private:
+    EventDetectorOptions options;
+    bool primed = false;
+    double lastScanTime = 0.0;
+    double lastGroundedTime = 0.0;
+    EventMask level = 0;
+};
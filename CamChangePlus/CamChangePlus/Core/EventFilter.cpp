@@ -0,0 +1,86 @@
+#include "EventFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "TraceRecorder.h"
+
+namespace {
+    struct DefaultPolicy {
+        GameEvent event;
+        EventPolicy policy;
+    };
+
+    // Events not listed pass straight through
+    constexpr DefaultPolicy defaultPolicies[] = {
+        { GameEvent::BallTouch,   { 0.2f,  DebounceEdge::Leading, false } }, // One touch raises OnHitBall several times
+        { GameEvent::Jump,        { 0.2f,  DebounceEdge::Leading, false } },
+        { GameEvent::DoubleJump,  { 0.2f,  DebounceEdge::Leading, false } },
+        { GameEvent::Flip,        { 0.25f, DebounceEdge::Leading, true } },  // Dodge spam while mashing
+        { GameEvent::Landing,     { 0.25f, DebounceEdge::Leading, false } },
+        { GameEvent::WallContact, { 0.5f,  DebounceEdge::Leading, true } },  // Wheels flicker on and off the wall
+        { GameEvent::Supersonic,  { 0.5f,  DebounceEdge::Leading, true } },  // Flickers around the speed threshold
+    };
+}
+
+EventFilter::EventFilter() {
+    for (const auto& entry : defaultPolicies) SetPolicy(entry.event, entry.policy);
+}
+
+void EventFilter::SetPolicy(GameEvent event, const EventPolicy& policy) {
+    size_t index = Index(event);
+    policies[index] = policy;
+    cooldownTicks[index] = static_cast<uint64_t>(std::lround(std::max(policy.cooldown, 0.0f) * TraceTickRate));
+    windows[index] = {};
+}
+
+EventFilter::Verdict EventFilter::Offer(GameEvent event, uint64_t tick) {
+    size_t index = Index(event);
+    EventFilterStats& stat = stats[index];
+    uint64_t cooldown = cooldownTicks[index];
+    if (cooldown == 0) {
+        stat.passed++;
+        return Verdict::Pass;
+    }
+
+    Window& window = windows[index];
+    if (policies[index].edge == DebounceEdge::Trailing) {
+        if (!window.open) {
+            window = { tick, tick, 1, true };
+            return Verdict::Defer;
+        }
+        window.last = tick;
+        window.count++;
+        stat.suppressed++;
+        return Verdict::Suppress;
+    }
+
+    uint64_t anchor = policies[index].coalesce ? window.last : window.start;
+    if (!window.open || tick - anchor >= cooldown) {
+        if (window.open) stat.lastBurst = window.count;
+        window = { tick, tick, 1, true };
+        stat.passed++;
+        return Verdict::Pass;
+    }
+    window.last = tick;
+    window.count++;
+    stat.suppressed++;
+    return Verdict::Suppress;
+}
+
+uint64_t EventFilter::GetDeadline(GameEvent event) const {
+    size_t index = Index(event);
+    const Window& window = windows[index];
+    return (policies[index].coalesce ? window.last : window.start) + cooldownTicks[index];
+}
+
+uint32_t EventFilter::Close(GameEvent event, uint64_t tick) {
+    size_t index = Index(event);
+    Window& window = windows[index];
+    if (!window.open || tick < GetDeadline(event)) return 0;
+
+    window.open = false;
+    stats[index].passed++;
+    stats[index].lastBurst = window.count;
+    return window.count;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "GameEvents.h"
+
+enum class DebounceEdge : uint8_t {
+    Leading, // Pass the first event of a burst right away
+    Trailing // Pass one event once the burst has gone quiet
+};
+
+// How one event type is debounced; a cooldown of 0 passes everything
+struct EventPolicy {
+    float cooldown = 0.0f; // Seconds
+    DebounceEdge edge = DebounceEdge::Leading;
+    // The window restarts on every suppressed occurrence, so a burst of any
+    // length yields one event; otherwise it runs from the burst's first event
+    bool coalesce = false;
+};
+
+struct EventFilterStats {
+    uint64_t passed = 0;
+    uint64_t suppressed = 0;
+    uint32_t lastBurst = 0; // Occurrences folded into the last closed burst
+};
+
+// Debounce stage every raised event goes through before sequence matching.
+// Policies live in one table indexed by event; time is in trace ticks so the
+// same input gives the same output live and in replays.
+class EventFilter {
+public:
+    enum class Verdict : uint8_t {
+        Pass,     // Dispatch now
+        Suppress, // Folded into a burst
+        Defer     // Trailing edge: dispatch when Close() reports the burst over
+    };
+
+    EventFilter();
+
+    Verdict Offer(GameEvent event, uint64_t tick);
+    // Trailing edge: burst size once its window has closed at tick, 0 while
+    // it is still open (try again at GetDeadline)
+    uint32_t Close(GameEvent event, uint64_t tick);
+    bool IsOpen(GameEvent event) const { return windows[Index(event)].open; }
+    uint64_t GetDeadline(GameEvent event) const;
+
+    const EventPolicy& GetPolicy(GameEvent event) const { return policies[Index(event)]; }
+    void SetPolicy(GameEvent event, const EventPolicy& policy);
+    const EventFilterStats& GetStats(GameEvent event) const { return stats[Index(event)]; }
+    void ResetStats() { stats = {}; }
+    // Forgets bursts in progress, e.g. after a replay seek
+    void ResetWindows() { windows = {}; }
+
+private:
+    struct Window {
+        uint64_t start = 0;
+        uint64_t last = 0;
+        uint32_t count = 0;
+        bool open = false;
+    };
+
+    static size_t Index(GameEvent event) { return static_cast<size_t>(event) < GameEventCount ? static_cast<size_t>(event) : 0; }
+
+    std::array<EventPolicy, GameEventCount> policies{};
+    std::array<uint64_t, GameEventCount> cooldownTicks{};
+    std::array<Window, GameEventCount> windows{};
+    std::array<EventFilterStats, GameEventCount> stats{};
+};
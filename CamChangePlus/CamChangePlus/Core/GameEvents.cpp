@@ -0,0 +1,58 @@
+#include "GameEvents.h"
+
+namespace {
+    constexpr GameEventInfo eventCatalog[GameEventCount] = {
+        { GameEvent::BallTouch,  "Ball Touch",  EventSource::CarHook, "Function TAGame.Car_TA.OnHitBall" },
+        { GameEvent::Explosion,  "Explosion",   EventSource::Hook,    "Function TAGame.GameEvent_Soccar_TA.EventGoalScored" },
+        { GameEvent::Jump,       "Jump",        EventSource::CarHook, "Function TAGame.Car_TA.OnJumpPressed" },
+        { GameEvent::DoubleJump, "Double Jump", EventSource::CarHook, "Function CarComponent_DoubleJump_TA.Active.BeginState" },
+        { GameEvent::Flip,       "Flip",        EventSource::CarHook, "Function TAGame.CarComponent_Dodge_TA.EventActivateDodge" },
+        { GameEvent::PredictedWallHit,     "Predicted Wall Hit",     EventSource::Predicted, "" },
+        { GameEvent::PredictedGoalLine,    "Predicted Goal Line",    EventSource::Predicted, "" },
+        { GameEvent::PredictedFloorBounce, "Predicted Floor Bounce", EventSource::Predicted, "" },
+        { GameEvent::Landing,     "Landing",      EventSource::Tick, "" },
+        { GameEvent::WallContact, "Wall Contact", EventSource::Tick, "" },
+        { GameEvent::AerialStart, "Aerial Start", EventSource::Tick, "" },
+        { GameEvent::BoostEmpty,  "Boost Empty",  EventSource::Tick, "" },
+        { GameEvent::BoostFull,   "Boost Full",   EventSource::Tick, "" },
+        { GameEvent::Supersonic,  "Supersonic",   EventSource::Tick, "" },
+        { GameEvent::BallFast,    "Ball Fast",    EventSource::Tick, "" },
+        { GameEvent::BallHigh,    "Ball High",    EventSource::Tick, "" },
+        { GameEvent::Demolition,   "Demolition",    EventSource::CarHook, "Function TAGame.Car_TA.EventDemolished" },
+        { GameEvent::KickoffStart, "Kickoff Start", EventSource::Hook,    "Function GameEvent_Soccar_TA.Countdown.BeginState" },
+    };
+
+    constexpr GameEventInfo invalidEvent = { GameEvent::Invalid, "", EventSource::Hook, "" };
+}
+
+const GameEventInfo& GetEventInfo(GameEvent event) {
+    size_t index = static_cast<size_t>(event);
+    return index < GameEventCount ? eventCatalog[index] : invalidEvent;
+}
+
+const char* GetEventName(GameEvent event) {
+    return GetEventInfo(event).name;
+}
+
+GameEvent FindEventByName(std::string_view name) {
+    for (const auto& info : eventCatalog) {
+        if (name == info.name) return info.id;
+    }
+    return GameEvent::Invalid;
+}
+
+bool IsPredictedEvent(GameEvent event) {
+    return GetEventInfo(event).source == EventSource::Predicted && event != GameEvent::Invalid;
+}
+
+bool IsTickEvent(GameEvent event) {
+    return GetEventInfo(event).source == EventSource::Tick && event != GameEvent::Invalid;
+}
+
+bool IsCarEvent(GameEvent event) {
+    switch (GetEventInfo(event).source) {
+    case EventSource::CarHook: return event != GameEvent::Invalid;
+    case EventSource::Tick:    return event != GameEvent::BallFast && event != GameEvent::BallHigh;
+    default:                   return false;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+// Events a sequence step can wait for. The numeric ids are what the engine
+// compares at runtime; the display names are what the shot library stores.
+enum class GameEvent : uint8_t {
+    BallTouch,
+    Explosion,
+    Jump,
+    DoubleJump,
+    Flip,
+    // Raised by the ball predictor ahead of time rather than by a game hook
+    PredictedWallHit,
+    PredictedGoalLine,
+    PredictedFloorBounce,
+    // Edges found by the per-tick scan of car and ball state
+    Landing,
+    WallContact,
+    AerialStart,
+    BoostEmpty,
+    BoostFull,
+    Supersonic,
+    BallFast,
+    BallHigh,
+    // Hooked like the first five
+    Demolition,
+    KickoffStart,
+    Count,
+    Invalid = 0xFF
+};
+
+constexpr size_t GameEventCount = static_cast<size_t>(GameEvent::Count);
+
+// Where an event comes from
+enum class EventSource : uint8_t {
+    Hook,      // A game function hook
+    CarHook,   // A game function hook that runs once per car; filtered by caller
+    Tick,      // The per-tick snapshot scan (EventDetector)
+    Predicted  // The ball predictor, ahead of time
+};
+
+// One bit per GameEvent
+using EventMask = uint32_t;
+static_assert(GameEventCount <= 32, "EventMask needs more bits");
+
+constexpr EventMask EventBit(GameEvent event) {
+    return EventMask(1) << static_cast<size_t>(event);
+}
+
+struct GameEventInfo {
+    GameEvent id;
+    const char* name;      // Name used in the GUI and in CamChangePlus_shots.json
+    EventSource source;
+    const char* hookName;  // Game function that raises the event; "" for tick and predicted events
+};
+
+const GameEventInfo& GetEventInfo(GameEvent event);
+const char* GetEventName(GameEvent event);
+GameEvent FindEventByName(std::string_view name);
+bool IsPredictedEvent(GameEvent event);
+bool IsTickEvent(GameEvent event);
+// Raised by one particular car (touches, jumps, car detectors), so a step's
+// car binding applies to it
+bool IsCarEvent(GameEvent event);
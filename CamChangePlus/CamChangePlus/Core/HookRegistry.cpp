@@ -0,0 +1,91 @@
+#include "HookRegistry.h"
+
+void HookRegistry::Acquire(const std::string& hookName, std::function<void()> callback) {
+    Entry& entry = entries[hookName];
+    if (!entry.callback && !entry.carCallback) entry.callback = std::move(callback);
+    AddRef(hookName, entry);
+}
+
+void HookRegistry::Acquire(const std::string& hookName, std::function<void(CarHandle caller)> callback) {
+    Entry& entry = entries[hookName];
+    if (!entry.callback && !entry.carCallback) entry.carCallback = std::move(callback);
+    AddRef(hookName, entry);
+}
+
+void HookRegistry::AddRef(const std::string& hookName, Entry& entry) {
+    entry.refs++;
+    if (!entry.installed && !suspended) Install(hookName, entry);
+}
+
+void HookRegistry::Release(const std::string& hookName) {
+    auto it = entries.find(hookName);
+    if (it == entries.end() || it->second.refs == 0) return;
+
+    Entry& entry = it->second;
+    if (--entry.refs > 0 || !entry.installed || entry.unhookQueued) return;
+
+    entry.unhookQueued = true;
+    host.Execute([this, hookName]() { FlushUnhook(hookName); });
+}
+
+void HookRegistry::FlushUnhook(const std::string& hookName) {
+    auto it = entries.find(hookName);
+    if (it == entries.end()) return;
+
+    Entry& entry = it->second;
+    entry.unhookQueued = false;
+    // Re-acquired in the meantime, or already dropped by Suspend
+    if (entry.refs > 0 || !entry.installed) return;
+
+    host.UnhookEvent(hookName);
+    entry.installed = false;
+}
+
+void HookRegistry::Suspend() {
+    suspended = true;
+    for (auto& [hookName, entry] : entries) {
+        if (!entry.installed) continue;
+        host.UnhookEvent(hookName);
+        entry.installed = false;
+    }
+}
+
+void HookRegistry::Resume() {
+    suspended = false;
+    for (auto& [hookName, entry] : entries) {
+        if (entry.refs > 0 && !entry.installed) Install(hookName, entry);
+    }
+}
+
+void HookRegistry::Install(const std::string& hookName, Entry& entry) {
+    // Entries are never erased, so the pointer stays valid. Calls that land
+    // between the last Release and the deferred unhook are dropped.
+    Entry* installed = &entry;
+    if (entry.carCallback) {
+        host.HookEventWithCaller(hookName, [installed](CarHandle caller) {
+            if (installed->refs > 0) installed->carCallback(caller);
+            });
+    }
+    else {
+        host.HookEvent(hookName, [installed]() {
+            if (installed->refs > 0) installed->callback();
+            });
+    }
+    entry.installed = true;
+}
+
+size_t HookRegistry::GetRefCount(const std::string& hookName) const {
+    auto it = entries.find(hookName);
+    return it != entries.end() ? it->second.refs : 0;
+}
+
+bool HookRegistry::IsInstalled(const std::string& hookName) const {
+    auto it = entries.find(hookName);
+    return it != entries.end() && it->second.installed;
+}
+
+size_t HookRegistry::GetInstalledCount() const {
+    size_t count = 0;
+    for (const auto& [hookName, entry] : entries) count += entry.installed ? 1 : 0;
+    return count;
+}
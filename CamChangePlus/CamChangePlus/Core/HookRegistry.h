@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+#include "CamHost.h"
+
+// Reference-counted game hooks. A hook is installed on its first Acquire and
+// removed once the last subscriber releases it, so nothing runs for events
+// no armed sequence is waiting on.
+//
+// The unhook is deferred through Execute: the last Release usually happens
+// inside the hook's own callback (a final step matching), and the hook must
+// not be torn down while it is running. Acquiring again before the deferred
+// unhook runs simply keeps the hook.
+class HookRegistry {
+public:
+    explicit HookRegistry(CamHost& host) : host(host) {
+    }
+
+    // The first callback given for a name is kept for good, so a running
+    // callback is never replaced underneath itself
+    void Acquire(const std::string& hookName, std::function<void()> callback);
+    // Per-car hook; installed with HookEventWithCaller
+    void Acquire(const std::string& hookName, std::function<void(CarHandle caller)> callback);
+    void Release(const std::string& hookName);
+
+    // Suspend unhooks everything immediately (unload) but keeps the counts;
+    // Resume installs whatever is referenced. Starts suspended, so nothing is
+    // hooked before the host is ready.
+    void Suspend();
+    void Resume();
+    bool IsSuspended() const { return suspended; }
+
+    size_t GetRefCount(const std::string& hookName) const;
+    bool IsInstalled(const std::string& hookName) const;
+    size_t GetInstalledCount() const;
+
+private:
+    struct Entry {
+        size_t refs = 0;
+        bool installed = false;
+        bool unhookQueued = false;
+        std::function<void()> callback;
+        std::function<void(CarHandle)> carCallback;
+    };
+
+    void AddRef(const std::string& hookName, Entry& entry);
+
+    void Install(const std::string& hookName, Entry& entry);
+    void FlushUnhook(const std::string& hookName);
+
+    CamHost& host;
+    std::unordered_map<std::string, Entry> entries;
+    bool suspended = true;
+};
@@ -0,0 +1,85 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+
+void LatencyHistogram::Record(uint64_t valueUs) {
+    counts[BucketIndex(valueUs)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(valueUs, std::memory_order_relaxed);
+
+    uint64_t currentMax = maxValue.load(std::memory_order_relaxed);
+    while (valueUs > currentMax && !maxValue.compare_exchange_weak(currentMax, valueUs, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : counts) count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t valueUs) {
+    if (valueUs < subBucketCount) return static_cast<size_t>(valueUs);
+
+    int magnitude = std::bit_width(valueUs) - 1;
+    if (magnitude > maxMagnitude) return bucketCount - 1;
+
+    int shift = magnitude - subBucketBits;
+    size_t subBucket = static_cast<size_t>(valueUs >> shift) - subBucketCount;
+    return subBucketCount * (shift + 1) + subBucket;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) {
+    if (index < subBucketCount) return index;
+
+    size_t shift = index / subBucketCount - 1;
+    uint64_t subBucket = index % subBucketCount;
+    return (subBucketCount + subBucket) << shift;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const {
+    uint64_t count = GetCount();
+    if (count == 0) return 0;
+
+    auto rank = static_cast<uint64_t>(std::clamp(percentile, 0.0, 100.0) / 100.0 * count + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        seen += GetBucket(i);
+        if (seen >= rank) return std::min(BucketUpperBound(i), GetMax());
+    }
+    return GetMax();
+}
+
+double LatencyHistogram::GetMean() const {
+    uint64_t count = GetCount();
+    return count ? static_cast<double>(sum.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+const char* GetLatencyStageName(LatencyStage stage) {
+    switch (stage) {
+    case LatencyStage::HookToScheduled:   return "Hook -> Scheduled";
+    case LatencyStage::TimerLateness:     return "Timer Lateness";
+    case LatencyStage::ExecutedToApplied: return "Executed -> Applied";
+    case LatencyStage::HookToApplied:     return "Hook -> Applied";
+    default:                              return "";
+    }
+}
+
+void LatencyMonitor::Record(LatencyStage stage, double seconds) {
+    histograms[static_cast<size_t>(stage)].Record(static_cast<uint64_t>(std::max(0.0, seconds) * 1e6));
+}
+
+void LatencyMonitor::RecordApplied(const LatencyStamp& stamp, double appliedTime) {
+    if (!stamp.IsValid()) return;
+
+    if (stamp.executedTime >= 0.0) Record(LatencyStage::ExecutedToApplied, appliedTime - stamp.executedTime);
+    Record(LatencyStage::HookToApplied, appliedTime - stamp.hookTime - (stamp.intendedTime - stamp.scheduledTime));
+}
+
+void LatencyMonitor::Reset() {
+    for (auto& histogram : histograms) histogram.Reset();
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// HDR-style log-linear histogram of microsecond values: 16 linear
+// sub-buckets per power of two (~6% relative precision) up to ~36 minutes.
+// Record() is a couple of relaxed atomic ops, so the game thread can write
+// while the render thread reads percentiles without locks.
+class LatencyHistogram {
+public:
+    constexpr static int subBucketBits = 4;
+    constexpr static int subBucketCount = 1 << subBucketBits;
+    constexpr static int maxMagnitude = 31;
+    constexpr static size_t bucketCount = subBucketCount * (maxMagnitude - subBucketBits + 2);
+
+    void Record(uint64_t valueUs);
+    void Reset();
+
+    uint64_t GetCount() const { return total.load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return maxValue.load(std::memory_order_relaxed); }
+    uint64_t GetBucket(size_t index) const { return counts[index].load(std::memory_order_relaxed); }
+    // Value at percentile (0..100), reported as the upper edge of its bucket
+    uint64_t GetPercentile(double percentile) const;
+    double GetMean() const;
+
+    static size_t BucketIndex(uint64_t valueUs);
+    static uint64_t BucketLowerBound(size_t index);
+    static uint64_t BucketUpperBound(size_t index) { return BucketLowerBound(index + 1) - 1; }
+
+private:
+    std::array<std::atomic<uint32_t>, bucketCount> counts{};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> maxValue{ 0 };
+};
+
+// Where a camera change spends its time between the game hook and the frame
+// that shows it
+enum class LatencyStage : uint8_t {
+    HookToScheduled,   // Hook entry -> step matched and queued
+    TimerLateness,     // Queued + intended delay -> action executed
+    ExecutedToApplied, // Action executed -> camera state written (e.g. in ApplySwivel)
+    HookToApplied,     // End to end, minus the intended delay
+    Count
+};
+
+constexpr size_t LatencyStageCount = static_cast<size_t>(LatencyStage::Count);
+
+const char* GetLatencyStageName(LatencyStage stage);
+
+// Per-action timestamps carried from the hook to the camera write
+struct LatencyStamp {
+    double hookTime = -1.0;
+    double scheduledTime = -1.0;
+    double intendedTime = -1.0; // scheduledTime + delay
+    double executedTime = -1.0;
+
+    bool IsValid() const { return hookTime >= 0.0; }
+};
+
+class LatencyMonitor {
+public:
+    void Record(LatencyStage stage, double seconds);
+    // Records ExecutedToApplied and HookToApplied for a stamp that just landed
+    void RecordApplied(const LatencyStamp& stamp, double appliedTime);
+    void Reset();
+
+    const LatencyHistogram& Get(LatencyStage stage) const { return histograms[static_cast<size_t>(stage)]; }
+
+private:
+    std::array<LatencyHistogram, LatencyStageCount> histograms;
+};
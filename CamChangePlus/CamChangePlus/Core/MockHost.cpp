@@ -0,0 +1,169 @@
+#include "MockHost.h"
+
+#include <algorithm>
+#include <iostream>
+
+MockHost::MockHost(std::filesystem::path dataFolder) : dataFolder(std::move(dataFolder)) {
+}
+
+void MockHost::HookEvent(const std::string& eventName, std::function<void()> callback) {
+    CheckHookChange(eventName);
+    hooks[eventName].push_back(std::move(callback));
+}
+
+void MockHost::HookEventWithCaller(const std::string& eventName, std::function<void(CarHandle caller)> callback) {
+    CheckHookChange(eventName);
+    hooks[eventName].push_back([this, callback = std::move(callback)]() { callback(firingCaller); });
+}
+
+void MockHost::UnhookEvent(const std::string& eventName) {
+    CheckHookChange(eventName);
+    auto it = hooks.find(eventName);
+    if (it != hooks.end()) it->second.clear();
+}
+
+void MockHost::SetTimeout(std::function<void()> callback, float delaySeconds) {
+    timers.push({ now + delaySeconds, timerOrder++, std::move(callback) });
+}
+
+void MockHost::Execute(std::function<void()> callback) {
+    executeCount++;
+    executeQueue.push_back(std::move(callback));
+}
+
+void MockHost::Flush() {
+    // Callbacks may Execute again; keep draining until nothing new is queued
+    while (!executeQueue.empty()) {
+        executeRunning.swap(executeQueue);
+        for (auto& callback : executeRunning) callback();
+        executeRunning.clear();
+    }
+}
+
+bool MockHost::GetLocalCarState(CarState& state) {
+    if (!hasLocalCar) return false;
+    state = localCar;
+    return true;
+}
+
+bool MockHost::GetCarState(CarHandle car, CarState& state) {
+    if (hasLocalCar && car == localCarHandle) {
+        state = localCar;
+        return true;
+    }
+    auto it = std::find_if(cars.begin(), cars.end(), [car](const MatchCar& match) { return match.handle == car; });
+    if (it == cars.end()) return false;
+    state = it->state;
+    return true;
+}
+
+size_t MockHost::GetCars(MatchCar* out, size_t capacity) {
+    if (cars.empty()) {
+        if (!hasLocalCar || capacity == 0) return 0;
+        out[0] = { localCarHandle, 0, localCar };
+        return 1;
+    }
+    size_t count = std::min(cars.size(), capacity);
+    std::copy(cars.begin(), cars.begin() + count, out);
+    return count;
+}
+
+bool MockHost::GetReplayTime(double& time) {
+    if (!inReplay) return false;
+    time = replayTime;
+    return true;
+}
+
+bool MockHost::GetBallState(BallState& state) {
+    if (!hasBall) return false;
+    state = ball;
+    return true;
+}
+
+bool MockHost::SetUsingBehindView(bool enable) {
+    if (!hasCamera) return false;
+    usingBehindView = enable;
+    return true;
+}
+
+bool MockHost::SetUsingSecondaryCamera(bool enable) {
+    if (!hasCamera) return false;
+    usingSecondaryCamera = enable;
+    return true;
+}
+
+bool MockHost::GetCameraSwivel(CamRotator& out) {
+    if (!hasCamera) return false;
+    out = swivel;
+    return true;
+}
+
+bool MockHost::SetCameraSwivel(const CamRotator& in) {
+    if (!hasCamera) return false;
+    swivel = in;
+    return true;
+}
+
+bool MockHost::GetCameraSettings(CamSettings& out) {
+    if (!hasCamera) return false;
+    out = cameraSettings;
+    return true;
+}
+
+bool MockHost::SetCameraSettings(const CamSettings& in) {
+    if (!hasCamera) return false;
+    cameraSettings = in;
+    return true;
+}
+
+void MockHost::Log(const std::string& message) {
+    if (echoLog) std::cout << message << '\n';
+    if (keepLog) logLines.push_back(message);
+}
+
+bool MockHost::FireEvent(const std::string& eventName, CarHandle caller) {
+    auto it = hooks.find(eventName);
+    if (it == hooks.end() || it->second.empty()) return false;
+
+    CarHandle outerCaller = firingCaller;
+    firingCaller = caller != 0 ? caller : localCarHandle;
+
+    // Runs a copy, so a hook change the game would crash on (flagged by
+    // CheckHookChange) can't destroy the callback that is running
+    std::vector<std::function<void()>> callbacks = it->second;
+    firingEvents.push_back(eventName);
+    for (auto& callback : callbacks) callback();
+    firingEvents.pop_back();
+    firingCaller = outerCaller;
+    Flush();
+    return true;
+}
+
+void MockHost::CheckHookChange(const std::string& eventName) {
+    if (std::find(firingEvents.begin(), firingEvents.end(), eventName) == firingEvents.end()) return;
+    hookChangesWhileFiring++;
+    Log("[MockHost] Error: " + eventName + " hooked or unhooked from inside its own hook");
+}
+
+bool MockHost::IsHooked(const std::string& eventName) const {
+    auto it = hooks.find(eventName);
+    return it != hooks.end() && !it->second.empty();
+}
+
+void MockHost::AdvanceTime(double seconds) {
+    AdvanceTo(now + seconds);
+}
+
+void MockHost::AdvanceTo(double time) {
+    Flush();
+    while (!timers.empty() && timers.top().due <= time) {
+        Timer timer = std::move(const_cast<Timer&>(timers.top()));
+        timers.pop();
+        now = std::max(now, timer.due);
+        timer.callback();
+
+        // Timers due at the same instant share a tick
+        if (timers.empty() || timers.top().due != timer.due) Flush();
+    }
+    now = std::max(now, time);
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <functional>
+#include <filesystem>
+
+#include "CamHost.h"
+
+// Headless CamHost with a virtual clock. Timers only fire from AdvanceTime,
+// hooks only fire from FireEvent, and camera writes land in plain fields so
+// the engine can be driven and inspected without the game. Like the game,
+// Execute defers its callback to the end of the current step (after the
+// hooks of a FireEvent, or after each batch of timers due together).
+class MockHost : public CamHost {
+public:
+    explicit MockHost(std::filesystem::path dataFolder = std::filesystem::temp_directory_path());
+
+    // CamHost
+    void HookEvent(const std::string& eventName, std::function<void()> callback) override;
+    void HookEventWithCaller(const std::string& eventName, std::function<void(CarHandle caller)> callback) override;
+    void UnhookEvent(const std::string& eventName) override;
+    void SetTimeout(std::function<void()> callback, float delaySeconds) override;
+    void Execute(std::function<void()> callback) override;
+    double GetTime() override { return now; }
+    bool GetLocalCarState(CarState& state) override;
+    CarHandle GetFocusCar() override { return hasLocalCar ? localCarHandle : spectatedCar; }
+    bool GetCarState(CarHandle car, CarState& state) override;
+    size_t GetCars(MatchCar* out, size_t capacity) override;
+    bool GetReplayTime(double& time) override;
+    std::string GetReplayId() override { return inReplay ? replayId : std::string(); }
+    bool GetBallState(BallState& state) override;
+    bool SetUsingBehindView(bool enable) override;
+    bool SetUsingSecondaryCamera(bool enable) override;
+    bool GetCameraSwivel(CamRotator& swivel) override;
+    bool SetCameraSwivel(const CamRotator& swivel) override;
+    bool GetCameraSettings(CamSettings& settings) override;
+    bool SetCameraSettings(const CamSettings& settings) override;
+    void Log(const std::string& message) override;
+    std::filesystem::path GetDataFolder() override { return dataFolder; }
+
+    // ===========================
+    //        Driving
+    // ===========================
+    // Runs every hook registered for eventName; returns false if none is hooked.
+    // Caller-aware hooks see caller, or the local car when it is 0.
+    bool FireEvent(const std::string& eventName, CarHandle caller = 0);
+    bool IsHooked(const std::string& eventName) const;
+    // Moves the virtual clock forward, firing due timers in order
+    void AdvanceTime(double seconds);
+    void AdvanceTo(double time);
+    // Runs deferred Execute callbacks now
+    void Flush();
+    size_t PendingTimers() const { return timers.size(); }
+    size_t executeCount = 0; // Execute calls so far
+    // Hook or unhook calls on an event while its hooks run. BakkesMod crashes
+    // on these (the core defers unhooks through Execute), so tests expect 0.
+    size_t hookChangesWhileFiring = 0;
+
+    // ===========================
+    //     Simulated Game State
+    // ===========================
+    bool hasLocalCar = true;
+    CarHandle localCarHandle = 1;
+    CarState localCar;
+    CarHandle spectatedCar = 0; // Focus car when there is no local car
+    // Every car in the match; empty means just the local car, on blue
+    std::vector<MatchCar> cars;
+    bool inReplay = false;
+    double replayTime = 0.0; // Drivers move it with the clock and jump it to seek
+    std::string replayId = "MockReplay";
+    bool hasBall = true;
+    BallState ball{ { 0.0f, 0.0f, 92.75f }, {} };
+    bool hasCamera = true;
+
+    bool usingBehindView = false;
+    bool usingSecondaryCamera = false;
+    CamRotator swivel;
+    CamSettings cameraSettings;
+
+    bool echoLog = false;
+    bool keepLog = true;  // Offline drivers turn this off to skip the copies
+    std::vector<std::string> logLines;
+
+private:
+    void CheckHookChange(const std::string& eventName);
+
+    struct Timer {
+        double due;
+        uint64_t order; // FIFO among timers due at the same time
+        std::function<void()> callback;
+    };
+    struct TimerLater {
+        bool operator()(const Timer& a, const Timer& b) const {
+            return a.due != b.due ? a.due > b.due : a.order > b.order;
+        }
+    };
+
+    std::filesystem::path dataFolder;
+    double now = 0.0;
+    CarHandle firingCaller = 0; // Caller of the FireEvent in progress
+    std::vector<std::string> firingEvents; // Nested FireEvent calls in progress
+    uint64_t timerOrder = 0;
+    std::priority_queue<Timer, std::vector<Timer>, TimerLater> timers;
+    std::unordered_map<std::string, std::vector<std::function<void()>>> hooks;
+    std::vector<std::function<void()>> executeQueue;
+    std::vector<std::function<void()>> executeRunning;
+};
@@ -0,0 +1,400 @@
+#include "Predicate.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+namespace {
+    constexpr std::array<std::pair<PredicateVariable, const char*>, static_cast<size_t>(PredicateVariable::Count)> variableNames{ {
+        { PredicateVariable::CarX,          "car.x" },
+        { PredicateVariable::CarY,          "car.y" },
+        { PredicateVariable::CarZ,          "car.z" },
+        { PredicateVariable::CarVelocityX,  "car.vx" },
+        { PredicateVariable::CarVelocityY,  "car.vy" },
+        { PredicateVariable::CarVelocityZ,  "car.vz" },
+        { PredicateVariable::CarSpeed,      "car.speed" },
+        { PredicateVariable::CarBoost,      "car.boost" },
+        { PredicateVariable::CarGrounded,   "car.grounded" },
+        { PredicateVariable::CarOnWall,     "car.wall" },
+        { PredicateVariable::CarSupersonic, "car.supersonic" },
+        { PredicateVariable::BallX,         "ball.x" },
+        { PredicateVariable::BallY,         "ball.y" },
+        { PredicateVariable::BallZ,         "ball.z" },
+        { PredicateVariable::BallVelocityX, "ball.vx" },
+        { PredicateVariable::BallVelocityY, "ball.vy" },
+        { PredicateVariable::BallVelocityZ, "ball.vz" },
+        { PredicateVariable::BallSpeed,     "ball.speed" },
+        { PredicateVariable::BallDistance,  "ball.distance" },
+    } };
+
+    float Length(float x, float y, float z) {
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    float Read(PredicateVariable variable, const WorldSnapshot& snapshot) {
+        const CarState& car = snapshot.car;
+        const BallState& ball = snapshot.ball;
+        bool isCar = variable <= PredicateVariable::CarSupersonic;
+        if (isCar ? !snapshot.hasCar : !snapshot.hasBall) return 0.0f;
+
+        switch (variable) {
+        case PredicateVariable::CarX:          return car.location.X;
+        case PredicateVariable::CarY:          return car.location.Y;
+        case PredicateVariable::CarZ:          return car.location.Z;
+        case PredicateVariable::CarVelocityX:  return car.velocity.X;
+        case PredicateVariable::CarVelocityY:  return car.velocity.Y;
+        case PredicateVariable::CarVelocityZ:  return car.velocity.Z;
+        case PredicateVariable::CarSpeed:      return Length(car.velocity.X, car.velocity.Y, car.velocity.Z);
+        case PredicateVariable::CarBoost:      return car.boost * 100.0f;
+        case PredicateVariable::CarGrounded:   return car.onGround ? 1.0f : 0.0f;
+        case PredicateVariable::CarOnWall:     return car.onWall ? 1.0f : 0.0f;
+        case PredicateVariable::CarSupersonic: return car.supersonic ? 1.0f : 0.0f;
+        case PredicateVariable::BallX:         return ball.location.X;
+        case PredicateVariable::BallY:         return ball.location.Y;
+        case PredicateVariable::BallZ:         return ball.location.Z;
+        case PredicateVariable::BallVelocityX: return ball.velocity.X;
+        case PredicateVariable::BallVelocityY: return ball.velocity.Y;
+        case PredicateVariable::BallVelocityZ: return ball.velocity.Z;
+        case PredicateVariable::BallSpeed:     return Length(ball.velocity.X, ball.velocity.Y, ball.velocity.Z);
+        case PredicateVariable::BallDistance:
+            if (!snapshot.hasCar) return 0.0f;
+            return Length(ball.location.X - car.location.X, ball.location.Y - car.location.Y, ball.location.Z - car.location.Z);
+        default:                               return 0.0f;
+        }
+    }
+
+    float Apply(PredicateOp op, float a, float b) {
+        switch (op) {
+        case PredicateOp::Add:          return a + b;
+        case PredicateOp::Sub:          return a - b;
+        case PredicateOp::Mul:          return a * b;
+        case PredicateOp::Div:          return a / b;
+        case PredicateOp::Less:         return a < b ? 1.0f : 0.0f;
+        case PredicateOp::LessEqual:    return a <= b ? 1.0f : 0.0f;
+        case PredicateOp::Greater:      return a > b ? 1.0f : 0.0f;
+        case PredicateOp::GreaterEqual: return a >= b ? 1.0f : 0.0f;
+        case PredicateOp::Equal:        return a == b ? 1.0f : 0.0f;
+        case PredicateOp::NotEqual:     return a != b ? 1.0f : 0.0f;
+        case PredicateOp::And:          return a != 0.0f && b != 0.0f ? 1.0f : 0.0f;
+        case PredicateOp::Or:           return a != 0.0f || b != 0.0f ? 1.0f : 0.0f;
+        case PredicateOp::Neg:          return -a;
+        case PredicateOp::Not:          return a == 0.0f ? 1.0f : 0.0f;
+        default:                        return 0.0f;
+        }
+    }
+
+    // Same operation with the operands swapped, for a constant on the left;
+    // Const for Sub and Div, which have none
+    PredicateOp Swapped(PredicateOp op) {
+        switch (op) {
+        case PredicateOp::Less:         return PredicateOp::Greater;
+        case PredicateOp::LessEqual:    return PredicateOp::GreaterEqual;
+        case PredicateOp::Greater:      return PredicateOp::Less;
+        case PredicateOp::GreaterEqual: return PredicateOp::LessEqual;
+        case PredicateOp::Sub:
+        case PredicateOp::Div:          return PredicateOp::Const;
+        default:                        return op;
+        }
+    }
+
+    enum class Token : uint8_t {
+        End, Number, Name, LeftParen, RightParen,
+        Plus, Minus, Star, Slash,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+        And, Or, Not, Invalid
+    };
+
+    // A value while parsing: folded to a constant, or held in a register.
+    // Registers are taken and given back like a stack, so the left operand
+    // of every binary operation sits just below the right one and the whole
+    // expression ends up in r0.
+    struct Operand {
+        bool isConstant = true;
+        float value = 0.0f;
+        uint8_t reg = 0;
+    };
+
+    class Parser {
+    public:
+        Parser(std::string_view source, std::vector<PredicateInstruction>& code, std::string& error)
+            : source(source), code(code), error(error) {
+        }
+
+        void Parse() {
+            Next();
+            Operand result = ParseOr();
+            if (error.empty() && token != Token::End) Fail("unexpected '" + std::string(tokenText) + "'");
+            if (!error.empty()) return;
+            if (result.isConstant) code.push_back({ PredicateOp::Const, 0, 0, 0, result.value });
+        }
+
+    private:
+        void Next() {
+            while (position < source.size() && (source[position] == ' ' || source[position] == '\t')) position++;
+            tokenStart = position;
+            if (position >= source.size()) {
+                token = Token::End;
+                tokenText = {};
+                return;
+            }
+
+            char c = source[position];
+            char next = position + 1 < source.size() ? source[position + 1] : '\0';
+            auto take = [&](Token taken, size_t length) {
+                token = taken;
+                tokenText = source.substr(position, length);
+                position += length;
+            };
+
+            if ((c >= '0' && c <= '9') || c == '.') {
+                const char* first = source.data() + position;
+                auto [last, result] = std::from_chars(first, source.data() + source.size(), tokenValue);
+                if (result != std::errc()) {
+                    take(Token::Invalid, 1);
+                    return;
+                }
+                take(Token::Number, static_cast<size_t>(last - first));
+                return;
+            }
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+                size_t end = position;
+                while (end < source.size()) {
+                    char n = source[end];
+                    if (!((n >= 'a' && n <= 'z') || (n >= 'A' && n <= 'Z') || (n >= '0' && n <= '9') || n == '_' || n == '.')) break;
+                    end++;
+                }
+                take(Token::Name, end - position);
+                return;
+            }
+
+            switch (c) {
+            case '(': take(Token::LeftParen, 1); return;
+            case ')': take(Token::RightParen, 1); return;
+            case '+': take(Token::Plus, 1); return;
+            case '-': take(Token::Minus, 1); return;
+            case '*': take(Token::Star, 1); return;
+            case '/': take(Token::Slash, 1); return;
+            case '<': next == '=' ? take(Token::LessEqual, 2) : take(Token::Less, 1); return;
+            case '>': next == '=' ? take(Token::GreaterEqual, 2) : take(Token::Greater, 1); return;
+            case '=': next == '=' ? take(Token::Equal, 2) : take(Token::Invalid, 1); return;
+            case '!': next == '=' ? take(Token::NotEqual, 2) : take(Token::Not, 1); return;
+            case '&': next == '&' ? take(Token::And, 2) : take(Token::Invalid, 1); return;
+            case '|': next == '|' ? take(Token::Or, 2) : take(Token::Invalid, 1); return;
+            default:  take(Token::Invalid, 1); return;
+            }
+        }
+
+        void Fail(const std::string& message) {
+            if (error.empty()) error = message + " at column " + std::to_string(tokenStart + 1);
+        }
+
+        Operand ParseOr() {
+            Operand lhs = ParseAnd();
+            while (error.empty() && token == Token::Or) {
+                Next();
+                lhs = Binary(PredicateOp::Or, lhs, ParseAnd());
+            }
+            return lhs;
+        }
+
+        Operand ParseAnd() {
+            Operand lhs = ParseCompare();
+            while (error.empty() && token == Token::And) {
+                Next();
+                lhs = Binary(PredicateOp::And, lhs, ParseCompare());
+            }
+            return lhs;
+        }
+
+        Operand ParseCompare() {
+            Operand lhs = ParseSum();
+            PredicateOp op;
+            switch (token) {
+            case Token::Less:         op = PredicateOp::Less; break;
+            case Token::LessEqual:    op = PredicateOp::LessEqual; break;
+            case Token::Greater:      op = PredicateOp::Greater; break;
+            case Token::GreaterEqual: op = PredicateOp::GreaterEqual; break;
+            case Token::Equal:        op = PredicateOp::Equal; break;
+            case Token::NotEqual:     op = PredicateOp::NotEqual; break;
+            default:                  return lhs;
+            }
+            Next();
+            return Binary(op, lhs, ParseSum());
+        }
+
+        Operand ParseSum() {
+            Operand lhs = ParseProduct();
+            while (error.empty() && (token == Token::Plus || token == Token::Minus)) {
+                PredicateOp op = token == Token::Plus ? PredicateOp::Add : PredicateOp::Sub;
+                Next();
+                lhs = Binary(op, lhs, ParseProduct());
+            }
+            return lhs;
+        }
+
+        Operand ParseProduct() {
+            Operand lhs = ParseUnary();
+            while (error.empty() && (token == Token::Star || token == Token::Slash)) {
+                PredicateOp op = token == Token::Star ? PredicateOp::Mul : PredicateOp::Div;
+                Next();
+                lhs = Binary(op, lhs, ParseUnary());
+            }
+            return lhs;
+        }
+
+        Operand ParseUnary() {
+            if (!error.empty()) return {};
+
+            switch (token) {
+            case Token::Minus:
+                Next();
+                return Unary(PredicateOp::Neg, ParseUnary());
+            case Token::Not:
+                Next();
+                return Unary(PredicateOp::Not, ParseUnary());
+            case Token::Number: {
+                Operand constant{ true, tokenValue, 0 };
+                Next();
+                return constant;
+            }
+            case Token::LeftParen: {
+                Next();
+                Operand inner = ParseOr();
+                if (token != Token::RightParen) {
+                    Fail("expected ')'");
+                    return {};
+                }
+                Next();
+                return inner;
+            }
+            case Token::Name: {
+                if (tokenText == "true" || tokenText == "false") {
+                    Operand constant{ true, tokenText == "true" ? 1.0f : 0.0f, 0 };
+                    Next();
+                    return constant;
+                }
+                PredicateVariable variable = Predicate::FindVariableByName(tokenText);
+                if (variable == PredicateVariable::Count) {
+                    Fail("unknown variable '" + std::string(tokenText) + "'");
+                    return {};
+                }
+                Operand loaded{ false, 0.0f, Allocate() };
+                code.push_back({ PredicateOp::Load, loaded.reg, static_cast<uint8_t>(variable), 0, 0.0f });
+                Next();
+                return loaded;
+            }
+            case Token::End:
+                Fail("expression ends early");
+                return {};
+            default:
+                Fail("unexpected '" + std::string(tokenText) + "'");
+                return {};
+            }
+        }
+
+        Operand Binary(PredicateOp op, Operand lhs, Operand rhs) {
+            if (!error.empty()) return {};
+
+            if (lhs.isConstant && rhs.isConstant) return { true, Apply(op, lhs.value, rhs.value), 0 };
+            if (!lhs.isConstant && rhs.isConstant) {
+                code.push_back({ op, lhs.reg, lhs.reg, Predicate::immediate, rhs.value });
+                return lhs;
+            }
+            if (!lhs.isConstant) {
+                code.push_back({ op, lhs.reg, lhs.reg, rhs.reg, 0.0f });
+                Free(rhs.reg);
+                return lhs;
+            }
+
+            // Constant on the left: swap the operands, or load it above the right
+            PredicateOp swapped = Swapped(op);
+            if (swapped != PredicateOp::Const) {
+                code.push_back({ swapped, rhs.reg, rhs.reg, Predicate::immediate, lhs.value });
+                return rhs;
+            }
+            uint8_t scratch = Allocate();
+            code.push_back({ PredicateOp::Const, scratch, 0, 0, lhs.value });
+            code.push_back({ op, rhs.reg, scratch, rhs.reg, 0.0f });
+            Free(scratch);
+            return rhs;
+        }
+
+        Operand Unary(PredicateOp op, Operand operand) {
+            if (!error.empty()) return {};
+            if (operand.isConstant) return { true, Apply(op, operand.value, 0.0f), 0 };
+            code.push_back({ op, operand.reg, operand.reg, 0, 0.0f });
+            return operand;
+        }
+
+        uint8_t Allocate() {
+            if (nextRegister >= Predicate::registerCount) {
+                Fail("expression needs more than " + std::to_string(Predicate::registerCount) + " registers");
+                return 0;
+            }
+            return static_cast<uint8_t>(nextRegister++);
+        }
+
+        void Free(uint8_t reg) {
+            nextRegister = reg;
+        }
+
+        std::string_view source;
+        std::vector<PredicateInstruction>& code;
+        std::string& error;
+        size_t position = 0;
+        size_t tokenStart = 0;
+        Token token = Token::End;
+        std::string_view tokenText;
+        float tokenValue = 0.0f;
+        size_t nextRegister = 0;
+    };
+}
+
+bool Predicate::Compile(std::string_view source) {
+    code.clear();
+    error.clear();
+    if (source.find_first_not_of(" \t") == std::string_view::npos) return true;
+
+    Parser(source, code, error).Parse();
+    if (!error.empty()) code.clear();
+    return error.empty();
+}
+
+bool Predicate::Evaluate(const WorldSnapshot& snapshot) const {
+    if (!error.empty()) return false;
+    if (code.empty()) return true;
+
+    std::array<float, registerCount> r{};
+    for (const PredicateInstruction& instruction : code) {
+        float& dst = r[instruction.dst];
+        switch (instruction.op) {
+        case PredicateOp::Const:
+            dst = instruction.constant;
+            break;
+        case PredicateOp::Load:
+            dst = Read(static_cast<PredicateVariable>(instruction.a), snapshot);
+            break;
+        case PredicateOp::Neg:
+        case PredicateOp::Not:
+            dst = Apply(instruction.op, r[instruction.a], 0.0f);
+            break;
+        default:
+            dst = Apply(instruction.op, r[instruction.a], instruction.b == immediate ? instruction.constant : r[instruction.b]);
+            break;
+        }
+    }
+    return r[0] != 0.0f;
+}
+
+const char* Predicate::GetVariableName(PredicateVariable variable) {
+    size_t index = static_cast<size_t>(variable);
+    return index < variableNames.size() ? variableNames[index].second : "Unknown";
+}
+
+PredicateVariable Predicate::FindVariableByName(std::string_view name) {
+    for (const auto& [variable, variableName] : variableNames) {
+        if (name == variableName) return variable;
+    }
+    return PredicateVariable::Count;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EventDetector.h"
+
+// Values a condition can read from the snapshot taken as the event arrives
+enum class PredicateVariable : uint8_t {
+    CarX, CarY, CarZ,
+    CarVelocityX, CarVelocityY, CarVelocityZ,
+    CarSpeed,      // uu/s
+    CarBoost,      // 0..100
+    CarGrounded,   // 1 on any surface
+    CarOnWall,
+    CarSupersonic,
+    BallX, BallY, BallZ,
+    BallVelocityX, BallVelocityY, BallVelocityZ,
+    BallSpeed,
+    BallDistance,  // Car to ball
+    Count
+};
+
+enum class PredicateOp : uint8_t {
+    Const,  // r[dst] = constant
+    Load,   // r[dst] = variable a
+    Add, Sub, Mul, Div,
+    Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+    And, Or,
+    Neg, Not // Unary on r[a]
+};
+
+// Register form: r[dst] = r[a] op (b == immediate ? constant : r[b])
+struct PredicateInstruction {
+    PredicateOp op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    float constant;
+};
+static_assert(sizeof(PredicateInstruction) == 8, "PredicateInstruction must stay 8 bytes");
+
+// A step condition such as "car.speed > 1800 && ball.z > 600", parsed once
+// into a few register instructions and evaluated against a snapshot with
+// nothing but a small register array on the stack. Numbers are floats;
+// comparisons and logic give 1 or 0, and anything non-zero is true.
+//
+//   expression := or;  or := and ('||' and)*;  and := compare ('&&' compare)*
+//   compare := sum (('<' | '<=' | '>' | '>=' | '==' | '!=') sum)?
+//   sum := product (('+' | '-') product)*;  product := unary (('*' | '/') unary)*
+//   unary := ('-' | '!') unary | number | 'true' | 'false' | variable | '(' expression ')'
+//
+// Variables are car.x/y/z, car.vx/vy/vz, car.speed, car.boost (0..100),
+// car.grounded, car.wall, car.supersonic, ball.x/y/z, ball.vx/vy/vz,
+// ball.speed and ball.distance (from the car). Without a car or ball in
+// the snapshot its variables read 0.
+class Predicate {
+public:
+    // False with GetError set on a syntax error or an unknown variable; an
+    // empty source compiles to a predicate that always holds
+    bool Compile(std::string_view source);
+    bool Evaluate(const WorldSnapshot& snapshot) const;
+
+    bool IsEmpty() const { return code.empty() && error.empty(); }
+    bool IsValid() const { return error.empty(); }
+    const std::string& GetError() const { return error; }
+    const std::vector<PredicateInstruction>& GetCode() const { return code; }
+
+    constexpr static size_t registerCount = 16;
+    constexpr static uint8_t immediate = 0xFF;
+
+    static const char* GetVariableName(PredicateVariable variable);
+    // PredicateVariable::Count for unknown names
+    static PredicateVariable FindVariableByName(std::string_view name);
+
+private:
+    std::vector<PredicateInstruction> code;
+    std::string error;
+};
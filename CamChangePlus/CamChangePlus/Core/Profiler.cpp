@@ -0,0 +1,108 @@
+#include "Profiler.h"
+
+#ifdef CAMCHANGE_ENABLE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct Zone {
+        const char* name;
+        int64_t startUs;
+        int64_t durationUs;
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex; // Only contended while exporting
+        std::vector<Zone> zones;
+        uint32_t threadId = 0;
+    };
+
+    std::atomic<bool> active{ false };
+    std::atomic<int64_t> originUs{ 0 };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t nextThreadId = 1;
+
+    ThreadBuffer& LocalBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+            auto created = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            created->threadId = nextThreadId++;
+            buffers.push_back(created);
+            return created;
+        }();
+        return *buffer;
+    }
+}
+
+void TraceProfiler::Start() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& buffer : buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->zones.clear();
+        }
+    }
+    originUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    active = true;
+}
+
+void TraceProfiler::Stop() {
+    active = false;
+}
+
+bool TraceProfiler::IsActive() {
+    return active.load(std::memory_order_relaxed);
+}
+
+int64_t TraceProfiler::NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() - originUs.load(std::memory_order_relaxed);
+}
+
+void TraceProfiler::RecordZone(const char* name, int64_t startUs, int64_t endUs) {
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.zones.push_back({ name, startUs, endUs - startUs });
+}
+
+size_t TraceProfiler::GetZoneCount() {
+    size_t count = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->zones.size();
+    }
+    return count;
+}
+
+bool TraceProfiler::WriteChromeTrace(const std::filesystem::path& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) return false;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto& zone : buffer->zones) {
+            file << (first ? "" : ",\n")
+                << "{\"name\":\"" << zone.name << "\",\"cat\":\"CamChangePlus\",\"ph\":\"X\",\"ts\":" << zone.startUs
+                << ",\"dur\":" << zone.durationUs << ",\"pid\":1,\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+    }
+
+    file << "\n]}\n";
+    return file.good();
+}
+
+#endif
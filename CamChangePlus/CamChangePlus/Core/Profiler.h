@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// Scoped trace zones exported as Chrome trace JSON (chrome://tracing,
+// ui.perfetto.dev). Build with CAMCHANGE_ENABLE_TRACING to compile them in;
+// otherwise CCP_TRACE_SCOPE expands to nothing.
+//
+//     void SequenceEngine::ProcessEventActions(GameEvent event) {
+//         CCP_TRACE_SCOPE("ProcessEventActions");
+//         ...
+
+#ifdef CAMCHANGE_ENABLE_TRACING
+
+#define CCP_TRACE_CONCAT_(a, b) a##b
+#define CCP_TRACE_CONCAT(a, b) CCP_TRACE_CONCAT_(a, b)
+#define CCP_TRACE_SCOPE(name) TraceZone CCP_TRACE_CONCAT(ccpTraceZone, __LINE__)(name)
+
+// Zones are appended to a buffer owned by the recording thread, so threads
+// never contend with each other; the buffers are only walked on export.
+class TraceProfiler {
+public:
+    static void Start();
+    static void Stop();
+    static bool IsActive();
+    // Writes every zone recorded since Start(); call after Stop()
+    static bool WriteChromeTrace(const std::filesystem::path& filepath);
+    static size_t GetZoneCount();
+
+    static int64_t NowUs();
+    static void RecordZone(const char* name, int64_t startUs, int64_t endUs);
+};
+
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) : name(name), startUs(TraceProfiler::IsActive() ? TraceProfiler::NowUs() : -1) {
+    }
+    ~TraceZone() {
+        if (startUs >= 0) TraceProfiler::RecordZone(name, startUs, TraceProfiler::NowUs());
+    }
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* name;
+    int64_t startUs;
+};
+
+#else
+
+#define CCP_TRACE_SCOPE(name) ((void)0)
+
+#endif
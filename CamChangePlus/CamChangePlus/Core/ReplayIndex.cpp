@@ -0,0 +1,115 @@
+#include "ReplayIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+std::filesystem::path ReplayIndex::DefaultPath(const std::filesystem::path& dataFolder, const std::string& replayId) {
+    return dataFolder / "CamChangePlus_replays" / (replayId + ".idx");
+}
+
+void ReplayIndex::Clear() {
+    entries.clear();
+    frontier = 0.0;
+}
+
+void ReplayIndex::Advance(double replayTime) {
+    frontier = std::max(frontier, replayTime);
+}
+
+void ReplayIndex::Add(double replayTime, GameEvent event, uint8_t bindings) {
+    if (replayTime < frontier) return;
+    entries.push_back({ static_cast<float>(replayTime), static_cast<uint8_t>(event), bindings, 0 });
+}
+
+void ReplayIndex::Finish() {
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const ReplayIndexEntry& a, const ReplayIndexEntry& b) { return a.time < b.time; });
+}
+
+bool ReplayIndex::Save(const std::filesystem::path& filepath) const {
+    std::error_code error;
+    std::filesystem::create_directories(filepath.parent_path(), error);
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    ReplayIndexHeader header{ ReplayIndexMagic, ReplayIndexVersion, sizeof(ReplayIndexEntry),
+        static_cast<uint32_t>(entries.size()), static_cast<float>(frontier), 0 };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ReplayIndexEntry));
+    return static_cast<bool>(file);
+}
+
+bool ReplayIndex::Load(const std::filesystem::path& filepath) {
+    Clear();
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    ReplayIndexHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != ReplayIndexMagic ||
+        header.version != ReplayIndexVersion || header.entrySize != sizeof(ReplayIndexEntry)) {
+        return false;
+    }
+
+    entries.resize(header.count);
+    if (!file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(ReplayIndexEntry))) {
+        entries.clear();
+        return false;
+    }
+    frontier = header.duration;
+    return true;
+}
+
+void ReplayCueSheet::Resolve(const std::vector<SequenceStep>& steps, const ReplayIndex& index, double start, bool loop) {
+    cues.clear();
+    buckets.clear();
+    startTime = start;
+    complete = false;
+
+    const auto& entries = index.GetEntries();
+    auto first = std::lower_bound(entries.begin(), entries.end(), start,
+        [](const ReplayIndexEntry& entry, double time) { return entry.time < time; });
+
+    size_t next = 0;
+    double lastMatch = start;
+    for (auto it = first; it != entries.end() && next < steps.size(); ++it) {
+        const SequenceStep& step = steps[next];
+        auto event = static_cast<GameEvent>(it->event);
+        if (event != step.event || !(it->bindings >> static_cast<size_t>(step.binding) & 1)) continue;
+
+        // Predicted events are indexed at the hit, so a negative delay fires
+        // ahead of it, but never before the previous step matched
+        float delay = IsPredictedEvent(event) ? step.delay : std::max(step.delay, 0.0f);
+        double time = std::max(static_cast<double>(it->time) + delay, lastMatch);
+        lastMatch = std::max(lastMatch, static_cast<double>(it->time));
+
+        // Same order as the live engine: the reset, then the final step's action
+        size_t matched = next;
+        if (++next == steps.size()) {
+            cues.push_back({ lastMatch, 0, true });
+            complete = true;
+            if (loop) next = 0;
+        }
+        cues.push_back({ time, matched, false });
+    }
+    std::stable_sort(cues.begin(), cues.end(), [](const ReplayCue& a, const ReplayCue& b) { return a.time < b.time; });
+
+    if (cues.empty()) return;
+    auto seconds = static_cast<size_t>(std::ceil(cues.back().time - start)) + 1;
+    buckets.resize(seconds);
+    size_t cue = 0;
+    for (size_t s = 0; s < seconds; ++s) {
+        while (cue < cues.size() && cues[cue].time < start + s) cue++;
+        buckets[s] = static_cast<uint32_t>(cue);
+    }
+}
+
+size_t ReplayCueSheet::Find(double time) const {
+    if (time <= startTime) return 0;
+    auto second = static_cast<size_t>(time - startTime);
+    if (second >= buckets.size()) return cues.size();
+
+    size_t cue = buckets[second];
+    while (cue < cues.size() && cues[cue].time < time) cue++;
+    return cue;
+}
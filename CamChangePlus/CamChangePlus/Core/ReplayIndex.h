@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "GameEvents.h"
+#include "Sequence.h"
+
+// One event of a scanned replay. Predicted events are stored at the moment
+// the ball actually hits, so negative step delays land exactly.
+struct ReplayIndexEntry {
+    float time;       // Replay seconds
+    uint8_t event;    // GameEvent
+    uint8_t bindings; // Bit per CarBinding that accepted the event's car
+    uint16_t reserved;
+};
+static_assert(sizeof(ReplayIndexEntry) == 8, "ReplayIndexEntry must stay 8 bytes");
+
+// On-disk header, entries follow sorted by time
+struct ReplayIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t count;
+    float duration; // Replay seconds the scan covered
+    uint32_t reserved;
+};
+static_assert(sizeof(ReplayIndexHeader) == 24, "ReplayIndexHeader must stay 24 bytes");
+
+constexpr uint32_t ReplayIndexMagic = 0x49504343; // "CCPI"
+constexpr uint32_t ReplayIndexVersion = 1;
+
+// Every event of one replay by replay time, filled once by a scan pass and
+// saved next to the plugin's other data. Only the frontier is recorded, so
+// scrubbing back during the scan adds no duplicates.
+class ReplayIndex {
+public:
+    static std::filesystem::path DefaultPath(const std::filesystem::path& dataFolder, const std::string& replayId);
+
+    void Clear();
+    // Per frame of the scan; events behind the frontier are ignored
+    void Advance(double replayTime);
+    void Add(double replayTime, GameEvent event, uint8_t bindings);
+    // Sorts what Add collected out of order (predicted hits)
+    void Finish();
+
+    bool Save(const std::filesystem::path& filepath) const;
+    bool Load(const std::filesystem::path& filepath);
+
+    const std::vector<ReplayIndexEntry>& GetEntries() const { return entries; }
+    double GetDuration() const { return frontier; }
+    bool IsEmpty() const { return entries.empty(); }
+
+private:
+    std::vector<ReplayIndexEntry> entries;
+    double frontier = 0.0;
+};
+
+// A step action resolved to the replay time it fires at
+struct ReplayCue {
+    double time;
+    size_t step;
+    bool reset; // The sequence completed here (or wrapped, when looping); no action
+};
+
+// A sequence resolved against an index into cues sorted by time. Cues are
+// bucketed per second of replay time, so finding where playback (or a seek)
+// is in the sheet is one table lookup plus the few cues of that second.
+class ReplayCueSheet {
+public:
+    // Matches steps against the events from startTime on, the way the live
+    // engine would, and runs until the last step or the end of the index.
+    // With loop the steps start over after the last one, to the end.
+    void Resolve(const std::vector<SequenceStep>& steps, const ReplayIndex& index, double startTime, bool loop = false);
+
+    // First cue at or after time
+    size_t Find(double time) const;
+
+    const std::vector<ReplayCue>& GetCues() const { return cues; }
+    bool IsComplete() const { return complete; }
+
+private:
+    std::vector<ReplayCue> cues;
+    std::vector<uint32_t> buckets; // First cue at or after each whole second
+    double startTime = 0.0;
+    bool complete = false;
+};
@@ -0,0 +1,48 @@
+#include "ReplayTimeline.h"
+
+#include <algorithm>
+
+void ReplayTimeline::Clear() {
+    checkpoints.clear();
+    journal.clear();
+    frontier = -1.0;
+    recording = false;
+}
+
+bool ReplayTimeline::Advance(double replayTime) {
+    recording = replayTime >= frontier;
+    if (recording) frontier = replayTime;
+    return recording;
+}
+
+bool ReplayTimeline::NeedsCheckpoint(double replayTime) const {
+    return recording && (checkpoints.empty() || replayTime - checkpoints.back().replayTime >= checkpointInterval);
+}
+
+void ReplayTimeline::AddCheckpoint(SeekCheckpoint checkpoint) {
+    if (!checkpoints.empty() && checkpoint.replayTime <= checkpoints.back().replayTime) return;
+    checkpoint.journalSize = journal.size();
+    checkpoints.push_back(std::move(checkpoint));
+}
+
+void ReplayTimeline::RecordEvent(const JournalEvent& event) {
+    if (!recording) return;
+    journal.push_back(event);
+    // Keeps the journal sorted if the host clock wobbles within a frame
+    if (journal.size() > 1) journal.back().replayTime = std::max(event.replayTime, journal[journal.size() - 2].replayTime);
+}
+
+const SeekCheckpoint* ReplayTimeline::FindCheckpoint(double replayTime) const {
+    if (checkpoints.empty()) return nullptr;
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), replayTime,
+        [](double time, const SeekCheckpoint& checkpoint) { return time < checkpoint.replayTime; });
+    return it == checkpoints.begin() ? &checkpoints.front() : &*(it - 1);
+}
+
+std::pair<const JournalEvent*, const JournalEvent*> ReplayTimeline::GetEvents(const SeekCheckpoint& from, double to) const {
+    auto first = journal.begin() + std::min(from.journalSize, journal.size());
+    auto last = std::upper_bound(first, journal.end(), to,
+        [](double time, const JournalEvent& event) { return time < event.replayTime; });
+    const JournalEvent* base = journal.data();
+    return { base + (first - journal.begin()), base + (last - journal.begin()) };
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "CameraController.h"
+#include "GameEvents.h"
+#include "SequenceGraph.h"
+
+// Step action that was waiting on its delay when a checkpoint was taken
+struct PendingReplayAction {
+    size_t step;
+    double replayTime; // When it fires
+};
+
+// Sequence engine state at one replay time
+struct SeekCheckpoint {
+    double replayTime = 0.0;
+    size_t journalSize = 0; // Events recorded before it, so same-time events replay
+    bool running = false;
+    uint64_t iterations = 0; // Of a looping sequence
+    SequenceGraphState graph;
+    std::vector<double> armedAt; // Replay time each active step was armed, in step order
+    std::vector<PendingReplayAction> pending; // In firing order
+    CameraSnapshot camera;
+};
+
+// An event the engine saw while watching. A seek replays what the event
+// did rather than matching it again, as bindings, conditions and races
+// were settled against state the journal doesn't keep.
+struct JournalEvent {
+    double replayTime;
+    GameEvent event;
+    float lead;     // Seconds until a predicted event actually happens
+    uint64_t fired; // Bit per step it fired
+};
+
+// What the engine saw while a replay played: checkpoints every interval of
+// replay time plus every event in between, both sorted by replay time. A
+// seek restores the last checkpoint at or before the target and replays
+// the journal from there, O(log n + k) for k events in between.
+//
+// Only the frontier is recorded (replays are deterministic), so scrubbing
+// back and playing forward again doesn't add duplicates. A seek past the
+// frontier moves it to the target; whatever happened in the skipped part
+// was never seen and stays empty.
+class ReplayTimeline {
+public:
+    explicit ReplayTimeline(double checkpointInterval = 1.0) : checkpointInterval(checkpointInterval) {
+    }
+
+    void Clear();
+
+    // Per frame while watching and after each seek; returns whether the
+    // engine is at the frontier, i.e. should record events and checkpoints
+    bool Advance(double replayTime);
+    bool IsRecording() const { return recording; }
+    double GetFrontier() const { return frontier; }
+
+    bool NeedsCheckpoint(double replayTime) const;
+    void AddCheckpoint(SeekCheckpoint checkpoint);
+    void RecordEvent(const JournalEvent& event);
+
+    // Last checkpoint at or before replayTime, else the first; nullptr if none
+    const SeekCheckpoint* FindCheckpoint(double replayTime) const;
+    // Journal events after the checkpoint, up to and including time to
+    std::pair<const JournalEvent*, const JournalEvent*> GetEvents(const SeekCheckpoint& from, double to) const;
+
+    size_t GetCheckpointCount() const { return checkpoints.size(); }
+    size_t GetEventCount() const { return journal.size(); }
+
+private:
+    double checkpointInterval;
+    std::vector<SeekCheckpoint> checkpoints;
+    std::vector<JournalEvent> journal;
+    double frontier = -1.0;
+    bool recording = false;
+};
@@ -0,0 +1,121 @@
+#include "Sequence.h"
+
+#include <algorithm>
+
+namespace {
+    struct ActionAlias {
+        std::string_view name;
+        CameraAction action;
+    };
+
+    // First entry per action is its canonical name; the rest are GUI aliases
+    constexpr ActionAlias actionNames[] = {
+        { "Enable Reverse Cam",      CameraAction::EnableReverseCam },
+        { "Disable Reverse Cam",     CameraAction::DisableReverseCam },
+        { "Toggle Reverse Cam",      CameraAction::ToggleReverseCam },
+        { "Toggle Swivel Direction", CameraAction::ToggleSwivelDirection },
+        { "Adjust Camera Yaw",       CameraAction::AdjustCameraYaw },
+        { "Enable Ball Cam",         CameraAction::EnableBallCam },
+        { "Disable Ball Cam",        CameraAction::DisableBallCam },
+        { "Rig Yaw",                 CameraAction::RigYaw },
+        { "Rig Pitch",               CameraAction::RigPitch },
+        { "Rig FOV",                 CameraAction::RigFov },
+        { "Rig Distance",            CameraAction::RigDistance },
+        { "Rig Height",              CameraAction::RigHeight },
+        { "Rig Angle",               CameraAction::RigAngle },
+        { "Camera Shake",            CameraAction::CameraShake },
+        { "Set Yaw",                 CameraAction::AdjustCameraYaw },
+    };
+
+    constexpr const char* bindingNames[] = { "Focus Car", "Any Car", "Blue Team", "Orange Team" };
+    static_assert(sizeof(bindingNames) / sizeof(bindingNames[0]) == CarBindingCount);
+
+    constexpr const char* playbackModeNames[] = { "once", "loop", "rearm" };
+    static_assert(sizeof(playbackModeNames) / sizeof(playbackModeNames[0]) == PlaybackModeCount);
+}
+
+const char* GetCarBindingName(CarBinding binding) {
+    size_t index = static_cast<size_t>(binding);
+    return index < CarBindingCount ? bindingNames[index] : "";
+}
+
+CarBinding FindCarBindingByName(std::string_view name) {
+    for (size_t i = 0; i < CarBindingCount; ++i) {
+        if (name == bindingNames[i]) return static_cast<CarBinding>(i);
+    }
+    return CarBinding::Focus;
+}
+
+const char* GetPlaybackModeName(PlaybackMode mode) {
+    size_t index = static_cast<size_t>(mode);
+    return index < PlaybackModeCount ? playbackModeNames[index] : "";
+}
+
+PlaybackMode FindPlaybackModeByName(std::string_view name) {
+    for (size_t i = 0; i < PlaybackModeCount; ++i) {
+        if (name == playbackModeNames[i]) return static_cast<PlaybackMode>(i);
+    }
+    return PlaybackMode::Once;
+}
+
+const char* GetActionName(CameraAction action) {
+    for (const auto& alias : actionNames) {
+        if (alias.action == action) return alias.name.data();
+    }
+    return "";
+}
+
+CameraAction FindActionByName(std::string_view name) {
+    for (const auto& alias : actionNames) {
+        if (alias.name == name) return alias.action;
+    }
+    return CameraAction::Invalid;
+}
+
+RigChannel GetActionRigChannel(CameraAction action) {
+    if (action < CameraAction::RigYaw || action > CameraAction::RigAngle) return RigChannel::Count;
+    return static_cast<RigChannel>(static_cast<uint8_t>(action) - static_cast<uint8_t>(CameraAction::RigYaw));
+}
+
+ActionValueRange GetActionValueRange(CameraAction action) {
+    switch (action) {
+    case CameraAction::AdjustCameraYaw:
+    case CameraAction::RigYaw:
+    case CameraAction::RigPitch:    return { -100.0f, 100.0f }; // Percent of the swivel limit
+    case CameraAction::RigFov:      return { 60.0f, 110.0f };
+    case CameraAction::RigDistance: return { 100.0f, 400.0f };
+    case CameraAction::RigHeight:   return { 40.0f, 200.0f };
+    case CameraAction::RigAngle:    return { -15.0f, 0.0f };
+    case CameraAction::CameraShake: return { 0.0f, 100.0f };
+    default:                        return {};
+    }
+}
+
+std::vector<SequenceStep> CompileSequence(const std::vector<ActionMapping>& mappings) {
+    std::vector<SequenceStep> steps;
+    steps.reserve(mappings.size());
+    for (const auto& mapping : mappings) {
+        size_t index = steps.size();
+        SequenceStep& step = steps.emplace_back();
+        step.event = FindEventByName(mapping.eventName);
+        step.action = FindActionByName(mapping.actionName);
+        step.delay = mapping.delay;
+        step.value = mapping.customValue;
+        step.transition.duration = mapping.duration;
+        step.transition.curve = FindEaseCurveByName(mapping.curve);
+        step.transition.spline = mapping.curve == "Hermite" ? SplineMode::Hermite : SplineMode::CatmullRom;
+        step.binding = FindCarBindingByName(mapping.car);
+        step.condition.Compile(mapping.condition);
+
+        bool root = false;
+        for (int number : mapping.after) {
+            if (number == 0) root = true;
+            else if (number > 0 && static_cast<size_t>(number) <= std::min(index, SequenceNodeCapacity)) step.after |= uint64_t(1) << (number - 1);
+        }
+        if (!step.after && !root && index > 0 && index <= SequenceNodeCapacity) step.after = uint64_t(1) << (index - 1);
+        step.joinAny = mapping.join == "Any";
+        step.timeout = std::max(mapping.timeout, 0.0f);
+        step.race = static_cast<uint8_t>(std::clamp(mapping.race, 0, 255));
+    }
+    return steps;
+}
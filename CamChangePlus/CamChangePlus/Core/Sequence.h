@@ -0,0 +1,125 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include "GameEvents.h"
+#include "Easing.h"
+#include "CameraRig.h"
+#include "Predicate.h"
+
+// One step of a shot as stored in the library and edited in the GUI
+struct ActionMapping {
+    std::string eventName;
+    std::string actionName;
+    float delay;
+    float customValue; // Custom value (e.g., swivel speed, FOV change)
+    float duration = 0.0f;       // Transition time for yaw/rig changes; 0 snaps
+    std::string curve = "Linear"; // EaseCurve name for yaw; "Hermite" settles rig keys (default Catmull-Rom)
+    std::string car = "Focus Car"; // CarBinding name: whose events the step reacts to
+    std::string condition;         // Predicate source, e.g. "car.speed > 1800"; empty always matches
+    // Step numbers (1-based) this step waits for; 0 is the start of the
+    // sequence. Empty follows the previous step, as in a plain list.
+    std::vector<int> after;
+    std::string join = "All";      // "Any" arms the step once one of its after steps fired
+    float timeout = 0.0f;          // Seconds the armed step waits before its branch is dropped; 0 never
+    int race = 0;                  // Steps sharing a race group > 0: the first to fire cancels the rest
+};
+
+// Which cars' events can satisfy a step
+enum class CarBinding : uint8_t {
+    Focus,      // The local or spectated car (the default)
+    AnyCar,
+    BlueTeam,
+    OrangeTeam,
+    Count
+};
+
+constexpr size_t CarBindingCount = static_cast<size_t>(CarBinding::Count);
+
+const char* GetCarBindingName(CarBinding binding);
+// Unknown names fall back to Focus
+CarBinding FindCarBindingByName(std::string_view name);
+
+// What playback does once every step of the shot has fired (or timed out)
+enum class PlaybackMode : uint8_t {
+    Once,  // Camera back to default and playback stops (the default)
+    Loop,  // Starts over at once, keeping the camera as the shot left it
+    Rearm, // Camera back to default, then starts over
+    Count
+};
+
+constexpr size_t PlaybackModeCount = static_cast<size_t>(PlaybackMode::Count);
+
+const char* GetPlaybackModeName(PlaybackMode mode);
+// Unknown names fall back to Once
+PlaybackMode FindPlaybackModeByName(std::string_view name);
+
+enum class CameraAction : uint8_t {
+    EnableReverseCam,
+    DisableReverseCam,
+    ToggleReverseCam,
+    ToggleSwivelDirection,
+    AdjustCameraYaw,
+    EnableBallCam,
+    DisableBallCam,
+    // Rig keys; customValue is the target in the channel's units
+    RigYaw,
+    RigPitch,
+    RigFov,
+    RigDistance,
+    RigHeight,
+    RigAngle,
+    CameraShake, // customValue = amplitude %, duration = fade-out (0 = until reset)
+    Count,
+    Invalid = 0xFF
+};
+
+const char* GetActionName(CameraAction action);
+CameraAction FindActionByName(std::string_view name);
+// Channel keyed by a Rig* action; RigChannel::Count for other actions
+RigChannel GetActionRigChannel(CameraAction action);
+
+// Values customValue can take for an action, in the action's units
+struct ActionValueRange {
+    float min = 0.0f;
+    float max = 0.0f;
+    bool IsEmpty() const { return max <= min; } // The action ignores its value
+};
+
+ActionValueRange GetActionValueRange(CameraAction action);
+
+// How a yaw or rig action moves to its value
+struct ActionTransition {
+    float duration = 0.0f;
+    EaseCurve curve = EaseCurve::Linear;
+    SplineMode spline = SplineMode::CatmullRom;
+};
+
+// Steps past this never arm; the graph keeps a bit per step
+constexpr size_t SequenceNodeCapacity = 64;
+
+// ActionMapping resolved to ids so dispatch never compares strings
+struct SequenceStep {
+    GameEvent event;
+    CameraAction action;
+    float delay;
+    float value;
+    ActionTransition transition;
+    CarBinding binding = CarBinding::Focus;
+    // Checked against the car and ball as the event arrives; an event that
+    // fails it leaves the step waiting
+    Predicate condition;
+    // Graph node (see SequenceGraph): bit per earlier step it waits for
+    uint64_t after = 0;
+    bool joinAny = false;
+    float timeout = 0.0f;
+    uint8_t race = 0;
+};
+
+// Steps with an unknown event or a condition that doesn't compile are kept
+// (they never match) so step indices stay aligned with the source mappings.
+// After references to anything but an earlier step are dropped, which
+// keeps the graph acyclic; a step left with none follows the previous one.
+std::vector<SequenceStep> CompileSequence(const std::vector<ActionMapping>& mappings);
@@ -0,0 +1,1129 @@
+#include "SequenceEngine.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+#include "Profiler.h"
+
+SequenceEngine::SequenceEngine(CamHost& host) : host(host), camera(host), hooks(host) {
+}
+
+void SequenceEngine::HookGameEvents() {
+    hooks.Resume();
+    host.Log("[CamChangePlus] Game hooks enabled (" + std::to_string(hooks.GetInstalledCount()) + " installed).");
+}
+
+void SequenceEngine::UnhookGameEvents() {
+    hooks.Suspend();
+    camera.ReleaseHooks();
+}
+
+void SequenceEngine::SubscribeEvent(GameEvent event) {
+    size_t index = static_cast<size_t>(event);
+    if (index >= GameEventCount) return;
+    if (eventRefs[index]++ > 0) return;
+
+    subscribedEvents |= EventBit(event);
+    const GameEventInfo& info = GetEventInfo(event);
+    if (info.source == EventSource::CarHook) {
+        hooks.Acquire(info.hookName, GetCarEventHandler(event));
+    }
+    else {
+        hooks.Acquire(*info.hookName ? info.hookName : tickHook, GetEventHandler(event));
+    }
+}
+
+void SequenceEngine::UnsubscribeEvent(GameEvent event) {
+    size_t index = static_cast<size_t>(event);
+    if (index >= GameEventCount || eventRefs[index] == 0) return;
+    if (--eventRefs[index] > 0) return;
+
+    subscribedEvents &= ~EventBit(event);
+    const GameEventInfo& info = GetEventInfo(event);
+    hooks.Release(*info.hookName ? info.hookName : tickHook);
+}
+
+size_t SequenceEngine::GetEventRefCount(GameEvent event) const {
+    size_t index = static_cast<size_t>(event);
+    return index < GameEventCount ? eventRefs[index] : 0;
+}
+
+std::function<void()> SequenceEngine::GetEventHandler(GameEvent event) {
+    switch (event) {
+    case GameEvent::BallTouch:    return [this]() { OnBallTouch(); };
+    case GameEvent::Explosion:    return [this]() { OnExplosion(); };
+    case GameEvent::Jump:         return [this]() { OnJump(); };
+    case GameEvent::DoubleJump:   return [this]() { OnDoubleJump(); };
+    case GameEvent::Flip:         return [this]() { OnFlip(); };
+    case GameEvent::Demolition:   return [this]() { OnDemolition(); };
+    case GameEvent::KickoffStart: return [this]() { OnKickoffStart(); };
+    default:                      return [this]() { OnTick(); }; // Tick and predicted events
+    }
+}
+
+std::function<void(CarHandle)> SequenceEngine::GetCarEventHandler(GameEvent event) {
+    return [this, event, handler = GetEventHandler(event)](CarHandle caller) {
+        if (IsFocusCar(caller)) {
+            // The jump checks read the caller's own state, which is not the
+            // local car's while spectating
+            if (event == GameEvent::Jump) OnJump(caller);
+            else if (event == GameEvent::DoubleJump) OnDoubleJump(caller);
+            else handler();
+            return;
+        }
+        // The tracker reports its events for other cars on the tick
+        EventMask bit = EventBit(event);
+        if ((GetOtherCarMask() & bit) && !(CarTracker::trackedEvents & bit)) {
+            MarkHookEntry();
+            RaiseEvent(event, caller);
+            return;
+        }
+        otherCarEvents++;
+        if (otherCarObserver) otherCarObserver(event, caller);
+    };
+}
+
+bool SequenceEngine::IsFocusCar(CarHandle caller) {
+    // Hosts that can't resolve the caller don't filter
+    if (caller == 0 || caller == focusCar) return true;
+
+    // Respawns, demolitions and spectator switches change the focus car. It
+    // can only change between ticks, so one refresh per tick is enough.
+    double now = host.GetTime();
+    if (now - focusCarRefreshTime < 0.5 / TraceTickRate) return false;
+    focusCarRefreshTime = now;
+    focusCar = host.GetFocusCar();
+    return caller == focusCar;
+}
+
+bool SequenceEngine::GetCallerState(CarHandle caller, CarState& state) {
+    return caller ? host.GetCarState(caller, state) : host.GetLocalCarState(state);
+}
+
+bool SequenceEngine::BindingAccepts(CarBinding binding, GameEvent event, CarHandle car) const {
+    if (!IsCarEvent(event)) return true;
+    switch (binding) {
+    case CarBinding::AnyCar:     return true;
+    case CarBinding::BlueTeam:   return carTracker.FindTeam(car ? car : focusCar) == 0;
+    case CarBinding::OrangeTeam: return carTracker.FindTeam(car ? car : focusCar) == 1;
+    default:                     return car == 0 || car == focusCar;
+    }
+}
+
+void SequenceEngine::ArmSequence() {
+    DisarmSequence();
+    for (const SequenceStep& step : steps) {
+        if (step.binding != CarBinding::Focus && IsCarEvent(step.event)) otherCarArmed |= EventBit(step.event);
+        if (std::find(armedEvents.begin(), armedEvents.end(), step.event) != armedEvents.end()) continue;
+        armedEvents.push_back(step.event);
+        SubscribeEvent(step.event);
+    }
+    // Team bindings need every car's team, and other cars' tracked events
+    // come from the tick
+    if (otherCarArmed) {
+        carTracker.Reset();
+        hooks.Acquire(tickHook, [this]() { OnTick(); });
+    }
+}
+
+void SequenceEngine::DisarmSequence() {
+    for (GameEvent event : armedEvents) UnsubscribeEvent(event);
+    armedEvents.clear();
+    if (otherCarArmed) hooks.Release(tickHook);
+    otherCarArmed = 0;
+}
+
+void SequenceEngine::SetTraceRecorder(TraceRecorder* traceRecorder) {
+    if (traceRecorder && !recorder) {
+        for (size_t i = 0; i < GameEventCount; ++i) SubscribeEvent(static_cast<GameEvent>(i));
+    }
+    else if (!traceRecorder && recorder) {
+        for (size_t i = 0; i < GameEventCount; ++i) UnsubscribeEvent(static_cast<GameEvent>(i));
+    }
+    recorder = traceRecorder;
+}
+
+void SequenceEngine::OnBallTouch() {
+    CCP_TRACE_SCOPE("OnBallTouch");
+    MarkHookEntry();
+    RaiseEvent(GameEvent::BallTouch);
+}
+
+void SequenceEngine::OnExplosion() {
+    CCP_TRACE_SCOPE("OnExplosion");
+    MarkHookEntry();
+    RaiseEvent(GameEvent::Explosion);
+}
+
+void SequenceEngine::OnJump(CarHandle caller) {
+    CCP_TRACE_SCOPE("OnJump");
+    MarkHookEntry();
+    CarState car;
+    if (!GetCallerState(caller, car)) return;
+
+    // If onGround == 1, it means a jump happened
+    if (car.onGround) {
+        RaiseEvent(GameEvent::Jump);
+    }
+}
+
+void SequenceEngine::OnDoubleJump(CarHandle caller) {
+    CCP_TRACE_SCOPE("OnDoubleJump");
+    MarkHookEntry();
+    CarState car;
+    if (!GetCallerState(caller, car)) return;
+
+    // If onGround == 0, it means a double jump happened
+    if (!car.onGround) {
+        RaiseEvent(GameEvent::DoubleJump);
+    }
+}
+
+void SequenceEngine::OnFlip() {
+    CCP_TRACE_SCOPE("OnFlip");
+    MarkHookEntry();
+    if (hasFlipped) return;
+
+    RaiseEvent(GameEvent::Flip);
+}
+
+void SequenceEngine::OnDemolition() {
+    CCP_TRACE_SCOPE("OnDemolition");
+    MarkHookEntry();
+    RaiseEvent(GameEvent::Demolition);
+}
+
+void SequenceEngine::OnKickoffStart() {
+    CCP_TRACE_SCOPE("OnKickoffStart");
+    MarkHookEntry();
+    RaiseEvent(GameEvent::KickoffStart);
+}
+
+void SequenceEngine::OnTick() {
+    // The hook fires once per car; only the first call of a tick scans.
+    // Live hosts stamp each call separately, so compare against half a tick.
+    double now = host.GetTime();
+    if (now - lastTickTime < 0.5 / TraceTickRate) return;
+    lastTickTime = now;
+
+    CCP_TRACE_SCOPE("OnTick");
+    auto scanStart = std::chrono::steady_clock::now();
+    WorldSnapshot snapshot;
+    snapshot.time = now;
+    snapshot.hasCar = host.GetLocalCarState(snapshot.car);
+    snapshot.hasBall = host.GetBallState(snapshot.ball);
+    EventMask fired = eventDetector.Scan(snapshot);
+
+    auto costUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - scanStart).count());
+    tickScanCost.Record(costUs);
+    if (costUs > tickScanBudgetUs) {
+        // Logged on the 1st, 2nd, 4th, 8th... overrun so a slow machine doesn't flood the console
+        tickScanOverBudget++;
+        if ((tickScanOverBudget & (tickScanOverBudget - 1)) == 0) {
+            host.Log("[CamChangePlus] Tick scan took " + std::to_string(costUs) + " us (budget " +
+                std::to_string(tickScanBudgetUs) + " us, " + std::to_string(tickScanOverBudget) + " overruns)");
+        }
+    }
+
+    // In catalog order, so two steps completing on the same tick advance in a
+    // fixed order. Levels are tracked for every detector so a subscription
+    // never starts mid-edge, but only subscribed events are dispatched.
+    for (EventMask remaining = fired & subscribedEvents; remaining; remaining &= remaining - 1) {
+        auto event = static_cast<GameEvent>(std::countr_zero(remaining));
+        MarkHookEntry();
+        RaiseEvent(event);
+    }
+
+    if (GetOtherCarMask()) TrackCars(now);
+    if (snapshot.hasBall) PredictBall(snapshot.ball);
+    if (replayScanning && snapshot.hasBall) ScanBallHits(snapshot.ball);
+
+    // WaitTicks resumes after the tick's events
+    TickTasks();
+}
+
+void SequenceEngine::TickTasks() {
+    if (!runtime.HasTickWaiters()) return;
+    runtime.Tick(CurrentTick());
+    SyncRuntimeHooks();
+}
+
+void SequenceEngine::TrackCars(double now) {
+    matchCarCount = host.GetCars(matchCars.data(), matchCars.size());
+    float dt = lastCarTrackTime >= 0.0 ? static_cast<float>(now - lastCarTrackTime) : 0.0f;
+    lastCarTrackTime = now;
+    carTracker.Update(matchCars.data(), matchCarCount, dt);
+
+    // The focus car's own events already came from its hooks and the
+    // detectors; it may have just been demolished, so check the old one too
+    CarHandle previousFocus = focusCar;
+    focusCar = host.GetFocusCar();
+    focusCarRefreshTime = now;
+
+    const CarEvent* events = carTracker.GetEvents();
+    for (size_t i = 0; i < carTracker.GetEventCount(); ++i) {
+        const CarEvent& tracked = events[i];
+        if (tracked.car == focusCar || tracked.car == previousFocus) continue;
+        if (!(GetOtherCarMask() & EventBit(tracked.event))) continue;
+        MarkHookEntry();
+        RaiseEvent(tracked.event, tracked.car);
+    }
+}
+
+void SequenceEngine::RaiseEvent(GameEvent event, CarHandle car) {
+    switch (eventFilter.Offer(event, CurrentTick())) {
+    case EventFilter::Verdict::Pass:
+        DispatchEvent(event, 1, car);
+        break;
+    case EventFilter::Verdict::Defer:
+        trailingCars[static_cast<size_t>(event)] = car;
+        ScheduleTrailingEvent(event);
+        hookEntryTime = -1.0;
+        break;
+    default:
+        hookEntryTime = -1.0;
+        break;
+    }
+}
+
+void SequenceEngine::DispatchEvent(GameEvent event, uint32_t count, CarHandle car) {
+    std::string message = "[CamChangePlus] " + std::string(GetEventName(event)) + " Detected!";
+    if (count > 1) message += " (x" + std::to_string(count) + ")";
+    if (car != 0 && car != focusCar) {
+        int team = carTracker.FindTeam(car);
+        message += team == 0 ? " (blue car)" : team == 1 ? " (orange car)" : " (other car)";
+    }
+    host.Log(message);
+    ProcessEventActions(event, 0.0f, car);
+}
+
+void SequenceEngine::ScheduleTrailingEvent(GameEvent event) {
+    // At least a tick, so rounding can't spin on a deadline that is still ahead
+    uint64_t deadline = eventFilter.GetDeadline(event);
+    uint64_t now = CurrentTick();
+    uint64_t ticks = deadline > now ? deadline - now : 1;
+    host.SetTimeout([this, event]() { CloseTrailingEvent(event); }, static_cast<float>(ticks / TraceTickRate));
+}
+
+void SequenceEngine::CloseTrailingEvent(GameEvent event) {
+    uint32_t count = eventFilter.Close(event, CurrentTick());
+    if (count > 0) {
+        MarkHookEntry();
+        DispatchEvent(event, count, trailingCars[static_cast<size_t>(event)]);
+    }
+    else if (eventFilter.IsOpen(event)) {
+        // Coalesced occurrences pushed the deadline back
+        ScheduleTrailingEvent(event);
+    }
+}
+
+uint64_t SequenceEngine::CurrentTick() {
+    return static_cast<uint64_t>(host.GetTime() * TraceTickRate);
+}
+
+void SequenceEngine::PredictBall(const BallState& ball) {
+    EventMask predicted = 0;
+    for (size_t i = 0; i < BallHitKindCount; ++i) predicted |= EventBit(GetPredictedEvent(static_cast<BallHitKind>(i)));
+    predicted &= runtime.GetWaitedEvents();
+    if (!predicted) return;
+
+    ballPredictor.Predict(ball, ballPrediction);
+
+    for (size_t i = 0; i < BallHitKindCount; ++i) {
+        auto kind = static_cast<BallHitKind>(i);
+        GameEvent event = GetPredictedEvent(kind);
+        if (!(predicted & EventBit(event))) continue;
+        const PredictedHit& hit = ballPrediction.Get(kind);
+        if (!hit.valid) continue;
+
+        // Dispatch once the action's moment (hit + delay, or just the hit for
+        // positive delays) falls within the next tick; the earliest armed step
+        // on the event decides. Only the shot's steps have a delay; tasks get
+        // the hit itself.
+        float early = 0.0f;
+        for (uint64_t armed = graphState.active; armed; armed &= armed - 1) {
+            const SequenceStep& step = steps[std::countr_zero(armed)];
+            if (step.event == event) early = std::min(early, step.delay);
+        }
+        if (hit.time + early > ballPredictor.GetOptions().timeStep) continue;
+
+        double occurrence = lastTickTime + hit.time;
+        double& last = lastPredictedOccurrence[i];
+        if (occurrence - last < predictionDedupe) continue;
+        last = occurrence;
+
+        MarkHookEntry();
+        host.Log("[CamChangePlus] " + std::string(GetEventName(event)) + " in " +
+            std::to_string(static_cast<int>(hit.time * TraceTickRate + 0.5f)) + " ticks");
+        ProcessEventActions(event, hit.time);
+    }
+}
+
+void SequenceEngine::ResetTickScanCost() {
+    tickScanCost.Reset();
+    tickScanOverBudget = 0;
+}
+
+void SequenceEngine::SetLatencyMonitor(LatencyMonitor* monitor) {
+    latency = monitor;
+    camera.SetLatencyMonitor(monitor);
+}
+
+void SequenceEngine::SetSequence(const std::string& name, std::vector<ActionMapping> actions) {
+    currentSequenceName = name;
+    eventActions = std::move(actions);
+    steps = CompileSequence(eventActions);
+    graph.Build(steps);
+    currentTasIndex = 0;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (steps[i].condition.IsValid()) continue;
+        host.Log("[CamChangePlus] Error: step " + std::to_string(i + 1) + " condition \"" + eventActions[i].condition +
+            "\": " + steps[i].condition.GetError() + " (the step never matches)");
+    }
+    if (steps.size() > SequenceGraph::maxNodes) {
+        host.Log("[CamChangePlus] Error: only the first " + std::to_string(SequenceGraph::maxNodes) +
+            " steps of a sequence play; " + std::to_string(steps.size()) + " mapped.");
+    }
+    // Checkpoints and cues hold step indices of the old steps
+    if (cuePlayback) StartCuePlayback();
+    else if (tasRunning) StartGraph();
+    if (replayTracking) StartReplayTracking();
+}
+
+void SequenceEngine::ProcessEventActions(GameEvent event, float eventLead, CarHandle car) {
+    CCP_TRACE_SCOPE("ProcessEventActions");
+    // Bindings are only worked out for events some task is waiting on
+    bool waited = static_cast<size_t>(event) < GameEventCount && (runtime.GetWaitedEvents() & EventBit(event));
+    uint8_t bindings = waited ? GetAcceptedBindings(event, car) : 0;
+    // Conditions see the car and ball as the event arrives
+    WorldSnapshot snapshot;
+    if (waited && (runtime.GetConditionalEvents() & EventBit(event))) TakeEventSnapshot(car, snapshot);
+    bool matched = waited && runtime.IsWaiting(event, bindings, snapshot);
+    // Predicted events are scanned at the hit itself (ScanBallHits)
+    if (replayScanning && !IsPredictedEvent(event)) {
+        double replayTime;
+        if (host.GetReplayTime(replayTime)) replayIndex.Add(replayTime, event, GetAcceptedBindings(event, car));
+    }
+
+    if (recorder) {
+        uint8_t flags = (tasRunning ? TraceFlag_Running : 0) | (matched ? TraceFlag_Matched : 0);
+        RecordTrace(TraceRecordType::Event, event, CameraAction::Invalid, currentTasIndex, flags, eventLead, 0, car);
+    }
+
+    // The waiting tasks run inside the dispatch (PlayStep for the shot's steps)
+    firedSteps = 0;
+    if (matched) {
+        runtime.Dispatch({ event, eventLead, car }, bindings, snapshot, CurrentTick());
+        SyncRuntimeHooks();
+    }
+    if (replayTracking && replayTimeline.IsRecording()) RecordJournalEvent(event, eventLead, firedSteps);
+    hookEntryTime = -1.0;
+}
+
+SequenceTask SequenceEngine::PlayStep(size_t index, uint32_t timeoutTicks) {
+    const SequenceStep& waiting = steps[index];
+    SequenceEvent arrived = co_await WaitFor(waiting.event, waiting.binding, &waiting.condition).Within(timeoutTicks);
+    stepTasks[index] = 0;
+    if (arrived.event == GameEvent::Invalid) TimeOutStep(index);
+    else FireStep(index, arrived.lead);
+}
+
+void SequenceEngine::FireStep(size_t index, float eventLead) {
+    const SequenceStep& step = steps[index];
+    // Negative delays count back from a predicted event; nothing fires in the past
+    float delay = std::max(step.delay + eventLead, 0.0f);
+
+    LatencyStamp stamp;
+    if (latency) {
+        stamp.scheduledTime = host.GetTime();
+        stamp.hookTime = hookEntryTime >= 0.0 ? hookEntryTime : stamp.scheduledTime;
+        stamp.intendedTime = stamp.scheduledTime + delay;
+        latency->Record(LatencyStage::HookToScheduled, stamp.scheduledTime - stamp.hookTime);
+    }
+    bool immediate = delay <= 0.0f;
+    if (!immediate) {
+        ScheduleAction(index, delay, stamp);
+    }
+
+    // Arms what follows and drops the step's race group
+    firedSteps |= uint64_t(1) << index;
+    ApplyGraphUpdate(graph.Fire(graphState, index));
+    currentTasIndex = std::popcount(graphState.fired);
+
+    // If TAS has finished executing all actions, reset (or go around again)
+    if (graph.IsFinished(graphState)) {
+        FinishGraph();
+    }
+
+    // Runs after the reset so a final zero-delay step still lands, same as a timer would
+    if (immediate) {
+        RunActionNow(index, stamp);
+    }
+}
+
+void SequenceEngine::TimeOutStep(size_t index) {
+    host.Log("[CamChangePlus] Step " + std::to_string(index + 1) + " timed out; dropping its branch.");
+    ApplyGraphUpdate(graph.Cancel(graphState, uint64_t(1) << index));
+    if (graph.IsFinished(graphState)) FinishGraph();
+}
+
+void SequenceEngine::FinishGraph() {
+    if (playbackMode == PlaybackMode::Once) {
+        CompleteSequence();
+        return;
+    }
+
+    // The steps' events stay subscribed, so the next iteration costs a few
+    // pooled task frames. Roots armed from inside a dispatch wait for the
+    // next event, not the one that finished this iteration.
+    iterations++;
+    host.Log("[CamChangePlus] Sequence finished; " + std::string(GetPlaybackModeName(playbackMode)) +
+        " iteration " + std::to_string(iterations + 1) + ".");
+    if (playbackMode == PlaybackMode::Rearm) ResetCamera();
+    currentTasIndex = 0;
+    ApplyGraphUpdate(graph.Start(graphState));
+}
+
+void SequenceEngine::TakeEventSnapshot(CarHandle car, WorldSnapshot& snapshot) {
+    snapshot.time = host.GetTime();
+    snapshot.hasBall = host.GetBallState(snapshot.ball);
+
+    // Another car's event reads that car as of the last tracker update
+    if (car != 0 && car != focusCar) {
+        auto last = matchCars.begin() + matchCarCount;
+        auto it = std::find_if(matchCars.begin(), last, [car](const MatchCar& matchCar) { return matchCar.handle == car; });
+        if (it != last) {
+            snapshot.hasCar = true;
+            snapshot.car = it->state;
+            return;
+        }
+    }
+    snapshot.hasCar = host.GetLocalCarState(snapshot.car);
+}
+
+void SequenceEngine::StartGraph() {
+    StopStepTasks();
+    ArmSequence();
+    ApplyGraphUpdate(graph.Start(graphState));
+    SyncRuntimeHooks();
+}
+
+void SequenceEngine::ResumeGraph(const std::array<double, SequenceGraph::maxNodes>& armedAt, double replayTime) {
+    StopStepTasks();
+    ArmSequence();
+    double now = host.GetTime();
+    for (uint64_t armed = graphState.active; armed; armed &= armed - 1) {
+        size_t index = std::countr_zero(armed);
+        ArmStep(index, now - (replayTime - armedAt[index]));
+    }
+    SyncRuntimeHooks();
+}
+
+void SequenceEngine::StopGraph() {
+    StopStepTasks();
+    graphState.active = 0;
+    DisarmSequence();
+    SyncRuntimeHooks();
+}
+
+void SequenceEngine::StopStepTasks() {
+    for (SequenceRuntime::TaskId& task : stepTasks) {
+        if (task) runtime.Cancel(task);
+        task = 0;
+    }
+}
+
+void SequenceEngine::ApplyGraphUpdate(const SequenceGraphUpdate& update) {
+    for (uint64_t dropped = update.cancelled; dropped; dropped &= dropped - 1) {
+        SequenceRuntime::TaskId& task = stepTasks[std::countr_zero(dropped)];
+        if (task) runtime.Cancel(task);
+        task = 0;
+    }
+    double now = host.GetTime();
+    for (uint64_t ready = update.ready; ready; ready &= ready - 1) ArmStep(std::countr_zero(ready), now);
+}
+
+void SequenceEngine::ArmStep(size_t index, double armedTime) {
+    stepArmedTime[index] = armedTime;
+    uint32_t timeoutTicks = 0;
+    if (steps[index].timeout > 0.0f) {
+        // At least a tick, so a timeout that already ran out fires on the next one
+        double remaining = steps[index].timeout - (host.GetTime() - armedTime);
+        timeoutTicks = static_cast<uint32_t>(std::max(std::ceil(remaining * TraceTickRate), 1.0));
+    }
+    stepTasks[index] = runtime.Spawn(PlayStep(index, timeoutTicks), CurrentTick());
+}
+
+SequenceRuntime::TaskId SequenceEngine::RunTask(SequenceTask task) {
+    SequenceRuntime::TaskId id = runtime.Spawn(std::move(task), CurrentTick());
+    SyncRuntimeHooks();
+    return id;
+}
+
+void SequenceEngine::CancelTask(SequenceRuntime::TaskId id) {
+    runtime.Cancel(id);
+    SyncRuntimeHooks();
+}
+
+void SequenceEngine::SyncRuntimeHooks() {
+    EventMask waited = runtime.GetWaitedEvents();
+    for (EventMask changed = waited ^ runtimeArmed; changed; changed &= changed - 1) {
+        auto event = static_cast<GameEvent>(std::countr_zero(changed));
+        if (waited & EventBit(event)) SubscribeEvent(event);
+        else UnsubscribeEvent(event);
+    }
+    runtimeArmed = waited;
+
+    // WaitTicks and other cars' events come from the tick
+    bool ticking = runtime.HasTickWaiters() || runtime.GetOtherCarEvents();
+    if (ticking == runtimeTicking) return;
+    runtimeTicking = ticking;
+    if (ticking) {
+        if (!(otherCarArmed | scanCarEvents)) carTracker.Reset();
+        hooks.Acquire(tickHook, [this]() { OnTick(); });
+    }
+    else {
+        hooks.Release(tickHook);
+    }
+}
+
+void SequenceEngine::ExecuteAction(CameraAction action, float value, const ActionTransition& transition) {
+    CCP_TRACE_SCOPE("ExecuteAction");
+    switch (action) {
+    case CameraAction::EnableReverseCam:
+        camera.SetReverseCam(true);
+        break;
+    case CameraAction::DisableReverseCam:
+        camera.SetReverseCam(false);
+        break;
+    case CameraAction::ToggleReverseCam:
+        camera.ToggleReverseCam();
+        break;
+    case CameraAction::ToggleSwivelDirection:
+        camera.ToggleSwivelDirection();
+        break;
+    case CameraAction::AdjustCameraYaw:
+        camera.AdjustCameraYaw(camera.IsYawDirectionRight() ? value : -value, transition.duration, transition.curve); // Use toggled direction
+        break;
+    case CameraAction::EnableBallCam:
+        camera.ToggleBallCam(true);
+        break;
+    case CameraAction::DisableBallCam:
+        camera.ToggleBallCam(false);
+        break;
+    case CameraAction::RigYaw:
+    case CameraAction::RigPitch:
+    case CameraAction::RigFov:
+    case CameraAction::RigDistance:
+    case CameraAction::RigHeight:
+    case CameraAction::RigAngle:
+        camera.KeyRig(GetActionRigChannel(action), value, transition.duration, transition.spline);
+        break;
+    case CameraAction::CameraShake:
+        camera.Shake(value, transition.duration);
+        break;
+    default:
+        host.Log("[CamChangePlus] Error: Unknown action.");
+        return;
+    }
+
+    host.Log("[CamChangePlus] Executed Action: " + std::string(GetActionName(action)) + " with value: " + std::to_string(value));
+}
+
+void SequenceEngine::ScheduleAction(size_t step, float delay, LatencyStamp stamp) {
+    const SequenceStep& source = steps[step];
+    uint64_t id = nextScheduledId++;
+    scheduledActions.push_back({ id, step, source.event, source.action, source.value, source.transition,
+        host.GetTime() + delay, stamp });
+    host.SetTimeout([this, id]() { FireScheduled(id); }, delay);
+}
+
+void SequenceEngine::RunActionNow(size_t step, LatencyStamp stamp) {
+    // Earlier steps whose timers are due but haven't run yet go first
+    RunDueActions();
+
+    const SequenceStep& source = steps[step];
+    ScheduledAction now{ nextScheduledId++, step, source.event, source.action, source.value, source.transition,
+        host.GetTime(), stamp };
+    FireAction(now);
+}
+
+void SequenceEngine::RunDueActions() {
+    double now = host.GetTime();
+    while (!scheduledActions.empty() && scheduledActions.front().intendedTime <= now) {
+        FireScheduled(scheduledActions.front().id);
+    }
+}
+
+void SequenceEngine::FireScheduled(uint64_t id) {
+    // Already run early by RunDueActions; the timer is a no-op
+    auto it = std::find_if(scheduledActions.begin(), scheduledActions.end(),
+        [id](const ScheduledAction& scheduled) { return scheduled.id == id; });
+    if (it == scheduledActions.end()) return;
+
+    ScheduledAction scheduled = *it;
+    scheduledActions.erase(it);
+    FireAction(scheduled);
+}
+
+void SequenceEngine::FireAction(ScheduledAction& scheduled) {
+    LatencyStamp& stamp = scheduled.stamp;
+    if (latency && stamp.IsValid()) {
+        stamp.executedTime = host.GetTime();
+        latency->Record(LatencyStage::TimerLateness, stamp.executedTime - stamp.intendedTime);
+    }
+
+    camera.SetActionStamp(stamp);
+    ExecuteAction(scheduled.action, scheduled.value, scheduled.transition);
+    camera.SetActionStamp({});
+
+    if (actionObserver) actionObserver(scheduled.step, scheduled.action, scheduled.value);
+    if (recorder) {
+        auto latencyUs = static_cast<int32_t>((host.GetTime() - scheduled.intendedTime) * 1e6);
+        RecordTrace(TraceRecordType::ActionFired, scheduled.event, scheduled.action, scheduled.step,
+            tasRunning ? TraceFlag_Running : 0, scheduled.value, latencyUs);
+    }
+}
+
+void SequenceEngine::RecordTrace(TraceRecordType type, GameEvent event, CameraAction action, size_t step, uint8_t flags, float value, int32_t latencyUs, CarHandle car) {
+    double now = host.GetTime();
+    TraceRecord record{};
+    record.tick = static_cast<uint64_t>(now * TraceTickRate);
+    record.time = now;
+    record.type = static_cast<uint8_t>(type);
+    record.eventId = static_cast<uint8_t>(event);
+    record.actionId = static_cast<uint8_t>(action);
+    record.step = static_cast<uint16_t>(step);
+    record.latencyUs = latencyUs;
+    record.value = value;
+
+    // Car identity and snapshot only for events, of the car that raised
+    // them; actions are tied to the event record by step
+    CarState state;
+    if (type == TraceRecordType::Event) record.bindings = GetAcceptedBindings(event, car);
+    if (type == TraceRecordType::Event && GetCallerState(car, state)) {
+        flags |= TraceFlag_HasCar | (state.onGround ? TraceFlag_OnGround : 0) | (state.supersonic ? TraceFlag_Supersonic : 0);
+        record.location[0] = state.location.X;
+        record.location[1] = state.location.Y;
+        record.location[2] = state.location.Z;
+        record.velocity[0] = state.velocity.X;
+        record.velocity[1] = state.velocity.Y;
+        record.velocity[2] = state.velocity.Z;
+        record.boost = state.boost;
+    }
+    record.flags = flags;
+
+    recorder->Record(record);
+}
+
+void SequenceEngine::ResetCamera() {
+    // Turn off Reverse Cam if it was enabled
+    camera.SetReverseCam(false);
+
+    // Reset Camera Yaw to 0
+    camera.AdjustCameraYaw(0.0f);
+
+    // Drop rig tracks and restore the player's camera settings
+    camera.ReleaseRig();
+    camera.StopShake();
+}
+
+void SequenceEngine::ResetToDefault() {
+    runtime.Clear();
+    CompleteSequence();
+    SyncRuntimeHooks();
+}
+
+void SequenceEngine::CompleteSequence() {
+    host.Log("[CamChangePlus] Resetting to default settings...");
+    ResetCamera();
+
+    // Stop TAS execution; hooks nothing else needs come off after this tick
+    tasRunning = false;
+    currentTasIndex = 0;
+    StopStepTasks();
+    graphState.active = 0; // What fired and what was dropped stays readable
+    DisarmSequence();
+
+    host.Log("[CamChangePlus] TAS reset complete.");
+}
+
+void SequenceEngine::StartSequencePlayback() {
+    if (steps.empty()) {
+        host.Log("[CamChangePlus] No actions mapped!");
+        return;
+    }
+
+    tasRunning = true;
+    currentTasIndex = 0;
+    iterations = 0;
+    // A scanned replay needs no live detection; anything else is matched live
+    if (StartCuePlayback()) {
+        StopGraph();
+        StopReplayTracking();
+    }
+    else {
+        StartGraph();
+        StartReplayTracking();
+    }
+    host.Log("[CamChangePlus] TAS Started!");
+}
+
+void SequenceEngine::StopSequencePlayback() {
+    host.Log("[CamChangePlus] TAS Stopped by user.");
+    ResetToDefault();
+    StopReplayTracking();
+    StopCuePlayback();
+}
+
+void SequenceEngine::StartReplayTracking() {
+    double replayTime;
+    if (!host.GetReplayTime(replayTime)) {
+        StopReplayTracking();
+        return;
+    }
+
+    // Stays on after the sequence completes, so scrubbing back replays it
+    if (!replayTracking) hooks.Acquire(replayFrameHook, [this]() { OnReplayFrame(); });
+    replayTracking = true;
+    replayTimeline.Clear();
+    lastReplayTime = replayTime;
+    lastReplayFrameTime = host.GetTime();
+    replayTimeline.Advance(replayTime);
+    replayTimeline.AddCheckpoint(CaptureCheckpoint(replayTime));
+}
+
+void SequenceEngine::StopReplayTracking() {
+    if (!replayTracking) return;
+    hooks.Release(replayFrameHook);
+    replayTracking = false;
+    replayTimeline.Clear();
+}
+
+void SequenceEngine::OnReplayFrame() {
+    double replayTime;
+    if (!host.GetReplayTime(replayTime)) {
+        // Left the replay
+        StopReplayScan();
+        StopReplayTracking();
+        StopCuePlayback();
+        return;
+    }
+
+    double now = host.GetTime();
+    double replayDelta = replayTime - lastReplayTime;
+    double hostDelta = now - lastReplayFrameTime;
+    bool seek = replayDelta < 0.0 || replayDelta > hostDelta + seekThreshold;
+    lastReplayTime = replayTime;
+    lastReplayFrameTime = now;
+
+    // A scan only moves its frontier; what a forward seek skipped stays unscanned
+    if (replayScanning) replayIndex.Advance(replayTime);
+    if (cuePlayback) {
+        if (seek) SeekCues(replayTime);
+        else PlayCues(replayTime);
+    }
+    if (!replayTracking) return;
+    if (seek) {
+        SeekReplay(replayTime);
+    }
+    else if (replayTimeline.Advance(replayTime) && replayTimeline.NeedsCheckpoint(replayTime)) {
+        replayTimeline.AddCheckpoint(CaptureCheckpoint(replayTime));
+    }
+}
+
+bool SequenceEngine::StartReplayScan() {
+    double replayTime;
+    std::string replayId = host.GetReplayId();
+    if (!host.GetReplayTime(replayTime) || replayId.empty()) {
+        host.Log("[CamChangePlus] Replay scan: not watching a replay.");
+        return false;
+    }
+    if (replayScanning) return true;
+
+    replayScanning = true;
+    replayIndex.Clear();
+    replayIndexId = replayId;
+    replayIndex.Advance(replayTime);
+    lastScannedHit.fill(-1.0e9);
+    lastReplayTime = replayTime;
+    lastReplayFrameTime = host.GetTime();
+
+    // Every event of every car, plus the tick for the car tracker and the ball
+    for (size_t i = 0; i < GameEventCount; ++i) {
+        auto event = static_cast<GameEvent>(i);
+        SubscribeEvent(event);
+        if (IsCarEvent(event)) scanCarEvents |= EventBit(event);
+    }
+    carTracker.Reset();
+    hooks.Acquire(tickHook, [this]() { OnTick(); });
+    hooks.Acquire(replayFrameHook, [this]() { OnReplayFrame(); });
+    host.Log("[CamChangePlus] Scanning replay " + replayId + " from " + std::to_string(replayTime) +
+        "s; play it through at any speed.");
+    return true;
+}
+
+void SequenceEngine::StopReplayScan() {
+    if (!replayScanning) return;
+    for (size_t i = 0; i < GameEventCount; ++i) UnsubscribeEvent(static_cast<GameEvent>(i));
+    hooks.Release(tickHook);
+    hooks.Release(replayFrameHook);
+    scanCarEvents = 0;
+    replayScanning = false;
+
+    replayIndex.Finish();
+    std::filesystem::path filepath = ReplayIndex::DefaultPath(host.GetDataFolder(), replayIndexId);
+    if (replayIndex.Save(filepath)) {
+        host.Log("[CamChangePlus] Replay index saved: " + std::to_string(replayIndex.GetEntries().size()) +
+            " events over " + std::to_string(replayIndex.GetDuration()) + "s to " + filepath.string());
+    }
+    else {
+        host.Log("[CamChangePlus] Error: could not save the replay index to " + filepath.string());
+    }
+}
+
+void SequenceEngine::ScanBallHits(const BallState& ball) {
+    double replayTime;
+    if (!host.GetReplayTime(replayTime)) return;
+
+    // Indexed at the hit itself once it is within the next tick
+    ballPredictor.Predict(ball, scanPrediction);
+    uint8_t anyCar = (1 << CarBindingCount) - 1;
+    for (size_t i = 0; i < BallHitKindCount; ++i) {
+        const PredictedHit& hit = scanPrediction.hits[i];
+        if (!hit.valid || hit.time > ballPredictor.GetOptions().timeStep) continue;
+
+        double occurrence = replayTime + hit.time;
+        if (occurrence - lastScannedHit[i] < predictionDedupe) continue;
+        lastScannedHit[i] = occurrence;
+        replayIndex.Add(occurrence, GetPredictedEvent(static_cast<BallHitKind>(i)), anyCar);
+    }
+}
+
+bool SequenceEngine::LoadReplayIndex(const std::string& replayId) {
+    if (replayId == replayIndexId && !replayIndex.IsEmpty()) return true;
+    if (replayScanning) return false;
+
+    replayIndexId = replayId;
+    return replayIndex.Load(ReplayIndex::DefaultPath(host.GetDataFolder(), replayId)) && !replayIndex.IsEmpty();
+}
+
+bool SequenceEngine::StartCuePlayback() {
+    double replayTime;
+    std::string replayId = host.GetReplayId();
+    if (!host.GetReplayTime(replayTime) || replayId.empty() || !LoadReplayIndex(replayId)) {
+        StopCuePlayback();
+        return false;
+    }
+    // The index has no car or ball state to check conditions against
+    if (std::any_of(steps.begin(), steps.end(), [](const SequenceStep& step) { return !step.condition.IsEmpty(); })) {
+        host.Log("[CamChangePlus] The sequence has step conditions; matching the replay live instead of from its index.");
+        StopCuePlayback();
+        return false;
+    }
+    // Cue sheets are resolved one step after another
+    if (!graph.IsLinear()) {
+        host.Log("[CamChangePlus] The sequence branches; matching the replay live instead of from its index.");
+        StopCuePlayback();
+        return false;
+    }
+
+    if (!cuePlayback) hooks.Acquire(replayFrameHook, [this]() { OnReplayFrame(); });
+    cuePlayback = true;
+    cueStartTime = replayTime;
+    cueSheet.Resolve(steps, replayIndex, replayTime, playbackMode != PlaybackMode::Once);
+    nextCue = 0;
+    lastReplayTime = replayTime;
+    lastReplayFrameTime = host.GetTime();
+    host.Log("[CamChangePlus] Playing from the replay index: " + std::to_string(cueSheet.GetCues().size()) + " cues" +
+        (cueSheet.IsComplete() ? "" : " (the sequence doesn't complete in this replay)"));
+    return true;
+}
+
+void SequenceEngine::StopCuePlayback() {
+    if (!cuePlayback) return;
+    hooks.Release(replayFrameHook);
+    cuePlayback = false;
+}
+
+void SequenceEngine::PlayCues(double replayTime) {
+    const auto& cues = cueSheet.GetCues();
+    while (nextCue < cues.size() && cues[nextCue].time <= replayTime) FireCue(cues[nextCue++], false);
+}
+
+void SequenceEngine::SeekCues(double replayTime) {
+    CCP_TRACE_SCOPE("SeekCues");
+    // Back to the state at the start of playback, then everything up to
+    // the target lands at once, without transitions
+    ResetCamera();
+    tasRunning = true;
+    currentTasIndex = 0;
+    iterations = 0;
+    nextCue = replayTime < cueStartTime ? 0 : cueSheet.Find(replayTime);
+    const auto& cues = cueSheet.GetCues();
+    for (size_t i = 0; i < nextCue; ++i) FireCue(cues[i], true);
+    // Cues due at exactly the target fire on this frame as usual
+    PlayCues(replayTime);
+}
+
+void SequenceEngine::FireCue(const ReplayCue& cue, bool snap) {
+    if (cue.reset) {
+        currentTasIndex = 0;
+        if (playbackMode != PlaybackMode::Loop) ResetCamera();
+        if (playbackMode == PlaybackMode::Once) tasRunning = false;
+        else iterations++;
+        return;
+    }
+
+    const SequenceStep& step = steps[cue.step];
+    if (tasRunning) currentTasIndex = cue.step + 1;
+    if (snap) {
+        ExecuteAction(step.action, step.value);
+        return;
+    }
+    ScheduledAction action{ nextScheduledId++, cue.step, step.event, step.action, step.value, step.transition,
+        host.GetTime(), {} };
+    FireAction(action);
+}
+
+SeekCheckpoint SequenceEngine::CaptureCheckpoint(double replayTime) {
+    SeekCheckpoint checkpoint;
+    checkpoint.replayTime = replayTime;
+    checkpoint.running = tasRunning;
+    checkpoint.iterations = iterations;
+    checkpoint.graph = graphState;
+    double now = host.GetTime();
+    for (uint64_t armed = graphState.active; armed; armed &= armed - 1) {
+        checkpoint.armedAt.push_back(replayTime - (now - stepArmedTime[std::countr_zero(armed)]));
+    }
+    for (const ScheduledAction& scheduled : scheduledActions) {
+        checkpoint.pending.push_back({ scheduled.step, replayTime + (scheduled.intendedTime - now) });
+    }
+    std::stable_sort(checkpoint.pending.begin(), checkpoint.pending.end(),
+        [](const PendingReplayAction& a, const PendingReplayAction& b) { return a.replayTime < b.replayTime; });
+    checkpoint.camera = camera.Capture();
+    return checkpoint;
+}
+
+void SequenceEngine::RecordJournalEvent(GameEvent event, float eventLead, uint64_t fired) {
+    double replayTime;
+    if (!host.GetReplayTime(replayTime)) return;
+
+    replayTimeline.RecordEvent({ replayTime, event, eventLead, fired });
+}
+
+uint8_t SequenceEngine::GetAcceptedBindings(GameEvent event, CarHandle car) const {
+    // Teams aren't known any more by the time a seek or an index replays the event
+    uint8_t bindings = 0;
+    for (size_t i = 0; i < CarBindingCount; ++i) {
+        if (BindingAccepts(static_cast<CarBinding>(i), event, car)) bindings |= static_cast<uint8_t>(1 << i);
+    }
+    return bindings;
+}
+
+void SequenceEngine::SeekReplay(double replayTime) {
+    CCP_TRACE_SCOPE("SeekReplay");
+    if (!replayTracking) return;
+    lastReplayTime = replayTime;
+    lastReplayFrameTime = host.GetTime();
+
+    // Stale timers find their ids gone and do nothing; bursts, detector
+    // edges and predictions from before the seek are forgotten
+    scheduledActions.clear();
+    eventFilter.ResetWindows();
+    eventDetector.Reset();
+    carTracker.Reset();
+    lastPredictedOccurrence.fill(-1.0e9);
+
+    const SeekCheckpoint* checkpoint = replayTimeline.FindCheckpoint(replayTime);
+    if (!checkpoint) return;
+    double checkpointTime = checkpoint->replayTime;
+    tasRunning = checkpoint->running;
+    iterations = checkpoint->iterations;
+    graphState = checkpoint->graph;
+    std::array<double, SequenceGraph::maxNodes> armedAt{};
+    size_t armedCount = 0;
+    for (uint64_t armed = graphState.active; armed; armed &= armed - 1) {
+        armedAt[std::countr_zero(armed)] = checkpoint->armedAt[armedCount++];
+    }
+    camera.Restore(checkpoint->camera);
+
+    // Actions due by the target are applied in order, without transitions
+    std::vector<PendingReplayAction> pending = checkpoint->pending;
+    auto applyDue = [&](double until) {
+        size_t due = 0;
+        for (; due < pending.size() && pending[due].replayTime <= until; ++due) {
+            const SequenceStep& step = steps[pending[due].step];
+            ExecuteAction(step.action, step.value);
+        }
+        pending.erase(pending.begin(), pending.begin() + due);
+    };
+    // Same as FinishGraph; a last step's own action lands after
+    auto finishIfDone = [&](double time) {
+        if (!graph.IsFinished(graphState)) return false;
+        if (playbackMode != PlaybackMode::Loop) ResetCamera();
+        if (playbackMode == PlaybackMode::Once) {
+            tasRunning = false;
+            graphState.active = 0;
+            return true;
+        }
+        iterations++;
+        SequenceGraphUpdate update = graph.Start(graphState);
+        for (uint64_t ready = update.ready; ready; ready &= ready - 1) armedAt[std::countr_zero(ready)] = time;
+        return true;
+    };
+    // Timeouts are a matter of replay time, so they run out here again
+    auto expire = [&](double until) {
+        uint64_t expired = 0;
+        for (uint64_t armed = graphState.active; armed; armed &= armed - 1) {
+            size_t index = std::countr_zero(armed);
+            if (steps[index].timeout > 0.0f && armedAt[index] + steps[index].timeout <= until) expired |= uint64_t(1) << index;
+        }
+        if (!expired) return;
+        graph.Cancel(graphState, expired);
+        finishIfDone(until);
+    };
+
+    auto [first, last] = replayTimeline.GetEvents(*checkpoint, replayTime);
+    size_t matched = 0;
+    for (const JournalEvent* event = first; event != last; ++event) {
+        applyDue(event->replayTime);
+        if (!tasRunning) continue;
+        expire(event->replayTime);
+
+        for (uint64_t firing = event->fired; tasRunning && firing; firing &= firing - 1) {
+            size_t index = std::countr_zero(firing);
+            if (!(graphState.active & (uint64_t(1) << index))) continue;
+
+            const SequenceStep& step = steps[index];
+            PendingReplayAction action{ index, event->replayTime + std::max(step.delay + event->lead, 0.0f) };
+            pending.insert(std::upper_bound(pending.begin(), pending.end(), action,
+                [](const PendingReplayAction& a, const PendingReplayAction& b) { return a.replayTime < b.replayTime; }), action);
+            matched++;
+            SequenceGraphUpdate update = graph.Fire(graphState, index);
+            for (uint64_t ready = update.ready; ready; ready &= ready - 1) armedAt[std::countr_zero(ready)] = event->replayTime;
+            // The rest of the event's steps belonged to the finished iteration
+            if (finishIfDone(event->replayTime)) break;
+        }
+    }
+    applyDue(replayTime);
+    if (tasRunning) expire(replayTime);
+    size_t replayed = last - first;
+    for (const PendingReplayAction& action : pending) {
+        ScheduleAction(action.step, static_cast<float>(action.replayTime - replayTime), {});
+    }
+
+    currentTasIndex = tasRunning ? std::popcount(graphState.fired) : 0;
+    if (tasRunning) ResumeGraph(armedAt, replayTime);
+    else StopGraph();
+
+    if (replayTimeline.Advance(replayTime) && replayTimeline.NeedsCheckpoint(replayTime)) {
+        replayTimeline.AddCheckpoint(CaptureCheckpoint(replayTime));
+    }
+    host.Log("[CamChangePlus] Replay seek to " + std::to_string(replayTime) + "s: restored checkpoint at " +
+        std::to_string(checkpointTime) + "s, replayed " + std::to_string(replayed) + " events (" +
+        std::to_string(matched) + " matched)");
+}
@@ -0,0 +1,329 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <array>
+
+#include "CamHost.h"
+#include "GameEvents.h"
+#include "Sequence.h"
+#include "CameraController.h"
+#include "TraceRecorder.h"
+#include "LatencyHistogram.h"
+#include "BallPredictor.h"
+#include "EventDetector.h"
+#include "EventFilter.h"
+#include "HookRegistry.h"
+#include "CarTracker.h"
+#include "ReplayTimeline.h"
+#include "ReplayIndex.h"
+#include "SequenceTask.h"
+#include "SequenceGraph.h"
+
+// Event -> sequence -> camera pipeline. The current shot is a graph of steps
+// (SequenceGraph; a plain list is a chain). Each armed step runs as a
+// coroutine task that waits for its event and schedules the step's camera
+// action when it arrives; coroutine sequences run beside them.
+class SequenceEngine {
+public:
+    explicit SequenceEngine(CamHost& host);
+
+    // ===========================
+    //        Game Hooks
+    // ===========================
+    // Enables/disables hooking. Game hooks are only installed while an armed
+    // (running) sequence or the trace recorder subscribes to their events.
+    void HookGameEvents();
+    void UnhookGameEvents();
+
+    // Reference-counted per event; the event's game hook (the tick hook for
+    // tick and predicted events) follows the count
+    void SubscribeEvent(GameEvent event);
+    void UnsubscribeEvent(GameEvent event);
+    size_t GetEventRefCount(GameEvent event) const;
+    const HookRegistry& GetHooks() const { return hooks; }
+
+    // Per-car hooks (touch, jump, flip, demolition) only reach the handlers
+    // for the focus car (local or spectated). Other cars' calls are counted
+    // and passed to the observer, if any, before any handler work, unless an
+    // armed step is bound to another car (see CarBinding).
+    using CarEventObserver = std::function<void(GameEvent event, CarHandle car)>;
+    void SetOtherCarObserver(CarEventObserver observer) { otherCarObserver = std::move(observer); }
+    uint64_t GetOtherCarEvents() const { return otherCarEvents; }
+
+    // Debounce stage between the hooks/detectors and sequence matching;
+    // policies and suppression counters live here
+    EventFilter& GetEventFilter() { return eventFilter; }
+
+    // ===========================
+    //        Sequences
+    // ===========================
+    void SetSequence(const std::string& name, std::vector<ActionMapping> actions);
+    const std::vector<ActionMapping>& GetActions() const { return eventActions; }
+    const std::string& GetSequenceName() const { return currentSequenceName; }
+
+    void StartSequencePlayback();
+    void StopSequencePlayback();
+    void ResetToDefault();
+    bool IsRunning() const { return tasRunning; }
+    // Loop and Rearm wrap to the shot's first steps when it finishes, with
+    // the steps' hooks and tasks' frames kept warm; only StopSequencePlayback
+    // or ResetToDefault ends them
+    void SetPlaybackMode(PlaybackMode mode) { playbackMode = mode; }
+    PlaybackMode GetPlaybackMode() const { return playbackMode; }
+    // Times the shot wrapped since playback started
+    uint64_t GetIterations() const { return iterations; }
+    // Steps fired so far this run; for a plain list, the step waiting next
+    size_t GetCurrentStep() const { return currentTasIndex; }
+    // The current run's graph; once it stops, which steps fired or were
+    // dropped before it did (nothing stays active)
+    const SequenceGraphState& GetGraphState() const { return graphState; }
+
+    // Starts a coroutine sequence (see SequenceTask); it runs up to its first
+    // co_await now and is resumed by event dispatch and the tick. The events
+    // it waits on are subscribed only while it waits. ResetToDefault and
+    // StopSequencePlayback cancel every task.
+    SequenceRuntime::TaskId RunTask(SequenceTask task);
+    void CancelTask(SequenceRuntime::TaskId id);
+    const SequenceRuntime& GetRuntime() const { return runtime; }
+    // Resumes the tasks whose WaitTicks or step timeout is due. OnTick does
+    // it after the tick's events; drivers that step a clock without the tick
+    // hook (TraceReplay) call it every tick while GetRuntime().HasTickWaiters().
+    void TickTasks();
+
+    // ===========================
+    //        Replay Seeking
+    // ===========================
+    // While a sequence plays in a replay the engine checkpoints itself along
+    // replay time and journals the events it sees. A seek drops the stale
+    // timers, restores the nearest checkpoint and fast-forwards through the
+    // journal; actions that would have fired by then are applied at once.
+    void OnReplayFrame();
+    void SeekReplay(double replayTime);
+    const ReplayTimeline& GetReplayTimeline() const { return replayTimeline; }
+    // Fires once per rendered frame, replays included
+    constexpr static const char* replayFrameHook = "Function Engine.GameViewportClient.Tick";
+    // Replay time running ahead of the host clock by more than this is a seek
+    constexpr static double seekThreshold = 0.25;
+
+    // Scans the replay being watched, at any playback speed, into an index of
+    // every event by replay time, saved when the scan stops or the replay is
+    // left. Playback in a replay that has an index resolves the sequence into
+    // cues up front and runs on the frame hook alone, without live detection.
+    bool StartReplayScan();
+    void StopReplayScan();
+    bool IsScanningReplay() const { return replayScanning; }
+    bool IsPlayingFromIndex() const { return cuePlayback; }
+    const ReplayIndex& GetReplayIndex() const { return replayIndex; }
+    const ReplayCueSheet& GetCueSheet() const { return cueSheet; }
+
+    // ===========================
+    //        Event Dispatch
+    // ===========================
+    // eventLead: seconds until the event actually happens (predicted events).
+    // It is added to the step's delay, so a negative delay fires ahead of it.
+    // car: the car that raised it, 0 for the focus car; only steps whose
+    // binding accepts the car match
+    void ProcessEventActions(GameEvent event, float eventLead = 0.0f, CarHandle car = 0);
+    // The transition only affects yaw and rig actions; duration 0 snaps
+    void ExecuteAction(CameraAction action, float value = 50.0f, const ActionTransition& transition = {});
+
+    // Hook handlers; public so hosts can feed events directly
+    void OnBallTouch();
+    void OnExplosion();
+    // car: the car that jumped, 0 for the local one
+    void OnJump(CarHandle car = 0);
+    void OnDoubleJump(CarHandle car = 0);
+    void OnFlip();
+    void OnDemolition();
+    void OnKickoffStart();
+    // Per physics tick: snapshots car and ball once, runs the event detectors
+    // on it, and runs the ball predictor while the next step waits on a
+    // predicted event. While a step is bound to other cars it also steps the
+    // car tracker over every car in the match.
+    void OnTick();
+
+    const BallPrediction& GetBallPrediction() const { return ballPrediction; }
+    EventDetector& GetEventDetector() { return eventDetector; }
+    const CarTracker& GetCarTracker() const { return carTracker; }
+
+    // Cost of each tick's snapshot + detector pass in microseconds, and how
+    // many passes went over tickScanBudgetUs
+    const LatencyHistogram& GetTickScanCost() const { return tickScanCost; }
+    uint64_t GetTickScanOverBudget() const { return tickScanOverBudget; }
+    void ResetTickScanCost();
+    constexpr static uint64_t tickScanBudgetUs = 20;
+
+    // Fires once per physics tick for every car
+    constexpr static const char* tickHook = "Function TAGame.Car_TA.SetVehicleInput";
+    CameraController& Camera() { return camera; }
+
+    // Optional; every dispatched event and fired action is recorded while set.
+    // Subscribes to all events so the trace covers what isn't armed.
+    void SetTraceRecorder(TraceRecorder* traceRecorder);
+
+    // Optional; per-stage hook-to-camera latency is recorded while set
+    void SetLatencyMonitor(LatencyMonitor* monitor);
+
+    // Optional; called after each scheduled step action executes
+    using ActionObserver = std::function<void(size_t step, CameraAction action, float value)>;
+    void SetActionObserver(ActionObserver observer) { actionObserver = std::move(observer); }
+
+private:
+    // A step action waiting on its delay. Kept here as well as in the host
+    // timer so a zero-delay action can run the due ones first, in step order.
+    struct ScheduledAction {
+        uint64_t id;
+        size_t step;
+        GameEvent event;
+        CameraAction action;
+        float value;
+        ActionTransition transition;
+        double intendedTime;
+        LatencyStamp stamp;
+    };
+
+    // Subscribes the distinct events of the current steps while playing
+    void ArmSequence();
+    void DisarmSequence();
+    // One armed step waiting for its event, as a task; timeoutTicks 0 waits for good
+    SequenceTask PlayStep(size_t index, uint32_t timeoutTicks);
+    void FireStep(size_t index, float eventLead);
+    void TimeOutStep(size_t index);
+    // Arms the graph's roots
+    void StartGraph();
+    // Re-arms the active steps after a seek; armedAt in replay time
+    void ResumeGraph(const std::array<double, SequenceGraph::maxNodes>& armedAt, double replayTime);
+    void StopGraph();
+    void StopStepTasks();
+    // Spawns tasks for ready steps and cancels those of dropped ones
+    void ApplyGraphUpdate(const SequenceGraphUpdate& update);
+    // The timeout counts from armedTime (host clock)
+    void ArmStep(size_t index, double armedTime);
+    // Every step fired or was dropped: completes or wraps, per playbackMode
+    void FinishGraph();
+    // The shot's graph finished: camera back to default, steps disarmed
+    void CompleteSequence();
+    // Follows the events and ticks the tasks wait on with subscriptions
+    void SyncRuntimeHooks();
+    // What step conditions check: the event's car (the focus car's live
+    // state, another car's from the tracker) and the ball
+    void TakeEventSnapshot(CarHandle car, WorldSnapshot& snapshot);
+    // Car events taken from cars other than the focus car
+    EventMask GetOtherCarMask() const { return otherCarArmed | runtime.GetOtherCarEvents() | scanCarEvents; }
+    std::function<void()> GetEventHandler(GameEvent event);
+    // Wraps the handler with the focus car check
+    std::function<void(CarHandle)> GetCarEventHandler(GameEvent event);
+    // Compares against the cached focus car; refreshes it from the host at
+    // most once per tick when the caller doesn't match
+    bool IsFocusCar(CarHandle caller);
+    // The hook caller's state; the local car's when the host gave no caller
+    bool GetCallerState(CarHandle caller, CarState& state);
+    bool BindingAccepts(CarBinding binding, GameEvent event, CarHandle car) const;
+    void TrackCars(double now);
+
+    void StartReplayTracking();
+    void StopReplayTracking();
+    SeekCheckpoint CaptureCheckpoint(double replayTime);
+    void RecordJournalEvent(GameEvent event, float eventLead, uint64_t fired);
+    // Bit per CarBinding that accepts the event from car
+    uint8_t GetAcceptedBindings(GameEvent event, CarHandle car) const;
+    void ScanBallHits(const BallState& ball);
+    // Loads the index of the replay being watched unless it is loaded already
+    bool LoadReplayIndex(const std::string& replayId);
+    bool StartCuePlayback();
+    void StopCuePlayback();
+    void PlayCues(double replayTime);
+    void SeekCues(double replayTime);
+    void FireCue(const ReplayCue& cue, bool snap);
+    // Camera half of ResetToDefault
+    void ResetCamera();
+
+    void ScheduleAction(size_t step, float delay, LatencyStamp stamp);
+    // Zero-delay path: runs inside the event dispatch instead of a timer
+    void RunActionNow(size_t step, LatencyStamp stamp);
+    void RunDueActions();
+    void FireScheduled(uint64_t id);
+    void FireAction(ScheduledAction& scheduled);
+    // Filters, then logs and matches; every hook and detector goes through here
+    void RaiseEvent(GameEvent event, CarHandle car = 0);
+    void DispatchEvent(GameEvent event, uint32_t count, CarHandle car);
+    void ScheduleTrailingEvent(GameEvent event);
+    void CloseTrailingEvent(GameEvent event);
+    uint64_t CurrentTick();
+    void PredictBall(const BallState& ball);
+    void MarkHookEntry() { if (latency) hookEntryTime = host.GetTime(); }
+    void RecordTrace(TraceRecordType type, GameEvent event, CameraAction action, size_t step, uint8_t flags, float value, int32_t latencyUs, CarHandle car = 0);
+
+    CamHost& host;
+    CameraController camera;
+    HookRegistry hooks;
+    std::array<uint16_t, GameEventCount> eventRefs{};
+    EventMask subscribedEvents = 0;
+    std::vector<GameEvent> armedEvents;
+    EventMask otherCarArmed = 0; // Events an armed step takes from cars other than the focus car
+
+    CarHandle focusCar = 0;
+    double focusCarRefreshTime = -1.0;
+    uint64_t otherCarEvents = 0;
+    CarEventObserver otherCarObserver;
+    TraceRecorder* recorder = nullptr;
+    ActionObserver actionObserver;
+    LatencyMonitor* latency = nullptr;
+    double hookEntryTime = -1.0; // Set by the hook handlers while latency is on
+
+    std::string currentSequenceName = "New Shot";
+    std::vector<ActionMapping> eventActions;
+    std::vector<SequenceStep> steps;
+    SequenceGraph graph;
+    SequenceGraphState graphState;
+    std::array<SequenceRuntime::TaskId, SequenceGraph::maxNodes> stepTasks{};
+    std::array<double, SequenceGraph::maxNodes> stepArmedTime{};
+    uint64_t firedSteps = 0; // By the event being dispatched, for the journal
+    std::vector<ScheduledAction> scheduledActions; // In scheduling (= step) order
+    uint64_t nextScheduledId = 0;
+
+    PlaybackMode playbackMode = PlaybackMode::Once;
+    uint64_t iterations = 0;
+    bool tasRunning = false;     // Track whether TAS mode is active
+    size_t currentTasIndex = 0;  // Track the current action being executed
+    SequenceRuntime runtime;
+    EventMask runtimeArmed = 0; // Events subscribed for the tasks' waits
+    bool runtimeTicking = false;
+    bool hasFlipped = false;
+    EventFilter eventFilter;
+
+    std::array<CarHandle, GameEventCount> trailingCars{}; // Car of each deferred burst's first event
+
+    EventDetector eventDetector;
+    CarTracker carTracker;
+    std::array<MatchCar, CarTracker::capacity> matchCars{};
+    size_t matchCarCount = 0;
+    double lastCarTrackTime = -1.0;
+    LatencyHistogram tickScanCost;
+    uint64_t tickScanOverBudget = 0;
+
+    ReplayTimeline replayTimeline;
+    bool replayTracking = false;
+    double lastReplayTime = -1.0;
+    double lastReplayFrameTime = -1.0; // Host clock at lastReplayTime
+
+    ReplayIndex replayIndex;
+    std::string replayIndexId; // Replay the index belongs to
+    bool replayScanning = false;
+    EventMask scanCarEvents = 0; // Car events taken from every car while scanning
+    BallPrediction scanPrediction;
+    std::array<double, BallHitKindCount> lastScannedHit{ -1.0e9, -1.0e9, -1.0e9 };
+    ReplayCueSheet cueSheet;
+    bool cuePlayback = false;
+    double cueStartTime = 0.0;
+    size_t nextCue = 0;
+
+    BallPredictor ballPredictor;
+    BallPrediction ballPrediction;
+    double lastTickTime = -1.0;
+    // Absolute time of the last dispatched occurrence per hit kind, so one
+    // wall hit doesn't satisfy several steps in a row
+    std::array<double, BallHitKindCount> lastPredictedOccurrence{ -1.0e9, -1.0e9, -1.0e9 };
+    constexpr static double predictionDedupe = 0.25;
+};
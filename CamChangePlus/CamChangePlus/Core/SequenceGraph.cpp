@@ -0,0 +1,100 @@
+#include "SequenceGraph.h"
+
+#include <algorithm>
+#include <bit>
+
+void SequenceGraph::Build(const std::vector<SequenceStep>& steps) {
+    size_t count = std::min(steps.size(), maxNodes);
+    nodes.assign(count, {});
+    roots = 0;
+    all = count == maxNodes ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+    linear = true;
+
+    for (size_t i = 0; i < count; ++i) {
+        const SequenceStep& step = steps[i];
+        Node& node = nodes[i];
+        node.predecessors = step.after & all;
+        node.joinAny = step.joinAny;
+        if (!node.predecessors) roots |= uint64_t(1) << i;
+        for (uint64_t remaining = node.predecessors; remaining; remaining &= remaining - 1) {
+            nodes[std::countr_zero(remaining)].successors |= uint64_t(1) << i;
+        }
+        if (node.predecessors != (i > 0 ? uint64_t(1) << (i - 1) : 0) || step.timeout > 0.0f || step.race) linear = false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!steps[i].race) continue;
+        for (size_t j = 0; j < count; ++j) {
+            if (j != i && steps[j].race == steps[i].race) nodes[i].race |= uint64_t(1) << j;
+        }
+    }
+}
+
+SequenceGraphUpdate SequenceGraph::Start(SequenceGraphState& state) const {
+    state = {};
+    SequenceGraphUpdate update;
+    Settle(state, roots, update);
+    return update;
+}
+
+SequenceGraphUpdate SequenceGraph::Fire(SequenceGraphState& state, size_t node) const {
+    if (node >= nodes.size()) return {};
+    uint64_t bit = uint64_t(1) << node;
+    if (!(state.active & bit)) return {};
+
+    state.active &= ~bit;
+    state.fired |= bit;
+    // The rest of the race group lost, whether armed yet or not
+    SequenceGraphUpdate update = Cancel(state, nodes[node].race);
+    Settle(state, nodes[node].successors, update);
+    return update;
+}
+
+SequenceGraphUpdate SequenceGraph::Cancel(SequenceGraphState& state, uint64_t cancelled) const {
+    SequenceGraphUpdate update;
+    cancelled &= all & ~(state.fired | state.cancelled);
+    if (!cancelled) return update;
+
+    state.cancelled |= cancelled;
+    state.active &= ~cancelled;
+    update.cancelled |= cancelled;
+    uint64_t candidates = 0;
+    for (uint64_t remaining = cancelled; remaining; remaining &= remaining - 1) {
+        candidates |= nodes[std::countr_zero(remaining)].successors;
+    }
+    Settle(state, candidates, update);
+    return update;
+}
+
+bool SequenceGraph::IsReady(const SequenceGraphState& state, size_t node) const {
+    uint64_t predecessors = nodes[node].predecessors;
+    if (!predecessors) return true;
+    return nodes[node].joinAny ? (predecessors & state.fired) != 0 : (predecessors & ~state.fired) == 0;
+}
+
+bool SequenceGraph::IsDead(const SequenceGraphState& state, size_t node) const {
+    uint64_t predecessors = nodes[node].predecessors;
+    if (!predecessors) return false;
+    return nodes[node].joinAny ? (predecessors & ~state.cancelled) == 0 : (predecessors & state.cancelled) != 0;
+}
+
+void SequenceGraph::Settle(SequenceGraphState& state, uint64_t candidates, SequenceGraphUpdate& update) const {
+    // Successors always come later, so lowest first sees each node's
+    // predecessors settled before it
+    while (candidates) {
+        size_t node = std::countr_zero(candidates);
+        uint64_t bit = uint64_t(1) << node;
+        candidates &= ~bit;
+        if ((state.fired | state.cancelled | state.active) & bit) continue;
+
+        if (IsDead(state, node)) {
+            state.cancelled |= bit;
+            update.cancelled |= bit;
+            candidates |= nodes[node].successors;
+        }
+        else if (IsReady(state, node)) {
+            state.active |= bit;
+            update.ready |= bit;
+        }
+    }
+}
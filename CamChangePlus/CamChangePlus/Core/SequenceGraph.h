@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Sequence.h"
+
+// Where a run of the graph is: a bit per node in each set. A node is armed
+// (waiting on its event) while active, then either fired or cancelled.
+struct SequenceGraphState {
+    uint64_t fired = 0;
+    uint64_t cancelled = 0;
+    uint64_t active = 0;
+};
+
+// What a fire or cancel changed: nodes to arm, and nodes dropped (some of
+// which may have been armed)
+struct SequenceGraphUpdate {
+    uint64_t ready = 0;
+    uint64_t cancelled = 0;
+};
+
+// A shot's steps as a DAG compiled to a flat node array. Each node keeps its
+// predecessor, successor and race-group sets as bitsets, so firing or
+// cancelling a node only looks at the nodes it touches and readiness is a
+// mask test. Edges only point to earlier steps (CompileSequence), so there
+// are no cycles, and a plain list compiles to a chain.
+//
+// A node arms once all its predecessors fired (any one, for a join-any
+// node); roots arm when the run starts. A node that can no longer arm
+// (an all-join with a cancelled predecessor, an any-join whose
+// predecessors all were) is cancelled with it, so every node ends up
+// fired or cancelled and the run finishes.
+class SequenceGraph {
+public:
+    constexpr static size_t maxNodes = SequenceNodeCapacity;
+
+    void Build(const std::vector<SequenceStep>& steps);
+
+    // Arms the roots of a fresh run
+    SequenceGraphUpdate Start(SequenceGraphState& state) const;
+    // The node's event arrived: it fires, its race group loses, and the
+    // successors that are ready now arm
+    SequenceGraphUpdate Fire(SequenceGraphState& state, size_t node) const;
+    // Timeouts and lost races; cancels whatever depended on the nodes too
+    SequenceGraphUpdate Cancel(SequenceGraphState& state, uint64_t nodes) const;
+
+    bool IsFinished(const SequenceGraphState& state) const { return ((state.fired | state.cancelled) & all) == all; }
+    // Every node follows the one before it, with no timeouts or races
+    bool IsLinear() const { return linear; }
+    size_t GetNodeCount() const { return nodes.size(); }
+
+private:
+    struct Node {
+        uint64_t predecessors;
+        uint64_t successors;
+        uint64_t race; // Other nodes of its race group
+        bool joinAny;
+    };
+
+    bool IsReady(const SequenceGraphState& state, size_t node) const;
+    bool IsDead(const SequenceGraphState& state, size_t node) const;
+    // Drops dead candidates (and what depends on them), arms the ready ones
+    void Settle(SequenceGraphState& state, uint64_t candidates, SequenceGraphUpdate& update) const;
+
+    std::vector<Node> nodes;
+    uint64_t roots = 0;
+    uint64_t all = 0;
+    bool linear = true;
+};
@@ -0,0 +1,277 @@
+#include "SequenceTask.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <new>
+#include <utility>
+
+// ===========================
+//        Frame Pool
+// ===========================
+
+std::atomic<uint64_t> FramePool::allocations{ 0 };
+std::atomic<uint64_t> FramePool::reused{ 0 };
+
+namespace {
+    // Free frames are linked through their first bytes
+    struct FreeFrame {
+        FreeFrame* next;
+    };
+
+    struct FreeLists {
+        std::array<FreeFrame*, FramePool::classCount> heads{};
+
+        ~FreeLists() {
+            for (FreeFrame* head : heads) {
+                while (head) {
+                    FreeFrame* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    thread_local FreeLists freeLists;
+
+    size_t SizeClass(size_t size) {
+        return size == 0 ? 0 : (size - 1) / FramePool::classSize;
+    }
+}
+
+void* FramePool::Allocate(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t sizeClass = SizeClass(size);
+    if (sizeClass >= classCount) return ::operator new(size);
+
+    FreeFrame*& head = freeLists.heads[sizeClass];
+    if (head) {
+        reused.fetch_add(1, std::memory_order_relaxed);
+        return std::exchange(head, head->next);
+    }
+    return ::operator new((sizeClass + 1) * classSize);
+}
+
+void FramePool::Free(void* frame, size_t size) {
+    size_t sizeClass = SizeClass(size);
+    if (sizeClass >= classCount) {
+        ::operator delete(frame);
+        return;
+    }
+
+    // Frames freed on another thread join that thread's lists; every frame
+    // is its own heap block, so that is safe
+    FreeFrame*& head = freeLists.heads[sizeClass];
+    head = new (frame) FreeFrame{ head };
+}
+
+// ===========================
+//        Tasks
+// ===========================
+
+SequenceTask& SequenceTask::operator=(SequenceTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = std::exchange(other.handle, {});
+    }
+    return *this;
+}
+
+SequenceTask::~SequenceTask() {
+    if (handle) handle.destroy();
+}
+
+SequenceTask::Handle SequenceTask::Release() {
+    return std::exchange(handle, {});
+}
+
+void EventAwaiter::await_suspend(SequenceTask::Handle task) {
+    handle = task;
+    SequenceRuntime& runtime = *task.promise().runtime;
+    runtime.eventWaiters.push_back(this);
+    if (timeout) {
+        due = runtime.now + timeout;
+        runtime.timedWaiters.push_back(this);
+    }
+    runtime.UpdateMasks();
+}
+
+void TickAwaiter::await_suspend(SequenceTask::Handle task) {
+    handle = task;
+    SequenceRuntime& runtime = *task.promise().runtime;
+    due = runtime.now + ticks;
+    runtime.tickWaiters.push_back(this);
+}
+
+EventAwaiter WaitFor(GameEvent event, CarBinding binding, const Predicate* condition) {
+    return EventAwaiter(EventAwaiter::Bit(event), binding, condition);
+}
+
+EventAwaiter WaitForAny(EventMask events, CarBinding binding) {
+    return EventAwaiter(events, binding);
+}
+
+TickAwaiter WaitTicks(uint32_t ticks) {
+    return TickAwaiter(ticks);
+}
+
+// ===========================
+//        Runtime
+// ===========================
+
+SequenceRuntime::~SequenceRuntime() {
+    Clear();
+}
+
+SequenceRuntime::TaskId SequenceRuntime::Spawn(SequenceTask task, uint64_t tick) {
+    SequenceTask::Handle handle = task.Release();
+    if (!handle) return 0;
+
+    handle.promise().runtime = this;
+    TaskId id = nextId++;
+    tasks.push_back({ id, handle });
+    now = tick;
+    Resume(id);
+    return IsAlive(id) ? id : 0;
+}
+
+bool SequenceRuntime::Dispatch(const SequenceEvent& event, uint8_t bindings, const WorldSnapshot& snapshot, uint64_t tick) {
+    EventMask bit = EventBit(event.event);
+    if (!(waitedEvents & bit)) return false;
+    now = tick;
+
+    // Taken off the list before any of them runs, so a task that waits on
+    // the event again stays for the next one
+    std::vector<TaskId> resumed = TakeResumeBuffer();
+    auto waiting = std::remove_if(eventWaiters.begin(), eventWaiters.end(), [&](EventAwaiter* waiter) {
+        if (!Accepts(*waiter, bit, bindings, snapshot)) return false;
+        waiter->result = event;
+        resumed.push_back(Find(waiter->handle)->id);
+        if (waiter->timeout) std::erase(timedWaiters, waiter);
+        return true;
+        });
+    eventWaiters.erase(waiting, eventWaiters.end());
+    UpdateMasks();
+
+    // Ids, not frames: a task resumed first may cancel a later one, and a
+    // new task may get its frame back from the pool
+    for (TaskId id : resumed) Resume(id);
+    bool any = !resumed.empty();
+    resumeBuffer = std::move(resumed);
+    return any;
+}
+
+void SequenceRuntime::Tick(uint64_t tick) {
+    now = tick;
+    if (tickWaiters.empty() && timedWaiters.empty()) return;
+
+    std::stable_sort(tickWaiters.begin(), tickWaiters.end(),
+        [](const TickAwaiter* a, const TickAwaiter* b) { return a->due < b->due; });
+    auto due = std::find_if(tickWaiters.begin(), tickWaiters.end(), [tick](const TickAwaiter* waiter) { return waiter->due > tick; });
+    std::vector<TaskId> resumed = TakeResumeBuffer();
+    for (auto it = tickWaiters.begin(); it != due; ++it) resumed.push_back(Find((*it)->handle)->id);
+    tickWaiters.erase(tickWaiters.begin(), due);
+
+    // Timed-out waits resume with the result left at Invalid
+    std::stable_sort(timedWaiters.begin(), timedWaiters.end(),
+        [](const EventAwaiter* a, const EventAwaiter* b) { return a->due < b->due; });
+    auto expired = std::find_if(timedWaiters.begin(), timedWaiters.end(), [tick](const EventAwaiter* waiter) { return waiter->due > tick; });
+    for (auto it = timedWaiters.begin(); it != expired; ++it) {
+        resumed.push_back(Find((*it)->handle)->id);
+        std::erase(eventWaiters, *it);
+    }
+    if (expired != timedWaiters.begin()) {
+        timedWaiters.erase(timedWaiters.begin(), expired);
+        UpdateMasks();
+    }
+
+    for (TaskId id : resumed) Resume(id);
+    resumeBuffer = std::move(resumed);
+}
+
+std::vector<SequenceRuntime::TaskId> SequenceRuntime::TakeResumeBuffer() {
+    std::vector<TaskId> buffer = std::move(resumeBuffer);
+    buffer.clear();
+    return buffer;
+}
+
+void SequenceRuntime::Cancel(TaskId id) {
+    auto it = std::find_if(tasks.begin(), tasks.end(), [id](const Task& task) { return task.id == id; });
+    if (it == tasks.end()) return;
+    if (it->running) it->cancelled = true;
+    else Destroy(it->handle);
+}
+
+void SequenceRuntime::Clear() {
+    for (size_t i = 0; i < tasks.size();) {
+        if (tasks[i].running) {
+            tasks[i].cancelled = true;
+            ++i;
+        }
+        else {
+            Destroy(tasks[i].handle);
+        }
+    }
+}
+
+bool SequenceRuntime::IsWaiting(GameEvent event, uint8_t bindings, const WorldSnapshot& snapshot) const {
+    EventMask bit = EventBit(event);
+    if (!(waitedEvents & bit)) return false;
+    return std::any_of(eventWaiters.begin(), eventWaiters.end(), [&](const EventAwaiter* waiter) {
+        return Accepts(*waiter, bit, bindings, snapshot);
+        });
+}
+
+bool SequenceRuntime::Accepts(const EventAwaiter& waiter, EventMask bit, uint8_t bindings, const WorldSnapshot& snapshot) {
+    if (!(waiter.events & bit) || !(bindings >> static_cast<size_t>(waiter.binding) & 1)) return false;
+    return !waiter.condition || waiter.condition->Evaluate(snapshot);
+}
+
+bool SequenceRuntime::IsAlive(TaskId id) const {
+    return std::any_of(tasks.begin(), tasks.end(), [id](const Task& task) { return task.id == id && !task.cancelled; });
+}
+
+void SequenceRuntime::Resume(TaskId id) {
+    auto it = std::find_if(tasks.begin(), tasks.end(), [id](const Task& task) { return task.id == id; });
+    if (it == tasks.end() || it->cancelled) return;
+
+    SequenceTask::Handle handle = it->handle;
+    it->running = true;
+    handle.resume();
+
+    // Nested spawns may have moved the task; running tasks are never erased
+    Task* task = Find(handle);
+    task->running = false;
+    if (handle.done() || task->cancelled) Destroy(handle);
+}
+
+SequenceRuntime::Task* SequenceRuntime::Find(SequenceTask::Handle handle) {
+    auto it = std::find_if(tasks.begin(), tasks.end(), [handle](const Task& task) { return task.handle == handle; });
+    return it != tasks.end() ? &*it : nullptr;
+}
+
+void SequenceRuntime::Destroy(SequenceTask::Handle handle) {
+    // The awaiters live in the frame
+    std::erase_if(eventWaiters, [handle](const EventAwaiter* waiter) { return waiter->handle == handle; });
+    std::erase_if(tickWaiters, [handle](const TickAwaiter* waiter) { return waiter->handle == handle; });
+    std::erase_if(timedWaiters, [handle](const EventAwaiter* waiter) { return waiter->handle == handle; });
+    std::erase_if(tasks, [handle](const Task& task) { return task.handle == handle; });
+    handle.destroy();
+    UpdateMasks();
+}
+
+void SequenceRuntime::UpdateMasks() {
+    waitedEvents = 0;
+    otherCarEvents = 0;
+    conditionalEvents = 0;
+    for (const EventAwaiter* waiter : eventWaiters) {
+        waitedEvents |= waiter->events;
+        if (waiter->condition) conditionalEvents |= waiter->events;
+        if (waiter->binding == CarBinding::Focus) continue;
+        for (EventMask remaining = waiter->events; remaining; remaining &= remaining - 1) {
+            auto event = static_cast<GameEvent>(std::countr_zero(remaining));
+            if (IsCarEvent(event)) otherCarEvents |= EventBit(event);
+        }
+    }
+}
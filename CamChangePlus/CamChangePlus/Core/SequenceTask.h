@@ -0,0 +1,227 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include "CamHost.h"
+#include "EventDetector.h"
+#include "GameEvents.h"
+#include "Predicate.h"
+#include "Sequence.h"
+
+// Recycles coroutine frames in 64-byte size classes, so starting a sequence
+// doesn't go to the heap once the first few have run. Free lists are per
+// thread (offline drivers run engines on a pool); frames above the largest
+// class come straight from the heap.
+class FramePool {
+public:
+    static void* Allocate(size_t size);
+    static void Free(void* frame, size_t size);
+
+    // Across all threads
+    static uint64_t GetAllocations() { return allocations.load(std::memory_order_relaxed); }
+    static uint64_t GetReused() { return reused.load(std::memory_order_relaxed); }
+
+    constexpr static size_t classSize = 64;
+    constexpr static size_t classCount = 16; // Up to 1 KiB
+
+private:
+    static std::atomic<uint64_t> allocations;
+    static std::atomic<uint64_t> reused;
+};
+
+class SequenceRuntime;
+
+// What resumed a task waiting on an event
+struct SequenceEvent {
+    GameEvent event = GameEvent::Invalid;
+    float lead = 0.0f; // Seconds until a predicted event actually happens
+    CarHandle car = 0; // 0 for the focus car
+};
+
+// A sequence written as a coroutine:
+//
+//   SequenceTask Shot(SequenceEngine& engine) {
+//       co_await WaitFor(GameEvent::Jump);
+//       SequenceEvent next = co_await WaitForAny(GameEvent::Flip, GameEvent::Landing);
+//       if (next.event == GameEvent::Flip) engine.ExecuteAction(CameraAction::EnableBallCam);
+//       co_await WaitTicks(30);
+//       engine.ExecuteAction(CameraAction::DisableBallCam);
+//   }
+//
+// It does nothing until handed to a SequenceRuntime, which then owns it. A
+// suspended task is its frame plus one pointer in the runtime's wait lists.
+class SequenceTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        SequenceRuntime* runtime = nullptr;
+
+        SequenceTask get_return_object() { return SequenceTask(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        // The runtime destroys finished frames
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) { return FramePool::Allocate(size); }
+        static void operator delete(void* frame, size_t size) { FramePool::Free(frame, size); }
+    };
+
+    SequenceTask() = default;
+    SequenceTask(SequenceTask&& other) noexcept : handle(other.handle) { other.handle = {}; }
+    SequenceTask& operator=(SequenceTask&& other) noexcept;
+    SequenceTask(const SequenceTask&) = delete;
+    SequenceTask& operator=(const SequenceTask&) = delete;
+    ~SequenceTask();
+
+    // Hands the frame over; the task no longer destroys it
+    Handle Release();
+
+private:
+    explicit SequenceTask(Handle handle) : handle(handle) {
+    }
+
+    Handle handle;
+};
+
+// co_await WaitFor(event) / WaitForAny(events...): resumes with the event that
+// arrived. Car events only count from cars the binding accepts, and with a
+// condition only events whose snapshot passes it; an unknown event never
+// arrives. The condition must outlive the wait. With Within(ticks) the wait
+// gives up on the nth tick and resumes with GameEvent::Invalid.
+class EventAwaiter {
+public:
+    EventAwaiter(EventMask events, CarBinding binding, const Predicate* condition = nullptr)
+        : events(events), binding(binding), condition(condition && !condition->IsEmpty() ? condition : nullptr) {
+    }
+
+    // 0 waits for good
+    EventAwaiter Within(uint32_t ticks) const {
+        EventAwaiter timed = *this;
+        timed.timeout = ticks;
+        return timed;
+    }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(SequenceTask::Handle handle);
+    SequenceEvent await_resume() const noexcept { return result; }
+
+    // 0 for unknown events
+    constexpr static EventMask Bit(GameEvent event) {
+        return static_cast<size_t>(event) < GameEventCount ? EventBit(event) : 0;
+    }
+
+private:
+    friend class SequenceRuntime;
+
+    EventMask events;
+    CarBinding binding;
+    const Predicate* condition;
+    uint32_t timeout = 0;
+    uint64_t due = 0;
+    SequenceEvent result;
+    SequenceTask::Handle handle;
+};
+
+// co_await WaitTicks(n): resumes on the nth physics tick from now
+class TickAwaiter {
+public:
+    explicit TickAwaiter(uint32_t ticks) : ticks(ticks) {
+    }
+
+    bool await_ready() const noexcept { return ticks == 0; }
+    void await_suspend(SequenceTask::Handle handle);
+    void await_resume() const noexcept {}
+
+private:
+    friend class SequenceRuntime;
+
+    uint32_t ticks;
+    uint64_t due = 0;
+    SequenceTask::Handle handle;
+};
+
+EventAwaiter WaitFor(GameEvent event, CarBinding binding = CarBinding::Focus, const Predicate* condition = nullptr);
+EventAwaiter WaitForAny(EventMask events, CarBinding binding = CarBinding::Focus);
+template <typename... Events>
+EventAwaiter WaitForAny(GameEvent first, Events... rest) {
+    return WaitForAny((EventAwaiter::Bit(first) | ... | EventAwaiter::Bit(rest)));
+}
+TickAwaiter WaitTicks(uint32_t ticks);
+
+// Owns spawned tasks and resumes them from the engine's event dispatch and
+// tick. Everything runs on the caller's thread, inside those calls; ticks
+// are physics ticks (trace ticks) on the caller's clock.
+class SequenceRuntime {
+public:
+    using TaskId = uint64_t;
+
+    SequenceRuntime() = default;
+    ~SequenceRuntime();
+    SequenceRuntime(const SequenceRuntime&) = delete;
+    SequenceRuntime& operator=(const SequenceRuntime&) = delete;
+
+    // Runs the task up to its first co_await; 0 if it finished right away
+    TaskId Spawn(SequenceTask task, uint64_t tick);
+    // Resumes every task waiting on the event whose binding is one of
+    // bindings (bit per CarBinding) and whose condition holds for snapshot,
+    // in the order they started waiting. A task that waits on the same event
+    // again is not resumed twice. The snapshot is only read for events in
+    // GetConditionalEvents.
+    bool Dispatch(const SequenceEvent& event, uint8_t bindings, const WorldSnapshot& snapshot, uint64_t tick);
+    // Resumes the tasks whose WaitTicks is due, then the event waits that
+    // timed out
+    void Tick(uint64_t tick);
+
+    // A task that is running right now (it cancelled itself, or a nested
+    // call did) is destroyed once it suspends or returns
+    void Cancel(TaskId id);
+    void Clear();
+
+    bool IsWaiting(GameEvent event, uint8_t bindings, const WorldSnapshot& snapshot) const;
+    bool IsAlive(TaskId id) const;
+    EventMask GetWaitedEvents() const { return waitedEvents; }
+    // Car events waited on with a binding other than Focus
+    EventMask GetOtherCarEvents() const { return otherCarEvents; }
+    // Events some waiting task has a condition on
+    EventMask GetConditionalEvents() const { return conditionalEvents; }
+    bool HasTickWaiters() const { return !tickWaiters.empty() || !timedWaiters.empty(); }
+    size_t GetTaskCount() const { return tasks.size(); }
+
+private:
+    friend class EventAwaiter;
+    friend class TickAwaiter;
+
+    struct Task {
+        TaskId id;
+        SequenceTask::Handle handle;
+        bool running = false;
+        bool cancelled = false;
+    };
+
+    static bool Accepts(const EventAwaiter& waiter, EventMask bit, uint8_t bindings, const WorldSnapshot& snapshot);
+    void Resume(TaskId id);
+    // The ids to resume are collected in a buffer kept across calls; a
+    // nested Dispatch/Tick while it is out gets a fresh one
+    std::vector<TaskId> TakeResumeBuffer();
+    Task* Find(SequenceTask::Handle handle);
+    void Destroy(SequenceTask::Handle handle);
+    void UpdateMasks();
+
+    std::vector<Task> tasks;
+    std::vector<EventAwaiter*> eventWaiters; // In the order they started waiting
+    std::vector<TickAwaiter*> tickWaiters;
+    std::vector<EventAwaiter*> timedWaiters; // Event waits with a timeout, also in eventWaiters
+    std::vector<TaskId> resumeBuffer;
+    EventMask waitedEvents = 0;
+    EventMask otherCarEvents = 0;
+    EventMask conditionalEvents = 0;
+    uint64_t now = 0;
+    TaskId nextId = 1;
+};
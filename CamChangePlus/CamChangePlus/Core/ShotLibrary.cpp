@@ -0,0 +1,105 @@
+#include "ShotLibrary.h"
+
+#include <fstream>
+
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+    std::vector<ActionMapping> ParseSequence(const json& sequence) {
+        std::vector<ActionMapping> actions;
+        for (const auto& mapping : sequence) {
+            actions.push_back({
+                mapping["eventName"],
+                mapping["actionName"],
+                mapping["delay"],
+                mapping["customValue"],
+                mapping.value("duration", 0.0f),
+                mapping.value("curve", std::string("Linear")),
+                mapping.value("car", std::string("Focus Car")),
+                mapping.value("condition", std::string()),
+                mapping.value("after", std::vector<int>()),
+                mapping.value("join", std::string("All")),
+                mapping.value("timeout", 0.0f),
+                mapping.value("race", 0)
+                });
+        }
+        return actions;
+    }
+
+    bool ReadLibrary(const std::filesystem::path& filepath, json& j) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) return false;
+
+        file >> j;
+        return true;
+    }
+}
+
+ShotLibrary::ShotLibrary(std::filesystem::path filepath) : filepath(std::move(filepath)) {
+}
+
+std::filesystem::path ShotLibrary::DefaultPath(const std::filesystem::path& dataFolder) {
+    return dataFolder / "CamChangePlus_shots.json";
+}
+
+bool ShotLibrary::Exists() const {
+    return std::filesystem::exists(filepath);
+}
+
+bool ShotLibrary::Load(const std::string& sequenceName, std::vector<ActionMapping>& actions) const {
+    json j;
+    if (!ReadLibrary(filepath, j)) return false;
+
+    if (!j.contains("shots") || !j["shots"].contains(sequenceName)) return false;
+
+    actions = ParseSequence(j["shots"][sequenceName]);
+    return true;
+}
+
+bool ShotLibrary::Save(const std::string& sequenceName, const std::vector<ActionMapping>& actions) const {
+    // Load existing file if it exists
+    json j;
+    ReadLibrary(filepath, j);
+
+    // Store current sequence
+    j["shots"][sequenceName] = json::array();
+    for (const auto& action : actions) {
+        json mapping = {
+            {"eventName", action.eventName},
+            {"actionName", action.actionName},
+            {"delay", action.delay},
+            {"customValue", action.customValue},
+            {"duration", action.duration},
+            {"curve", action.curve},
+            {"car", action.car}
+        };
+        // Optional; older shots have none
+        if (!action.condition.empty()) mapping["condition"] = action.condition;
+        if (!action.after.empty()) mapping["after"] = action.after;
+        if (action.join != "All") mapping["join"] = action.join;
+        if (action.timeout > 0.0f) mapping["timeout"] = action.timeout;
+        if (action.race != 0) mapping["race"] = action.race;
+        j["shots"][sequenceName].push_back(std::move(mapping));
+    }
+
+    // Save back to file
+    std::ofstream file(filepath);
+    if (!file.is_open()) return false;
+
+    file << j.dump(4);
+    return true;
+}
+
+std::map<std::string, std::vector<ActionMapping>> ShotLibrary::LoadAll() const {
+    std::map<std::string, std::vector<ActionMapping>> shots;
+
+    json j;
+    if (!ReadLibrary(filepath, j) || !j.contains("shots")) return shots;
+
+    for (const auto& [name, sequence] : j["shots"].items()) {
+        shots[name] = ParseSequence(sequence);
+    }
+    return shots;
+}
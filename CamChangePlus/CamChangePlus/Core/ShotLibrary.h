@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <filesystem>
+
+#include "Sequence.h"
+
+// Reads and writes the "shots" object of CamChangePlus_shots.json
+class ShotLibrary {
+public:
+    explicit ShotLibrary(std::filesystem::path filepath);
+
+    static std::filesystem::path DefaultPath(const std::filesystem::path& dataFolder);
+
+    bool Exists() const;
+    bool Load(const std::string& sequenceName, std::vector<ActionMapping>& actions) const;
+    bool Save(const std::string& sequenceName, const std::vector<ActionMapping>& actions) const;
+    std::map<std::string, std::vector<ActionMapping>> LoadAll() const;
+
+    const std::filesystem::path& GetPath() const { return filepath; }
+
+private:
+    std::filesystem::path filepath;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+// Four-lane float vectors for the core's batched loops (ball ensemble, car
+// lanes). SSE2 where the target has it, plain loops with the same semantics
+// elsewhere. Only included from .cpp files.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CCP_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Four lanes of floats; comparisons return all-ones/all-zero lane masks
+#ifdef CCP_SIMD_SSE2
+struct F4 {
+    __m128 v;
+};
+
+inline F4 Load(const float* p) { return { _mm_load_ps(p) }; }
+inline void Store(float* p, F4 a) { _mm_store_ps(p, a.v); }
+inline F4 Splat(float x) { return { _mm_set1_ps(x) }; }
+inline F4 operator+(F4 a, F4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline F4 operator-(F4 a, F4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline F4 operator*(F4 a, F4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline F4 Less(F4 a, F4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline F4 And(F4 a, F4 b) { return { _mm_and_ps(a.v, b.v) }; }
+inline F4 AndNot(F4 mask, F4 a) { return { _mm_andnot_ps(mask.v, a.v) }; }
+inline F4 Or(F4 a, F4 b) { return { _mm_or_ps(a.v, b.v) }; }
+inline int MoveMask(F4 mask) { return _mm_movemask_ps(mask.v); }
+#else
+struct F4 {
+    float v[4];
+};
+
+template <typename Op>
+inline F4 Map(F4 a, F4 b, Op op) {
+    F4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]);
+    return r;
+}
+template <typename Op>
+inline F4 MapBits(F4 a, F4 b, Op op) {
+    return Map(a, b, [op](float x, float y) {
+        return std::bit_cast<float>(op(std::bit_cast<uint32_t>(x), std::bit_cast<uint32_t>(y)));
+        });
+}
+
+inline F4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void Store(float* p, F4 a) { std::copy(a.v, a.v + 4, p); }
+inline F4 Splat(float x) { return { { x, x, x, x } }; }
+inline F4 operator+(F4 a, F4 b) { return Map(a, b, [](float x, float y) { return x + y; }); }
+inline F4 operator-(F4 a, F4 b) { return Map(a, b, [](float x, float y) { return x - y; }); }
+inline F4 operator*(F4 a, F4 b) { return Map(a, b, [](float x, float y) { return x * y; }); }
+inline F4 Less(F4 a, F4 b) {
+    return Map(a, b, [](float x, float y) { return std::bit_cast<float>(x < y ? 0xFFFFFFFFu : 0u); });
+}
+inline F4 And(F4 a, F4 b) { return MapBits(a, b, [](uint32_t x, uint32_t y) { return x & y; }); }
+inline F4 AndNot(F4 mask, F4 a) { return MapBits(mask, a, [](uint32_t x, uint32_t y) { return ~x & y; }); }
+inline F4 Or(F4 a, F4 b) { return MapBits(a, b, [](uint32_t x, uint32_t y) { return x | y; }); }
+inline int MoveMask(F4 mask) {
+    int bits = 0;
+    for (int i = 0; i < 4; ++i) bits |= static_cast<int>(std::bit_cast<uint32_t>(mask.v[i]) >> 31) << i;
+    return bits;
+}
+#endif
+
+inline F4 Select(F4 mask, F4 a, F4 b) { return Or(And(mask, a), AndNot(mask, b)); }
+inline F4 Abs(F4 a) { return AndNot(Splat(-0.0f), a); }
+// |magnitude| with the sign of sign
+inline F4 CopySign(F4 magnitude, F4 sign) { return Or(Abs(magnitude), And(Splat(-0.0f), sign)); }
@@ -0,0 +1,98 @@
+#include "Test.h"
+
+#include "AutoTuner.h"
+
+namespace {
+    // One trace of (time, event) pairs with the targets for sequence "shot";
+    // target times count from the first event
+    std::vector<BatchTrace> MakeTraces(std::initializer_list<std::pair<double, GameEvent>> entries, std::vector<FireTarget> targets) {
+        std::vector<TraceEvent> events;
+        for (const auto& [time, event] : entries) {
+            TraceEvent traced{};
+            traced.time = time;
+            traced.tick = static_cast<uint64_t>(time * TraceTickRate);
+            traced.event = event;
+            events.push_back(traced);
+        }
+        std::vector<BatchTrace> traces(1);
+        traces[0].name = "trace";
+        traces[0].replay = TraceReplay(std::move(events));
+        traces[0].targets["shot"] = std::move(targets);
+        return traces;
+    }
+}
+
+CCP_TEST(AutoTuner, DelaysConvergeOnTargetTimes) {
+    std::vector<BatchTrace> traces = MakeTraces({ { 1.0, GameEvent::Jump }, { 3.0, GameEvent::BallTouch } }, { { 0, 0.5 }, { 1, 2.4 } });
+    ThreadPool pool(2);
+    AutoTuner tuner(pool, traces);
+
+    TuneResult result = tuner.Tune("shot", { Step("Jump", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam") });
+    CCP_CHECK(result.finalCost < result.initialCost);
+    CCP_CHECK(result.evaluations > 0);
+    CCP_CHECK_NEAR(result.sequence[0].delay, 0.5, 0.02);
+    CCP_CHECK_NEAR(result.sequence[1].delay, 0.4, 0.02);
+    CCP_CHECK_NEAR(result.finalCost, 0.0, 0.02);
+}
+
+CCP_TEST(AutoTuner, NeverFiredTargetsCostTheMissPenalty) {
+    std::vector<BatchTrace> traces = MakeTraces({ { 1.0, GameEvent::Jump } }, { { 0, 0.0 }, { 1, 1.0 } });
+    ThreadPool pool(2);
+    AutoTuner tuner(pool, traces);
+
+    // The touch never happens, so half the targets miss whatever the delays
+    double cost = tuner.Cost("shot", { Step("Jump", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam") });
+    CCP_CHECK_NEAR(cost, TuneOptions{}.missPenalty / 2.0, 0.01);
+}
+
+CCP_TEST(AutoTuner, ValuesReachTargetsInTheActionsOwnRange) {
+    // Both targets lie outside the yaw percent range every value used to be held to
+    std::vector<BatchTrace> traces = MakeTraces({ { 0.0, GameEvent::Jump }, { 1.0, GameEvent::BallTouch } },
+        { { 0, 0.0, true, 105.0f }, { 1, 1.0, true, 130.0f } });
+    ThreadPool pool(2);
+    AutoTuner tuner(pool, traces);
+    ActionMapping fov = Step("Jump", "Rig FOV");
+    fov.customValue = 90.0f;
+    ActionMapping distance = Step("Ball Touch", "Rig Distance");
+    distance.customValue = 300.0f;
+
+    TuneOptions options;
+    options.tuneValues = true;
+    TuneResult result = tuner.Tune("shot", { fov, distance }, options);
+    CCP_CHECK_NEAR(result.sequence[0].customValue, 105.0, 0.5);
+    CCP_CHECK_NEAR(result.sequence[1].customValue, 130.0, 0.5);
+    CCP_CHECK(result.finalCost < result.initialCost);
+}
+
+CCP_TEST(AutoTuner, ValuesClampToTheActionsRange) {
+    std::vector<BatchTrace> traces = MakeTraces({ { 0.0, GameEvent::Jump } }, { { 0, 0.0, true, 150.0f } });
+    ThreadPool pool(2);
+    AutoTuner tuner(pool, traces);
+    ActionMapping fov = Step("Jump", "Rig FOV");
+    fov.customValue = 90.0f;
+
+    TuneOptions options;
+    options.tuneValues = true;
+    TuneResult result = tuner.Tune("shot", { fov }, options);
+    CCP_CHECK_NEAR(result.sequence[0].customValue, 110.0, 0.001);
+}
+
+CCP_TEST(AutoTuner, PredictedStepsTuneAheadOfTheContact) {
+    // The wall hit is predicted at 2.0 for a contact at 3.0; the cut belongs 0.4 s before it
+    std::vector<TraceEvent> events(2);
+    events[0].event = GameEvent::Jump;
+    events[1].time = 2.0;
+    events[1].tick = 240;
+    events[1].event = GameEvent::PredictedWallHit;
+    events[1].lead = 1.0f;
+    std::vector<BatchTrace> traces(1);
+    traces[0].name = "trace";
+    traces[0].replay = TraceReplay(std::move(events));
+    traces[0].targets["shot"] = { { 0, 2.6 } };
+    ThreadPool pool(2);
+    AutoTuner tuner(pool, traces);
+
+    TuneResult result = tuner.Tune("shot", { Step("Predicted Wall Hit", "Enable Ball Cam") });
+    CCP_CHECK_NEAR(result.sequence[0].delay, -0.4, 0.02);
+    CCP_CHECK_NEAR(result.finalCost, 0.0, 0.02);
+}
@@ -0,0 +1,54 @@
+#include "Test.h"
+
+#include "BallPredictor.h"
+
+namespace {
+    BallPrediction Predict(CamVector location, CamVector velocity) {
+        BallState ball{};
+        ball.location = location;
+        ball.velocity = velocity;
+        BallPrediction prediction;
+        BallPredictor().Predict(ball, prediction);
+        return prediction;
+    }
+
+    // Integration runs in whole steps, so times land on the step grid
+    constexpr double stepTolerance = 2.0 / 120.0;
+}
+
+CCP_TEST(BallPredictor, SideWallHitTiming) {
+    // 1003 units to the wall at 2000 u/s, slowed a little by drag
+    BallPrediction prediction = Predict({ 3000.0f, 0.0f, 1000.0f }, { 2000.0f, 0.0f, 0.0f });
+    const PredictedHit& wall = prediction.Get(BallHitKind::Wall);
+    CCP_CHECK(wall.valid);
+    CCP_CHECK_NEAR(wall.time, 0.508, stepTolerance);
+    CCP_CHECK(wall.confidence == 1.0f);
+    CCP_CHECK_NEAR(wall.location.X, BallPredictor::sideWall - BallPredictor::radius, 10.0);
+    CCP_CHECK(!prediction.Get(BallHitKind::GoalLine).valid);
+}
+
+CCP_TEST(BallPredictor, DroppedBallBouncesAfterFreeFall) {
+    // sqrt(2 * 907 / 650) = 1.67 s to fall onto the floor
+    BallPrediction prediction = Predict({ 0.0f, 0.0f, 1000.0f }, {});
+    const PredictedHit& bounce = prediction.Get(BallHitKind::FloorBounce);
+    CCP_CHECK(bounce.valid);
+    CCP_CHECK_NEAR(bounce.time, 1.683, stepTolerance);
+    CCP_CHECK(!prediction.Get(BallHitKind::Wall).valid);
+}
+
+CCP_TEST(BallPredictor, GoalMouthCrossesTheLineInsteadOfBouncing) {
+    BallPrediction prediction = Predict({ 0.0f, 4500.0f, 300.0f }, { 0.0f, 1500.0f, 0.0f });
+    const PredictedHit& goal = prediction.Get(BallHitKind::GoalLine);
+    CCP_CHECK(goal.valid);
+    CCP_CHECK_NEAR(goal.time, 0.483, stepTolerance);
+    CCP_CHECK(goal.location.Y > BallPredictor::backWall + BallPredictor::radius);
+    CCP_CHECK(!prediction.Get(BallHitKind::Wall).valid);
+}
+
+CCP_TEST(BallPredictor, RollingBallPredictsNothing) {
+    BallPrediction prediction = Predict({ 0.0f, 0.0f, BallPredictor::radius }, { 100.0f, 0.0f, 0.0f });
+    for (const PredictedHit& hit : prediction.hits) CCP_CHECK(!hit.valid);
+    // With nothing to find the whole horizon is integrated
+    BallPredictorOptions options;
+    CCP_CHECK(prediction.steps == static_cast<int>(options.horizon / options.timeStep));
+}
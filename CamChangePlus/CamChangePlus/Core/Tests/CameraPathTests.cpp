@@ -0,0 +1,135 @@
+#include "Test.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "CameraPath.h"
+#include "TraceReplay.h"
+
+namespace {
+    std::filesystem::path TempPath(const char* name) {
+        return std::filesystem::temp_directory_path() / name;
+    }
+
+    bool SameSample(const CameraPathSample& a, const CameraPathSample& b) {
+        // Settings are stored in hundredths
+        return a.tick == b.tick && a.yaw == b.yaw && a.pitch == b.pitch && a.flags == b.flags &&
+            std::abs(a.fov - b.fov) < 0.006f && std::abs(a.distance - b.distance) < 0.006f &&
+            std::abs(a.height - b.height) < 0.006f && std::abs(a.angle - b.angle) < 0.006f;
+    }
+}
+
+CCP_TEST(CameraPath, RoundTripsSamples) {
+    std::vector<CameraPathSample> samples;
+    for (uint64_t i = 0; i < 2000; ++i) {
+        CameraPathSample sample;
+        sample.tick = 1000 + i + (i > 1500 ? 50 : 0); // A gap, as after a seek
+        sample.yaw = static_cast<int32_t>(i % 400) * 60 - 12000;
+        sample.pitch = i > 1000 ? -900 : 0;
+        sample.fov = 90.0f + static_cast<float>(i % 7) * 1.37f;
+        sample.distance = i > 500 ? 310.25f : 270.0f;
+        sample.angle = -4.0f - static_cast<float>(i % 3);
+        sample.flags = i > 700 ? CameraPathFlag_BallCam : CameraPathFlag_BehindView;
+        samples.push_back(sample);
+    }
+
+    std::filesystem::path path = TempPath("camchange_tests_path.ccpc");
+    CameraPathWriter writer;
+    CCP_CHECK(writer.Open(path, 60.0));
+    for (const auto& sample : samples) writer.Append(sample);
+    CCP_CHECK(writer.Close());
+    CCP_CHECK(writer.GetSampleCount() == samples.size());
+
+    CameraPathReader reader;
+    CCP_CHECK(reader.Open(path));
+    CCP_CHECK(reader.GetTickRate() == 60.0);
+    CameraPathSample sample;
+    size_t count = 0;
+    while (reader.Next(sample)) {
+        if (count < samples.size()) CCP_CHECK(SameSample(sample, samples[count]));
+        count++;
+    }
+    CCP_CHECK(count == samples.size());
+    CCP_CHECK(reader.GetError().empty());
+    std::filesystem::remove(path);
+}
+
+CCP_TEST(CameraPath, StillCameraCostsTwoBytesATick) {
+    // Byte counts are of what was written out, so compare closed files
+    std::filesystem::path path = TempPath("camchange_tests_still.ccpc");
+    auto write = [&](uint64_t ticks) {
+        CameraPathWriter writer;
+        CCP_CHECK(writer.Open(path));
+        CameraPathSample sample;
+        for (uint64_t tick = 0; tick <= ticks; ++tick) {
+            sample.tick = tick;
+            writer.Append(sample);
+        }
+        writer.Close();
+        return writer.GetByteCount();
+    };
+    CCP_CHECK(write(100) - write(0) == 200);
+    std::filesystem::remove(path);
+}
+
+CCP_TEST(CameraPath, RejectsForeignAndTruncatedFiles) {
+    std::filesystem::path path = TempPath("camchange_tests_bad.ccpc");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a camera path at all";
+    }
+    CameraPathReader foreign;
+    CCP_CHECK(!foreign.Open(path));
+    CCP_CHECK(!foreign.GetError().empty());
+
+    CameraPathWriter writer;
+    CCP_CHECK(writer.Open(path));
+    CameraPathSample sample;
+    sample.yaw = 5000;
+    writer.Append(sample);
+    writer.Close();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    CameraPathReader truncated;
+    CCP_CHECK(truncated.Open(path));
+    CCP_CHECK(!truncated.Next(sample));
+    CCP_CHECK(!truncated.GetError().empty());
+    std::filesystem::remove(path);
+}
+
+CCP_TEST(CameraPath, BakeWritesEveryTickOfTheRun) {
+    std::vector<TraceEvent> events(2);
+    events[0].time = 1.0;
+    events[0].tick = 120;
+    events[0].event = GameEvent::Jump;
+    events[1].time = 2.0;
+    events[1].tick = 240;
+    events[1].event = GameEvent::Flip;
+    TraceReplay replay(std::move(events));
+
+    std::filesystem::path path = TempPath("camchange_tests_bake.ccpc");
+    CameraPathWriter writer;
+    CCP_CHECK(writer.Open(path));
+    ReplayResult result = replay.Bake({ Step("Jump", "Enable Reverse Cam"), Step("Flip", "Enable Ball Cam", 0.5f) }, writer);
+    CCP_CHECK(writer.Close());
+    CCP_CHECK(result.completed);
+    CCP_CHECK(result.timeline.size() == 2);
+
+    // One sample per tick from the first event through the drain time
+    CameraPathReader reader;
+    CCP_CHECK(reader.Open(path));
+    CameraPathSample sample;
+    uint64_t samples = 0, reverseTick = 0, ballTick = 0;
+    while (reader.Next(sample)) {
+        CCP_CHECK(sample.tick == 120 + samples);
+        if (!reverseTick && (sample.flags & CameraPathFlag_BehindView)) reverseTick = sample.tick;
+        if (!ballTick && (sample.flags & CameraPathFlag_BallCam)) ballTick = sample.tick;
+        samples++;
+    }
+    CCP_CHECK(reader.GetError().empty());
+    CCP_CHECK(samples == writer.GetSampleCount());
+    CCP_CHECK(samples == static_cast<uint64_t>((2.0 + TraceReplay::drainTime) * TraceTickRate) - 120 + 1);
+    CCP_CHECK(reverseTick == 120);
+    CCP_CHECK(ballTick == 300);
+    std::filesystem::remove(path);
+}
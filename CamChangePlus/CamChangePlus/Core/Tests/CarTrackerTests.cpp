@@ -0,0 +1,114 @@
+#include "Test.h"
+
+#include "CarTracker.h"
+
+namespace {
+    constexpr float dt = 1.0f / 120.0f;
+
+    // Eight grounded cars, four per team, so both SIMD blocks carry cars
+    std::vector<MatchCar> MakeCars() {
+        std::vector<MatchCar> cars(CarTracker::capacity);
+        for (size_t i = 0; i < cars.size(); ++i) {
+            cars[i].handle = 100 + i;
+            cars[i].team = i < 4 ? 0 : 1;
+            cars[i].state.location.Z = 17.0f;
+        }
+        return cars;
+    }
+
+    bool HasEvent(const CarTracker& tracker, GameEvent event, CarHandle car) {
+        for (size_t i = 0; i < tracker.GetEventCount(); ++i) {
+            if (tracker.GetEvents()[i].event == event && tracker.GetEvents()[i].car == car) return true;
+        }
+        return false;
+    }
+}
+
+CCP_TEST(CarTracker, FirstUpdateOnlyPrimes) {
+    CarTracker tracker;
+    std::vector<MatchCar> cars = MakeCars();
+    cars[5].state.onGround = false;
+    cars[5].state.location.Z = 500.0f;
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(tracker.GetEventCount() == 0);
+    CCP_CHECK(tracker.GetCarCount() == CarTracker::capacity);
+}
+
+CCP_TEST(CarTracker, JumpsNeedUpwardSpeed) {
+    CarTracker tracker;
+    std::vector<MatchCar> cars = MakeCars();
+    tracker.Update(cars.data(), cars.size(), dt);
+
+    // Car 1 jumps, car 6 (second block) jumps, car 3 rolls off a ledge
+    for (size_t i : { 1, 6, 3 }) cars[i].state.onGround = false;
+    cars[1].state.velocity.Z = 300.0f;
+    cars[6].state.velocity.Z = 300.0f;
+    cars[3].state.velocity.Z = -10.0f;
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(tracker.GetEventCount() == 2);
+    CCP_CHECK(HasEvent(tracker, GameEvent::Jump, 101));
+    CCP_CHECK(HasEvent(tracker, GameEvent::Jump, 106));
+    if (tracker.GetEventCount() == 2) CCP_CHECK(tracker.GetEvents()[1].team == 1);
+}
+
+CCP_TEST(CarTracker, LandingAndAerialEdges) {
+    CarTracker tracker;
+    std::vector<MatchCar> cars = MakeCars();
+    tracker.Update(cars.data(), cars.size(), dt);
+
+    cars[7].state.onGround = false;
+    cars[7].state.velocity.Z = 500.0f;
+    tracker.Update(cars.data(), cars.size(), dt);
+    cars[7].state.location.Z = 300.0f;
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(HasEvent(tracker, GameEvent::AerialStart, 107));
+    // Staying high raises it once
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(tracker.GetEventCount() == 0);
+
+    // 0.25 s airborne in all, then down
+    for (int i = 0; i < 27; ++i) tracker.Update(cars.data(), cars.size(), dt);
+    cars[7].state.onGround = true;
+    cars[7].state.location.Z = 17.0f;
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(HasEvent(tracker, GameEvent::Landing, 107));
+
+    // A short hop lands without a landing event
+    cars[0].state.onGround = false;
+    tracker.Update(cars.data(), cars.size(), dt);
+    cars[0].state.onGround = true;
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(!HasEvent(tracker, GameEvent::Landing, 100));
+}
+
+CCP_TEST(CarTracker, DepartedLaneIsReusedByANewCar) {
+    CarTracker tracker;
+    std::vector<MatchCar> cars = MakeCars();
+    tracker.Update(cars.data(), cars.size(), dt);
+
+    // Car 102 leaves: nothing is raised and its team stays known for a tick
+    MatchCar departed = cars[2];
+    cars.erase(cars.begin() + 2);
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(tracker.GetEventCount() == 0);
+    CCP_CHECK(tracker.GetCarCount() == CarTracker::capacity - 1);
+    CCP_CHECK(tracker.FindTeam(102) == 0);
+
+    // A car joining airborne takes the lane and only primes it
+    departed.handle = 200;
+    departed.team = 1;
+    departed.state.onGround = false;
+    departed.state.velocity.Z = 400.0f;
+    cars.push_back(departed);
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(tracker.GetEventCount() == 0);
+    CCP_CHECK(tracker.FindTeam(102) == -1);
+    CCP_CHECK(tracker.FindTeam(200) == 1);
+
+    // The other cars kept their lanes and state
+    cars[0].state.onGround = false;
+    cars[0].state.velocity.Z = 300.0f;
+    tracker.Update(cars.data(), cars.size(), dt);
+    CCP_CHECK(tracker.GetEventCount() == 1);
+    CCP_CHECK(HasEvent(tracker, GameEvent::Jump, 100));
+}
@@ -0,0 +1,317 @@
+#include "Test.h"
+
+#include "MockHost.h"
+#include "SequenceEngine.h"
+
+namespace {
+    // An engine with hooks enabled on a quiet mock host
+    struct Fixture {
+        MockHost host;
+        SequenceEngine engine{ host };
+
+        Fixture() {
+            host.keepLog = false;
+            engine.HookGameEvents();
+        }
+
+        // What would crash in game fails every test
+        ~Fixture() {
+            CCP_CHECK(host.hookChangesWhileFiring == 0);
+        }
+
+        void Fire(GameEvent event, CarHandle caller = 0) {
+            host.FireEvent(GetEventInfo(event).hookName, caller);
+        }
+
+        // Physics ticks on the virtual clock
+        void Tick(int count) {
+            for (int i = 0; i < count; ++i) {
+                host.AdvanceTime(1.0 / TraceTickRate);
+                host.FireEvent(SequenceEngine::tickHook);
+            }
+        }
+    };
+}
+
+CCP_TEST(Engine, PlainSequenceRunsInOrder) {
+    Fixture f;
+    f.engine.SetSequence("shot", { Step("Jump", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam") });
+    f.engine.StartSequencePlayback();
+    CCP_CHECK(f.engine.IsRunning());
+    CCP_CHECK(f.host.IsHooked(GetEventInfo(GameEvent::Jump).hookName));
+
+    // The touch isn't armed yet
+    f.Fire(GameEvent::BallTouch);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(f.engine.GetCurrentStep() == 0);
+    CCP_CHECK(!f.host.usingSecondaryCamera);
+
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(f.engine.GetCurrentStep() == 1);
+    CCP_CHECK(f.host.usingBehindView);
+
+    f.Fire(GameEvent::BallTouch);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+    // Once: the camera goes back to default and playback stops
+    CCP_CHECK(!f.engine.IsRunning());
+    CCP_CHECK(!f.host.usingBehindView);
+    CCP_CHECK(f.engine.GetHooks().GetInstalledCount() == 0);
+}
+
+CCP_TEST(Engine, DelayedActionWaitsForItsTimer) {
+    Fixture f;
+    f.engine.SetSequence("shot", { Step("Jump", "Enable Ball Cam", 0.5f), Step("Flip", "Disable Ball Cam") });
+    f.engine.StartSequencePlayback();
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.4);
+    CCP_CHECK(!f.host.usingSecondaryCamera);
+    f.host.AdvanceTime(0.2);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+}
+
+CCP_TEST(Engine, LastDelayedActionLandsAfterCompletion) {
+    Fixture f;
+    f.engine.SetSequence("shot", { Step("Jump", "Enable Reverse Cam"), Step("Flip", "Enable Ball Cam", 0.5f) });
+    f.engine.StartSequencePlayback();
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.3);
+    f.Fire(GameEvent::Flip);
+    f.host.AdvanceTime(0.1);
+    // The sequence reset as the last step matched; its action is still due
+    CCP_CHECK(!f.engine.IsRunning());
+    CCP_CHECK(!f.host.usingBehindView);
+    CCP_CHECK(!f.host.usingSecondaryCamera);
+    f.host.AdvanceTime(0.5);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+}
+
+CCP_TEST(Engine, MockHostFlagsUnhookFromInsideAHook) {
+    MockHost host;
+    host.keepLog = false;
+    int calls = 0;
+    host.HookEvent("Function Test.Hook", [&]() {
+        calls++;
+        host.UnhookEvent("Function Test.Hook");
+        });
+    CCP_CHECK(host.FireEvent("Function Test.Hook"));
+    CCP_CHECK(calls == 1);
+    CCP_CHECK(host.hookChangesWhileFiring == 1);
+    CCP_CHECK(!host.IsHooked("Function Test.Hook"));
+}
+
+CCP_TEST(Engine, TouchBurstAdvancesOneStep) {
+    Fixture f;
+    f.engine.SetSequence("shot", { Step("Ball Touch", "Enable Ball Cam"), Step("Ball Touch", "Disable Ball Cam") });
+    f.engine.StartSequencePlayback();
+
+    // A dribble's touches inside the 0.2 s window are one event
+    f.Fire(GameEvent::BallTouch);
+    f.Tick(12);
+    f.Fire(GameEvent::BallTouch);
+    f.Tick(1);
+    CCP_CHECK(f.engine.GetCurrentStep() == 1);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+
+    f.Tick(24);
+    f.Fire(GameEvent::BallTouch);
+    f.Tick(1);
+    CCP_CHECK(!f.engine.IsRunning());
+    CCP_CHECK(!f.host.usingSecondaryCamera);
+}
+
+CCP_TEST(Engine, SpectatedCarJumpsUseItsOwnState) {
+    Fixture f;
+    f.host.hasLocalCar = false;
+    f.host.spectatedCar = 7;
+    MatchCar spectated;
+    spectated.handle = 7;
+    spectated.state.onGround = true;
+    f.host.cars.push_back(spectated);
+
+    f.engine.SetSequence("shot", { Step("Jump", "Enable Reverse Cam"), Step("Double Jump", "Enable Ball Cam") });
+    f.engine.StartSequencePlayback();
+    f.Fire(GameEvent::Jump, 7);
+    f.host.AdvanceTime(0.3);
+    CCP_CHECK(f.engine.GetCurrentStep() == 1);
+
+    f.host.cars[0].state.onGround = false;
+    f.Fire(GameEvent::DoubleJump, 7);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+    CCP_CHECK(!f.engine.IsRunning());
+}
+
+CCP_TEST(Engine, OtherCarsNeedTheirBinding) {
+    Fixture f;
+    ActionMapping anyTouch = Step("Ball Touch", "Enable Ball Cam");
+    anyTouch.car = "Any Car";
+    f.engine.SetSequence("shot", { Step("Ball Touch", "Enable Reverse Cam"), anyTouch, Step("Jump", "Disable Ball Cam") });
+    f.engine.StartSequencePlayback();
+
+    // The armed step is bound to the focus car
+    f.Fire(GameEvent::BallTouch, 9);
+    f.host.AdvanceTime(0.3);
+    CCP_CHECK(f.engine.GetCurrentStep() == 0);
+
+    f.Fire(GameEvent::BallTouch);
+    f.host.AdvanceTime(0.3);
+    f.Fire(GameEvent::BallTouch, 9);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(f.engine.GetCurrentStep() == 2);
+}
+
+CCP_TEST(Engine, DepartedCarIsNotADemolition) {
+    Fixture f;
+    CarState ground;
+    ground.onGround = true;
+    f.host.cars = { { 1, 0, ground }, { 2, 1, ground }, { 3, 1, ground } };
+    ActionMapping demolition = Step("Demolition", "Enable Ball Cam");
+    demolition.car = "Orange Team";
+    f.engine.SetSequence("shot", { demolition, Step("Jump", "Disable Ball Cam") });
+    f.engine.StartSequencePlayback();
+    f.Tick(5);
+
+    // Leaving the match (or respawning under a new handle) raises nothing
+    f.host.cars.pop_back();
+    f.Tick(2);
+    CCP_CHECK(f.engine.GetCurrentStep() == 0);
+
+    // The demolished hook reports the car while it is still in the match
+    f.Fire(GameEvent::Demolition, 2);
+    f.host.cars.pop_back();
+    f.Tick(2);
+    CCP_CHECK(f.engine.GetCurrentStep() == 1);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+}
+
+CCP_TEST(Engine, ReplaySeekRestoresCheckpointAndReplaysJournal) {
+    Fixture f;
+    f.host.inReplay = true;
+    f.host.replayTime = 10.0;
+    f.engine.SetSequence("shot", { Step("Ball Touch", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam", 2.0f), Step("Explosion", "Disable Reverse Cam") });
+    f.engine.StartSequencePlayback();
+
+    // Replay frames at 60 fps, moving replay time with the clock
+    auto frames = [&f](double seconds) {
+        for (int i = 0; i < static_cast<int>(seconds * 60.0 + 0.5); ++i) {
+            f.host.AdvanceTime(1.0 / 60.0);
+            f.host.replayTime += 1.0 / 60.0;
+            f.host.FireEvent(SequenceEngine::replayFrameHook);
+        }
+    };
+    frames(1.5);
+    f.Fire(GameEvent::BallTouch);
+    frames(0.5);
+    f.Fire(GameEvent::BallTouch);
+    frames(3.0);
+    f.Fire(GameEvent::Explosion);
+    frames(0.5);
+    CCP_CHECK(!f.engine.IsRunning());
+    CCP_CHECK(f.engine.GetReplayTimeline().GetEventCount() == 3);
+
+    // Back to 12.5: the checkpoint at 12.0 plus the touch journaled there
+    // leave reverse cam on and the delayed ball cam pending again
+    f.host.usingSecondaryCamera = false;
+    f.host.replayTime = 12.5;
+    frames(1.0 / 60.0);
+    CCP_CHECK(f.engine.IsRunning());
+    CCP_CHECK(f.engine.GetCurrentStep() == 2);
+    CCP_CHECK(f.host.usingBehindView);
+    CCP_CHECK(f.host.PendingTimers() == 1);
+    frames(1.6);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+
+    // Before the first touch: nothing has happened yet
+    f.host.replayTime = 11.0;
+    frames(1.0 / 60.0);
+    CCP_CHECK(f.engine.GetCurrentStep() == 0);
+    CCP_CHECK(!f.host.usingBehindView);
+    CCP_CHECK(f.host.PendingTimers() == 0);
+}
+
+CCP_TEST(Engine, ConditionLeavesStepWaiting) {
+    Fixture f;
+    ActionMapping fast = Step("Ball Touch", "Enable Ball Cam");
+    fast.condition = "car.speed > 1800";
+    f.engine.SetSequence("shot", { fast, Step("Jump", "Disable Ball Cam") });
+    f.engine.StartSequencePlayback();
+
+    f.host.localCar.velocity = { 1000.0f, 0.0f, 0.0f };
+    f.Fire(GameEvent::BallTouch);
+    f.host.AdvanceTime(0.5);
+    CCP_CHECK(f.engine.GetCurrentStep() == 0);
+
+    f.host.localCar.velocity = { 2000.0f, 0.0f, 0.0f };
+    f.Fire(GameEvent::BallTouch);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(f.engine.GetCurrentStep() == 1);
+    CCP_CHECK(f.host.usingSecondaryCamera);
+}
+
+CCP_TEST(Engine, StepTimeoutDropsItsBranch) {
+    Fixture f;
+    ActionMapping touch = Step("Ball Touch", "Enable Ball Cam");
+    touch.timeout = 0.5f;
+    ActionMapping jump = Step("Jump", "Enable Reverse Cam");
+    jump.after = { 0 };
+    f.engine.SetSequence("shot", { touch, jump });
+    f.engine.StartSequencePlayback();
+
+    f.Tick(70);
+    CCP_CHECK(f.engine.GetGraphState().cancelled == 0b01);
+    CCP_CHECK(f.engine.IsRunning());
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.1);
+    CCP_CHECK(!f.engine.IsRunning());
+    CCP_CHECK(f.engine.GetGraphState().fired == 0b10);
+}
+
+CCP_TEST(Engine, LoopModeWrapsWithoutStopping) {
+    Fixture f;
+    f.engine.SetPlaybackMode(PlaybackMode::Loop);
+    f.engine.SetSequence("shot", { Step("Jump", "Toggle Reverse Cam") });
+    f.engine.StartSequencePlayback();
+
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.3);
+    CCP_CHECK(f.engine.IsRunning());
+    CCP_CHECK(f.engine.GetIterations() == 1);
+    // Loop keeps the camera as the shot left it
+    CCP_CHECK(f.host.usingBehindView);
+
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.3);
+    CCP_CHECK(f.engine.GetIterations() == 2);
+    CCP_CHECK(!f.host.usingBehindView);
+
+    f.engine.StopSequencePlayback();
+    CCP_CHECK(!f.engine.IsRunning());
+    // Unhooks are deferred to the game thread
+    f.host.Flush();
+    CCP_CHECK(f.engine.GetHooks().GetInstalledCount() == 0);
+}
+
+CCP_TEST(Engine, RearmModeResetsTheCameraAndStartsOver) {
+    Fixture f;
+    f.engine.SetPlaybackMode(PlaybackMode::Rearm);
+    f.engine.SetSequence("shot", { Step("Jump", "Enable Reverse Cam"), Step("Flip", "Enable Ball Cam") });
+    f.engine.StartSequencePlayback();
+
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.3);
+    f.Fire(GameEvent::Flip);
+    f.host.AdvanceTime(0.3);
+    CCP_CHECK(f.engine.IsRunning());
+    CCP_CHECK(f.engine.GetIterations() == 1);
+    CCP_CHECK(f.engine.GetCurrentStep() == 0);
+    CCP_CHECK(!f.host.usingBehindView);
+
+    // The hooks stayed installed across the wrap
+    CCP_CHECK(f.host.IsHooked(GetEventInfo(GameEvent::Jump).hookName));
+    f.Fire(GameEvent::Jump);
+    f.host.AdvanceTime(0.3);
+    CCP_CHECK(f.engine.GetCurrentStep() == 1);
+    CCP_CHECK(f.host.usingBehindView);
+}
@@ -0,0 +1,134 @@
+#include "Test.h"
+
+#include "EventDetector.h"
+
+namespace {
+    // A grounded car with half its boost and a resting ball
+    WorldSnapshot MakeSnapshot(double time) {
+        WorldSnapshot snapshot;
+        snapshot.time = time;
+        snapshot.hasCar = true;
+        snapshot.car.boost = 0.5f;
+        snapshot.hasBall = true;
+        snapshot.ball.location = { 0.0f, 0.0f, 93.0f };
+        return snapshot;
+    }
+
+    constexpr double tick = 1.0 / 120.0;
+}
+
+CCP_TEST(EventDetector, FirstScanOnlyPrimes) {
+    EventDetector detector;
+    WorldSnapshot snapshot = MakeSnapshot(1.0);
+    snapshot.car.supersonic = true;
+    CCP_CHECK(detector.Scan(snapshot) == 0);
+    CCP_CHECK(detector.GetActive() & EventBit(GameEvent::Supersonic));
+
+    // A level that stays up doesn't fire again
+    snapshot.time += tick;
+    CCP_CHECK(detector.Scan(snapshot) == 0);
+}
+
+CCP_TEST(EventDetector, RisingEdgesFireOnce) {
+    EventDetector detector;
+    WorldSnapshot snapshot = MakeSnapshot(1.0);
+    detector.Scan(snapshot);
+
+    snapshot.time += tick;
+    snapshot.car.boost = 0.0f;
+    snapshot.car.supersonic = true;
+    CCP_CHECK(detector.Scan(snapshot) == (EventBit(GameEvent::BoostEmpty) | EventBit(GameEvent::Supersonic)));
+    snapshot.time += tick;
+    CCP_CHECK(detector.Scan(snapshot) == 0);
+}
+
+CCP_TEST(EventDetector, LandingNeedsEnoughAirTime) {
+    EventDetector detector;
+    WorldSnapshot snapshot = MakeSnapshot(1.0);
+    detector.Scan(snapshot);
+
+    // A 0.1 s hop isn't a landing
+    snapshot.car.onGround = false;
+    for (int i = 0; i < 12; ++i) {
+        snapshot.time += tick;
+        detector.Scan(snapshot);
+    }
+    snapshot.car.onGround = true;
+    snapshot.time += tick;
+    CCP_CHECK(!(detector.Scan(snapshot) & EventBit(GameEvent::Landing)));
+
+    snapshot.car.onGround = false;
+    for (int i = 0; i < 36; ++i) {
+        snapshot.time += tick;
+        detector.Scan(snapshot);
+    }
+    snapshot.car.onGround = true;
+    snapshot.time += tick;
+    CCP_CHECK(detector.Scan(snapshot) & EventBit(GameEvent::Landing));
+}
+
+CCP_TEST(EventDetector, BallHighReleasesBelowItsHysteresis) {
+    EventDetector detector;
+    WorldSnapshot snapshot = MakeSnapshot(1.0);
+    detector.Scan(snapshot);
+
+    snapshot.time += tick;
+    snapshot.ball.location.Z = 1000.0f;
+    CCP_CHECK(detector.Scan(snapshot) == EventBit(GameEvent::BallHigh));
+
+    // Dipping under the threshold but above 90% of it holds the bit
+    snapshot.time += tick;
+    snapshot.ball.location.Z = 950.0f;
+    detector.Scan(snapshot);
+    snapshot.time += tick;
+    snapshot.ball.location.Z = 1000.0f;
+    CCP_CHECK(detector.Scan(snapshot) == 0);
+
+    snapshot.time += tick;
+    snapshot.ball.location.Z = 850.0f;
+    detector.Scan(snapshot);
+    CCP_CHECK(!(detector.GetActive() & EventBit(GameEvent::BallHigh)));
+    snapshot.time += tick;
+    snapshot.ball.location.Z = 1000.0f;
+    CCP_CHECK(detector.Scan(snapshot) == EventBit(GameEvent::BallHigh));
+}
+
+CCP_TEST(EventDetector, MissingSourceHoldsItsBits) {
+    EventDetector detector;
+    WorldSnapshot snapshot = MakeSnapshot(1.0);
+    snapshot.car.supersonic = true;
+    detector.Scan(snapshot);
+
+    // A respawn: no car for a few ticks, then back without supersonic
+    snapshot.hasCar = false;
+    snapshot.car = {};
+    snapshot.time += tick;
+    CCP_CHECK(detector.Scan(snapshot) == 0);
+    CCP_CHECK(detector.GetActive() & EventBit(GameEvent::Supersonic));
+
+    snapshot.hasCar = true;
+    snapshot.car.boost = 0.5f;
+    snapshot.time += tick;
+    detector.Scan(snapshot);
+    snapshot.car.supersonic = true;
+    snapshot.time += tick;
+    CCP_CHECK(detector.Scan(snapshot) == EventBit(GameEvent::Supersonic));
+}
+
+CCP_TEST(EventDetector, LongGapReprimes) {
+    EventDetector detector;
+    WorldSnapshot snapshot = MakeSnapshot(1.0);
+    detector.Scan(snapshot);
+
+    // Supersonic after a pause is the state it came back in, not an edge
+    snapshot.time += 1.0;
+    snapshot.car.supersonic = true;
+    CCP_CHECK(detector.Scan(snapshot) == 0);
+
+    snapshot.time += tick;
+    snapshot.car.supersonic = false;
+    detector.Scan(snapshot);
+    snapshot.time += tick;
+    snapshot.car.supersonic = true;
+    CCP_CHECK(detector.Scan(snapshot) == EventBit(GameEvent::Supersonic));
+}
@@ -0,0 +1,60 @@
+#include "Test.h"
+
+#include "EventFilter.h"
+
+using Verdict = EventFilter::Verdict;
+
+CCP_TEST(EventFilter, LeadingEdgePassesFirstOfBurst) {
+    EventFilter filter;
+    // Ball Touch: 0.2 s = 24 ticks from the burst's first event
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 100) == Verdict::Pass);
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 110) == Verdict::Suppress);
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 123) == Verdict::Suppress);
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 124) == Verdict::Pass);
+
+    const EventFilterStats& stats = filter.GetStats(GameEvent::BallTouch);
+    CCP_CHECK(stats.passed == 2);
+    CCP_CHECK(stats.suppressed == 2);
+    CCP_CHECK(stats.lastBurst == 3);
+}
+
+CCP_TEST(EventFilter, CoalescingRestartsTheWindow) {
+    EventFilter filter;
+    // Flip: 0.25 s = 30 ticks from the last occurrence
+    CCP_CHECK(filter.Offer(GameEvent::Flip, 0) == Verdict::Pass);
+    CCP_CHECK(filter.Offer(GameEvent::Flip, 20) == Verdict::Suppress);
+    CCP_CHECK(filter.Offer(GameEvent::Flip, 40) == Verdict::Suppress);
+    CCP_CHECK(filter.Offer(GameEvent::Flip, 69) == Verdict::Suppress);
+    CCP_CHECK(filter.Offer(GameEvent::Flip, 99) == Verdict::Pass);
+}
+
+CCP_TEST(EventFilter, TrailingEdgeReportsBurstOnClose) {
+    EventFilter filter;
+    filter.SetPolicy(GameEvent::Jump, { 0.1f, DebounceEdge::Trailing, false });
+    CCP_CHECK(filter.Offer(GameEvent::Jump, 0) == Verdict::Defer);
+    CCP_CHECK(filter.Offer(GameEvent::Jump, 5) == Verdict::Suppress);
+    CCP_CHECK(filter.IsOpen(GameEvent::Jump));
+    CCP_CHECK(filter.GetDeadline(GameEvent::Jump) == 12);
+
+    CCP_CHECK(filter.Close(GameEvent::Jump, 11) == 0);
+    CCP_CHECK(filter.Close(GameEvent::Jump, 12) == 2);
+    CCP_CHECK(!filter.IsOpen(GameEvent::Jump));
+    CCP_CHECK(filter.Offer(GameEvent::Jump, 13) == Verdict::Defer);
+}
+
+CCP_TEST(EventFilter, NoCooldownPassesEverything) {
+    EventFilter filter;
+    for (uint64_t tick = 0; tick < 5; ++tick) CCP_CHECK(filter.Offer(GameEvent::Explosion, tick) == Verdict::Pass);
+    CCP_CHECK(filter.GetStats(GameEvent::Explosion).passed == 5);
+
+    filter.SetPolicy(GameEvent::BallTouch, {});
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 0) == Verdict::Pass);
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 1) == Verdict::Pass);
+}
+
+CCP_TEST(EventFilter, ResetWindowsForgetsBursts) {
+    EventFilter filter;
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 0) == Verdict::Pass);
+    filter.ResetWindows();
+    CCP_CHECK(filter.Offer(GameEvent::BallTouch, 1) == Verdict::Pass);
+}
@@ -0,0 +1,107 @@
+#include "Test.h"
+
+#include "HookRegistry.h"
+#include "MockHost.h"
+
+namespace {
+    const std::string hookName = "Function Test.Hook";
+
+    struct Fixture {
+        MockHost host;
+        HookRegistry hooks{ host };
+        int calls = 0;
+
+        Fixture() {
+            host.keepLog = false;
+            hooks.Resume();
+        }
+
+        ~Fixture() {
+            CCP_CHECK(host.hookChangesWhileFiring == 0);
+        }
+
+        void Acquire() {
+            hooks.Acquire(hookName, [this]() { calls++; });
+        }
+    };
+}
+
+CCP_TEST(HookRegistry, InstalledWhileReferenced) {
+    Fixture f;
+    f.Acquire();
+    f.Acquire();
+    CCP_CHECK(f.hooks.GetRefCount(hookName) == 2);
+    CCP_CHECK(f.host.IsHooked(hookName));
+
+    f.hooks.Release(hookName);
+    f.host.Flush();
+    CCP_CHECK(f.host.IsHooked(hookName));
+    f.host.FireEvent(hookName);
+    CCP_CHECK(f.calls == 1);
+
+    f.hooks.Release(hookName);
+    // Extra releases don't underflow
+    f.hooks.Release(hookName);
+    CCP_CHECK(f.hooks.GetRefCount(hookName) == 0);
+}
+
+CCP_TEST(HookRegistry, LastReleaseUnhooksOnFlush) {
+    Fixture f;
+    f.Acquire();
+    f.hooks.Release(hookName);
+    CCP_CHECK(f.host.IsHooked(hookName));
+
+    // Calls before the deferred unhook runs are dropped
+    f.host.FireEvent(hookName);
+    CCP_CHECK(f.calls == 0);
+    CCP_CHECK(!f.host.IsHooked(hookName));
+    CCP_CHECK(f.hooks.GetInstalledCount() == 0);
+}
+
+CCP_TEST(HookRegistry, ReleaseInsideTheHookWaitsUntilItReturns) {
+    Fixture f;
+    f.hooks.Acquire(hookName, [&f]() {
+        f.calls++;
+        f.hooks.Release(hookName);
+        });
+    CCP_CHECK(f.host.FireEvent(hookName));
+    CCP_CHECK(f.calls == 1);
+    CCP_CHECK(!f.host.IsHooked(hookName));
+}
+
+CCP_TEST(HookRegistry, ReacquireBeforeFlushKeepsTheHook) {
+    Fixture f;
+    f.Acquire();
+    f.hooks.Release(hookName);
+    f.Acquire();
+    f.host.Flush();
+    CCP_CHECK(f.hooks.IsInstalled(hookName));
+    CCP_CHECK(f.host.IsHooked(hookName));
+    // The first callback is kept, and installed once
+    f.host.FireEvent(hookName);
+    CCP_CHECK(f.calls == 1);
+}
+
+CCP_TEST(HookRegistry, SuspendKeepsCountsForResume) {
+    Fixture f;
+    f.Acquire();
+    f.hooks.Suspend();
+    CCP_CHECK(!f.host.IsHooked(hookName));
+    CCP_CHECK(f.hooks.GetRefCount(hookName) == 1);
+
+    // Acquired while suspended: counted, installed on resume
+    f.hooks.Acquire("Function Test.Other", []() {});
+    CCP_CHECK(!f.host.IsHooked("Function Test.Other"));
+    f.hooks.Resume();
+    CCP_CHECK(f.host.IsHooked(hookName));
+    CCP_CHECK(f.host.IsHooked("Function Test.Other"));
+    CCP_CHECK(f.hooks.GetInstalledCount() == 2);
+}
+
+CCP_TEST(HookRegistry, CarHooksGetTheirCaller) {
+    Fixture f;
+    CarHandle seen = 0;
+    f.hooks.Acquire(hookName, [&seen](CarHandle caller) { seen = caller; });
+    f.host.FireEvent(hookName, 0x1234);
+    CCP_CHECK(seen == 0x1234);
+}
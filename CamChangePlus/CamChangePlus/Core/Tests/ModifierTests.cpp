@@ -0,0 +1,88 @@
+#include "Test.h"
+
+#include "CameraModifiers.h"
+
+namespace {
+    CameraModifier MakeModifier(ModifierLayer layer, BlendMode blend, float yaw, float weight = 1.0f) {
+        CameraModifier modifier;
+        modifier.layer = layer;
+        modifier.blend = blend;
+        modifier.yaw = yaw;
+        modifier.weight = weight;
+        return modifier;
+    }
+}
+
+CCP_TEST(Modifier, LayersComposeInLayerOrder) {
+    ModifierStack stack;
+    // Pushed first but composed last: the shake adds on top of the base override
+    uint32_t shake = stack.Push(MakeModifier(ModifierLayer::Shake, BlendMode::Additive, 100.0f));
+    uint32_t base = stack.Push(MakeModifier(ModifierLayer::Base, BlendMode::Override, 1000.0f));
+    CCP_CHECK(shake != 0 && base != 0 && shake != base);
+    CCP_CHECK(stack[0].id == base);
+
+    CamRotator swivel{};
+    CCP_CHECK(stack.Compose(0.0, swivel));
+    CCP_CHECK(swivel.Yaw == 1100);
+}
+
+CCP_TEST(Modifier, OverrideLerpsAndAdditiveScalesByWeight) {
+    ModifierStack stack;
+    stack.Push(MakeModifier(ModifierLayer::Base, BlendMode::Override, 1000.0f, 0.5f));
+    stack.Push(MakeModifier(ModifierLayer::Manual, BlendMode::Additive, 100.0f, 0.5f));
+
+    CamRotator swivel{};
+    swivel.Yaw = 200;
+    stack.Compose(0.0, swivel);
+    CCP_CHECK(swivel.Yaw == 650);
+}
+
+CCP_TEST(Modifier, AdditiveLayersDontAccumulateAcrossFrames) {
+    ModifierStack stack;
+    stack.Push(MakeModifier(ModifierLayer::Manual, BlendMode::Additive, 100.0f));
+
+    CamRotator swivel{};
+    stack.Compose(0.0, swivel);
+    // The game left our output alone, so the next frame starts from the same input
+    stack.Compose(0.1, swivel);
+    CCP_CHECK(swivel.Yaw == 100);
+
+    // A new game value becomes the base
+    swivel.Yaw = 500;
+    stack.Compose(0.2, swivel);
+    CCP_CHECK(swivel.Yaw == 600);
+}
+
+CCP_TEST(Modifier, FinishedFadesAreDropped) {
+    ModifierStack stack;
+    CameraModifier shake = MakeModifier(ModifierLayer::Shake, BlendMode::Additive, 0.0f);
+    shake.amplitude = 100.0f;
+    shake.frequency = 4.0f;
+    shake.startTime = 1.0;
+    shake.fadeDuration = 0.5f;
+    uint32_t id = stack.Push(shake);
+
+    CamRotator swivel{};
+    CCP_CHECK(stack.Compose(1.25, swivel));
+    CCP_CHECK(stack.GetCount() == 1);
+
+    swivel = CamRotator{};
+    CCP_CHECK(!stack.Compose(1.5, swivel));
+    CCP_CHECK(stack.IsEmpty());
+    CCP_CHECK(stack.Find(id) == nullptr);
+    // Faded to zero weight on the way out
+    CCP_CHECK(swivel.Yaw == 0 && swivel.Pitch == 0);
+}
+
+CCP_TEST(Modifier, FullStackRefusesPushes) {
+    ModifierStack stack;
+    for (size_t i = 0; i < ModifierStack::capacity; ++i) {
+        CCP_CHECK(stack.Push(MakeModifier(ModifierLayer::Base, BlendMode::Additive, 1.0f)) != 0);
+    }
+    CCP_CHECK(stack.Push(MakeModifier(ModifierLayer::Base, BlendMode::Additive, 1.0f)) == 0);
+
+    CCP_CHECK(stack.Remove(stack[0].id));
+    CCP_CHECK(stack.Push(MakeModifier(ModifierLayer::Sequence, BlendMode::Additive, 1.0f)) != 0);
+    stack.RemoveLayer(ModifierLayer::Base);
+    CCP_CHECK(stack.GetCount() == 1);
+}
@@ -0,0 +1,133 @@
+#include "Test.h"
+
+#include <filesystem>
+
+#include "BatchEvaluator.h"
+#include "MockHost.h"
+#include "SequenceEngine.h"
+#include "TraceReplay.h"
+
+namespace {
+    TraceReplay MakeReplay(std::initializer_list<std::pair<double, GameEvent>> entries) {
+        std::vector<TraceEvent> events;
+        for (const auto& [time, event] : entries) {
+            TraceEvent traced{};
+            traced.time = time;
+            traced.tick = static_cast<uint64_t>(time * TraceTickRate);
+            traced.event = event;
+            events.push_back(traced);
+        }
+        return TraceReplay(std::move(events));
+    }
+}
+
+CCP_TEST(Offline, RunMatchesLiveOrdering) {
+    TraceReplay replay = MakeReplay({ { 1.0, GameEvent::BallTouch }, { 2.0, GameEvent::Jump }, { 3.0, GameEvent::BallTouch } });
+    ReplayResult result = replay.Run({ Step("Jump", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam", 0.25f) });
+    CCP_CHECK(result.completed);
+    CCP_CHECK(result.stepsMatched == 2);
+    CCP_CHECK(result.timeline.size() == 2);
+    if (result.timeline.size() == 2) CCP_CHECK_NEAR(result.timeline[1].time, 3.25, 1.0 / TraceTickRate);
+}
+
+CCP_TEST(Offline, StepTimeoutRunsWithoutTheTickHook) {
+    TraceReplay replay = MakeReplay({ { 0.0, GameEvent::Jump }, { 3.0, GameEvent::BallTouch } });
+    ActionMapping touch = Step("Ball Touch", "Enable Ball Cam");
+    touch.timeout = 0.5f;
+    ReplayResult result = replay.Run({ touch });
+    CCP_CHECK(result.completed);
+    CCP_CHECK(result.timeline.empty());
+    CCP_CHECK_NEAR(result.completedTime, 0.5, 2.0 / TraceTickRate);
+}
+
+CCP_TEST(Offline, StallsCountOnlyArmedSteps) {
+    TraceReplay replay = MakeReplay({ { 1.0, GameEvent::BallTouch }, { 2.0, GameEvent::Explosion } });
+    ActionMapping jump = Step("Jump", "Enable Ball Cam");
+    jump.after = { 0 };
+    ActionMapping touch = Step("Ball Touch", "Enable Reverse Cam");
+    touch.after = { 0 };
+    ActionMapping flip = Step("Flip", "Disable Ball Cam");
+    flip.after = { 1, 2 };
+
+    ReplayResult result = replay.Run({ jump, touch, flip });
+    CCP_CHECK(!result.completed);
+    CCP_CHECK(result.stepsMatched == 1);
+    // The flip behind the jump never armed, so only the jump stalled
+    RunScore score = ScoreRun(result, replay.GetStartTime(), nullptr);
+    CCP_CHECK(score.stalledSteps == 0b001);
+}
+
+CCP_TEST(Offline, IndexPredictedEventsLeadTheHit) {
+    ReplayIndex index;
+    index.Add(1.0, GameEvent::Jump, 0b0111);             // Focus, Any Car and Blue Team
+    index.Add(3.0, GameEvent::PredictedWallHit, 0b1111);
+    TraceReplay replay(index);
+
+    ReplayResult result = replay.Run({ Step("Jump", "Enable Reverse Cam"),
+        Step("Predicted Wall Hit", "Enable Ball Cam", -0.5f) });
+    CCP_CHECK(result.completed);
+    CCP_CHECK(result.timeline.size() == 2);
+    if (result.timeline.size() == 2) CCP_CHECK_NEAR(result.timeline[1].time, 2.5, 1.0 / TraceTickRate);
+    // The lead only moves this run's copy; the replay keeps the hit time
+    CCP_CHECK_NEAR(replay.GetEvents().back().time, 3.0, 1e-9);
+}
+
+CCP_TEST(Offline, RecordedEventsKeepTheirCar) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "camchange_tests_cars.bin";
+    std::vector<TraceRecord> records;
+    {
+        MockHost host;
+        host.keepLog = false;
+        MatchCar other;
+        other.handle = 9;
+        other.team = 1;
+        other.state.location = { 500.0f, 0.0f, 17.0f };
+        host.cars = { { host.localCarHandle, 0, host.localCar }, other };
+
+        SequenceEngine engine(host);
+        engine.HookGameEvents();
+        TraceRecorder recorder;
+        CCP_CHECK(recorder.Open(path, 64));
+        engine.SetTraceRecorder(&recorder);
+        // The Any Car step makes other cars' touches reach the engine
+        ActionMapping anyTouch = Step("Ball Touch", "Enable Ball Cam");
+        anyTouch.car = "Any Car";
+        engine.SetSequence("shot", { Step("Ball Touch", "Enable Reverse Cam"), anyTouch });
+        engine.StartSequencePlayback();
+
+        host.FireEvent(GetEventInfo(GameEvent::BallTouch).hookName, 9);
+        host.AdvanceTime(0.5);
+        host.FireEvent(GetEventInfo(GameEvent::BallTouch).hookName);
+        engine.SetTraceRecorder(nullptr);
+        recorder.Close();
+
+        TraceReader reader;
+        CCP_CHECK(reader.Open(path));
+        for (const TraceRecord& record : reader.GetRecords()) {
+            if (record.type == static_cast<uint8_t>(TraceRecordType::Event)) records.push_back(record);
+        }
+    }
+    std::filesystem::remove(path);
+
+    uint8_t focus = 1 << static_cast<size_t>(CarBinding::Focus);
+    CCP_CHECK(records.size() == 2);
+    if (records.size() != 2) return;
+    // The other car's touch has its own state, and bindings without Focus
+    CCP_CHECK(!(records[0].bindings & focus));
+    CCP_CHECK(records[0].bindings & (1 << static_cast<size_t>(CarBinding::AnyCar)));
+    CCP_CHECK(records[0].location[0] == 500.0f);
+    CCP_CHECK(records[1].bindings & focus);
+    CCP_CHECK(records[1].location[0] == 0.0f);
+
+    // Offline, a Focus step skips the other car's touch as it did live
+    TraceReplay replay(records);
+    CCP_CHECK(replay.GetEvents()[0].otherCar);
+    ReplayResult result = replay.Run({ Step("Ball Touch", "Enable Reverse Cam") });
+    CCP_CHECK(result.timeline.size() == 1);
+    if (!result.timeline.empty()) CCP_CHECK_NEAR(result.timeline[0].time, records[1].time, 1e-9);
+
+    ActionMapping anyTouch = Step("Ball Touch", "Enable Ball Cam");
+    anyTouch.car = "Any Car";
+    result = replay.Run({ anyTouch });
+    if (!result.timeline.empty()) CCP_CHECK_NEAR(result.timeline[0].time, records[0].time, 1e-9);
+}
@@ -0,0 +1,73 @@
+#include "Test.h"
+
+#include "Predicate.h"
+
+namespace {
+    WorldSnapshot MakeSnapshot() {
+        WorldSnapshot snapshot;
+        snapshot.hasCar = true;
+        snapshot.car.location = { 0.0f, 0.0f, 17.0f };
+        snapshot.car.velocity = { 2000.0f, 0.0f, 0.0f };
+        snapshot.car.boost = 0.5f;
+        snapshot.hasBall = true;
+        snapshot.ball.location = { 300.0f, 400.0f, 17.0f };
+        return snapshot;
+    }
+
+    bool Holds(const char* source, const WorldSnapshot& snapshot) {
+        Predicate predicate;
+        CCP_CHECK(predicate.Compile(source));
+        return predicate.Evaluate(snapshot);
+    }
+}
+
+CCP_TEST(Predicate, ComparesSnapshotValues) {
+    WorldSnapshot snapshot = MakeSnapshot();
+    CCP_CHECK(Holds("car.speed > 1800 && ball.z < 100", snapshot));
+    CCP_CHECK(!Holds("car.speed > 1800 && ball.z > 600", snapshot));
+    CCP_CHECK(Holds("car.boost == 50", snapshot));
+    CCP_CHECK(Holds("ball.distance == 500", snapshot));
+    CCP_CHECK(Holds("car.grounded || car.wall", snapshot));
+}
+
+CCP_TEST(Predicate, MissingCarReadsZero) {
+    WorldSnapshot snapshot = MakeSnapshot();
+    snapshot.hasCar = false;
+    CCP_CHECK(Holds("car.speed == 0 && car.z == 0", snapshot));
+}
+
+CCP_TEST(Predicate, PrecedenceAndUnaryOperators) {
+    WorldSnapshot snapshot;
+    CCP_CHECK(Holds("1 + 2 * 3 == 7", snapshot));
+    CCP_CHECK(Holds("(1 + 2) * 3 == 9", snapshot));
+    CCP_CHECK(Holds("-(2) < 0 && !false", snapshot));
+    CCP_CHECK(Holds("(1 < 2) == 1", snapshot));
+}
+
+CCP_TEST(Predicate, ConstantsFoldToOneInstruction) {
+    Predicate predicate;
+    CCP_CHECK(predicate.Compile("1 + 2 * 3 == 7"));
+    CCP_CHECK(predicate.GetCode().size() == 1);
+    CCP_CHECK(predicate.GetCode().front().op == PredicateOp::Const);
+}
+
+CCP_TEST(Predicate, EmptyAlwaysHolds) {
+    Predicate predicate;
+    CCP_CHECK(predicate.Compile(""));
+    CCP_CHECK(predicate.IsEmpty());
+    CCP_CHECK(predicate.Evaluate(WorldSnapshot{}));
+}
+
+CCP_TEST(Predicate, ReportsErrors) {
+    Predicate predicate;
+    CCP_CHECK(!predicate.Compile("car.speed >"));
+    CCP_CHECK(!predicate.IsValid());
+    CCP_CHECK(!predicate.GetError().empty());
+
+    CCP_CHECK(!predicate.Compile("car.warp > 1"));
+    CCP_CHECK(!predicate.GetError().empty());
+
+    // A later good compile clears the error
+    CCP_CHECK(predicate.Compile("car.z > 1"));
+    CCP_CHECK(predicate.IsValid());
+}
@@ -0,0 +1,101 @@
+#include "Test.h"
+
+#include "ReplayIndex.h"
+
+namespace {
+    constexpr uint8_t focusCar = 0b0111;   // Focus, Any Car and Blue Team bindings
+    constexpr uint8_t orangeCar = 0b1010;  // Any Car and Orange Team
+    constexpr uint8_t everyCar = 0b1111;
+}
+
+CCP_TEST(ReplayIndex, CuesFollowStepOrderAndBindings) {
+    ReplayIndex index;
+    index.Add(1.0, GameEvent::BallTouch, focusCar);
+    index.Add(2.0, GameEvent::BallTouch, orangeCar);
+    index.Add(3.0, GameEvent::BallTouch, focusCar);
+    index.Add(4.0, GameEvent::Explosion, everyCar);
+    index.Finish();
+
+    ReplayCueSheet sheet;
+    sheet.Resolve(CompileSequence({ Step("Ball Touch", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam", 0.5f),
+        Step("Explosion", "Disable Ball Cam") }), index, 0.5);
+    CCP_CHECK(sheet.IsComplete());
+
+    // The orange touch isn't the focus car's; the reset comes before the last action
+    const std::vector<ReplayCue>& cues = sheet.GetCues();
+    CCP_CHECK(cues.size() == 4);
+    if (cues.size() != 4) return;
+    CCP_CHECK(cues[0].step == 0 && cues[0].time == 1.0 && !cues[0].reset);
+    CCP_CHECK(cues[1].step == 1 && cues[1].time == 3.5);
+    CCP_CHECK(cues[2].reset && cues[2].time == 4.0);
+    CCP_CHECK(cues[3].step == 2 && cues[3].time == 4.0);
+}
+
+CCP_TEST(ReplayIndex, EventsBeforeTheStartAreSkipped) {
+    ReplayIndex index;
+    index.Add(1.0, GameEvent::Jump, focusCar);
+    index.Add(2.0, GameEvent::BallTouch, focusCar);
+    index.Finish();
+
+    ReplayCueSheet sheet;
+    sheet.Resolve(CompileSequence({ Step("Jump", "Enable Ball Cam"), Step("Ball Touch", "Disable Ball Cam") }), index, 1.5);
+    CCP_CHECK(sheet.GetCues().empty());
+    CCP_CHECK(!sheet.IsComplete());
+}
+
+CCP_TEST(ReplayIndex, PredictedStepsFireAheadButNotBeforeThePreviousMatch) {
+    // Predicted hits are indexed at the contact, out of order, and sorted by Finish
+    ReplayIndex index;
+    index.Add(1.0, GameEvent::Jump, focusCar);
+    index.Add(5.8, GameEvent::Jump, focusCar);
+    index.Add(3.0, GameEvent::PredictedWallHit, everyCar);
+    index.Add(6.0, GameEvent::PredictedWallHit, everyCar);
+    index.Finish();
+    CCP_CHECK(index.GetEntries()[1].time == 3.0f);
+
+    ReplayCueSheet sheet;
+    sheet.Resolve(CompileSequence({ Step("Jump", "Enable Reverse Cam"), Step("Predicted Wall Hit", "Enable Ball Cam", -0.5f),
+        Step("Jump", "Disable Reverse Cam"), Step("Predicted Wall Hit", "Disable Ball Cam", -0.5f) }), index, 0.0);
+    const std::vector<ReplayCue>& cues = sheet.GetCues();
+    CCP_CHECK(cues.size() == 5);
+    if (cues.size() != 5) return;
+    CCP_CHECK(cues[1].step == 1);
+    CCP_CHECK_NEAR(cues[1].time, 2.5, 1e-5);
+    // Half a second ahead of 6.0 would come before the jump that armed the step
+    CCP_CHECK(cues[3].step == 3);
+    CCP_CHECK_NEAR(cues[3].time, 5.8, 1e-5);
+}
+
+CCP_TEST(ReplayIndex, LoopStartsOverToTheEnd) {
+    ReplayIndex index;
+    for (int i = 1; i <= 3; ++i) index.Add(i, GameEvent::BallTouch, focusCar);
+    index.Finish();
+
+    ReplayCueSheet sheet;
+    sheet.Resolve(CompileSequence({ Step("Ball Touch", "Toggle Reverse Cam") }), index, 0.0, true);
+    const std::vector<ReplayCue>& cues = sheet.GetCues();
+    CCP_CHECK(cues.size() == 6);
+    size_t resets = 0;
+    for (const ReplayCue& cue : cues) resets += cue.reset ? 1 : 0;
+    CCP_CHECK(resets == 3);
+}
+
+CCP_TEST(ReplayIndex, FindLooksUpTheFirstCueAtOrAfter) {
+    ReplayIndex index;
+    index.Add(1.0, GameEvent::BallTouch, focusCar);
+    index.Add(3.0, GameEvent::BallTouch, focusCar);
+    index.Add(3.2, GameEvent::Explosion, everyCar);
+    index.Finish();
+
+    ReplayCueSheet sheet;
+    sheet.Resolve(CompileSequence({ Step("Ball Touch", "Enable Reverse Cam"), Step("Ball Touch", "Enable Ball Cam", 0.5f),
+        Step("Explosion", "Disable Ball Cam") }), index, 0.0);
+    // Cues: 1.0, 3.2 (reset), 3.2, 3.5
+    CCP_CHECK(sheet.GetCues().size() == 4);
+    CCP_CHECK(sheet.Find(0.0) == 0);
+    CCP_CHECK(sheet.Find(1.0) == 0);
+    CCP_CHECK(sheet.Find(1.1) == 1);
+    CCP_CHECK(sheet.Find(3.2) == 1);
+    CCP_CHECK(sheet.Find(3.3) == 3);
+    CCP_CHECK(sheet.Find(100.0) == 4);
+}
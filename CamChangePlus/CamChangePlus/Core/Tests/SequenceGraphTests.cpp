@@ -0,0 +1,105 @@
+#include "Test.h"
+
+#include "SequenceGraph.h"
+
+namespace {
+    // A step that only needs its event and its after list
+    ActionMapping Node(const char* event, std::vector<int> after = {}) {
+        ActionMapping mapping = Step(event, "Toggle Reverse Cam");
+        mapping.after = std::move(after);
+        return mapping;
+    }
+
+    SequenceGraph Build(const std::vector<ActionMapping>& mappings) {
+        SequenceGraph graph;
+        graph.Build(CompileSequence(mappings));
+        return graph;
+    }
+}
+
+CCP_TEST(SequenceGraph, PlainListIsAChain) {
+    SequenceGraph graph = Build({ Node("Jump"), Node("Ball Touch"), Node("Flip") });
+    CCP_CHECK(graph.IsLinear());
+    CCP_CHECK(graph.GetNodeCount() == 3);
+
+    SequenceGraphState state;
+    CCP_CHECK(graph.Start(state).ready == 0b001);
+    // Only the armed node can fire
+    CCP_CHECK(graph.Fire(state, 1).ready == 0);
+    CCP_CHECK(state.fired == 0);
+
+    CCP_CHECK(graph.Fire(state, 0).ready == 0b010);
+    CCP_CHECK(graph.Fire(state, 1).ready == 0b100);
+    CCP_CHECK(!graph.IsFinished(state));
+    graph.Fire(state, 2);
+    CCP_CHECK(graph.IsFinished(state));
+    CCP_CHECK(state.fired == 0b111 && state.active == 0);
+}
+
+CCP_TEST(SequenceGraph, ForkThenJoinAll) {
+    SequenceGraph graph = Build({ Node("Jump", { 0 }), Node("Ball Touch", { 0 }), Node("Flip", { 1, 2 }) });
+    CCP_CHECK(!graph.IsLinear());
+
+    SequenceGraphState state;
+    CCP_CHECK(graph.Start(state).ready == 0b011);
+    CCP_CHECK(graph.Fire(state, 1).ready == 0);
+    CCP_CHECK(graph.Fire(state, 0).ready == 0b100);
+    CCP_CHECK(state.active == 0b100);
+}
+
+CCP_TEST(SequenceGraph, JoinAnyArmsOnFirstPredecessor) {
+    ActionMapping join = Node("Flip", { 1, 2 });
+    join.join = "Any";
+    SequenceGraph graph = Build({ Node("Jump", { 0 }), Node("Ball Touch", { 0 }), join });
+
+    SequenceGraphState state;
+    graph.Start(state);
+    CCP_CHECK(graph.Fire(state, 0).ready == 0b100);
+    CCP_CHECK(state.active == 0b110);
+}
+
+CCP_TEST(SequenceGraph, CancelDropsDependents) {
+    SequenceGraph graph = Build({ Node("Jump", { 0 }), Node("Ball Touch", { 0 }), Node("Flip", { 1, 2 }) });
+
+    SequenceGraphState state;
+    graph.Start(state);
+    SequenceGraphUpdate update = graph.Cancel(state, 0b001);
+    // The all-join can no longer arm, so it goes with its predecessor
+    CCP_CHECK(update.cancelled == 0b101);
+    CCP_CHECK(state.active == 0b010);
+    graph.Fire(state, 1);
+    CCP_CHECK(graph.IsFinished(state));
+}
+
+CCP_TEST(SequenceGraph, RaceWinnerCancelsTheRest) {
+    ActionMapping jump = Node("Jump", { 0 });
+    ActionMapping touch = Node("Ball Touch", { 0 });
+    jump.race = touch.race = 1;
+    SequenceGraph graph = Build({ jump, touch, Node("Flip", { 1 }) });
+
+    SequenceGraphState state;
+    graph.Start(state);
+    SequenceGraphUpdate update = graph.Fire(state, 1);
+    // Step 3 waited on the loser, so it goes too
+    CCP_CHECK(update.cancelled == 0b101);
+    CCP_CHECK(state.cancelled == 0b101);
+    CCP_CHECK(graph.IsFinished(state));
+}
+
+CCP_TEST(SequenceGraph, ForwardReferencesAreIgnored) {
+    std::vector<SequenceStep> steps = CompileSequence({ Node("Jump", { 2 }), Node("Ball Touch", { 3 }) });
+    CCP_CHECK(steps[0].after == 0);
+    // Nothing valid left, so it follows the previous step
+    CCP_CHECK(steps[1].after == 0b01);
+}
+
+CCP_TEST(SequenceGraph, FiringAnUnknownNodeChangesNothing) {
+    SequenceGraph graph = Build({ Node("Jump"), Node("Ball Touch") });
+    SequenceGraphState state;
+    graph.Start(state);
+    for (size_t node : { size_t(2), size_t(63), size_t(64), size_t(200) }) {
+        SequenceGraphUpdate update = graph.Fire(state, node);
+        CCP_CHECK(update.ready == 0 && update.cancelled == 0);
+    }
+    CCP_CHECK(state.active == 0b01 && state.fired == 0);
+}
@@ -0,0 +1,161 @@
+#include "Test.h"
+
+#include <string>
+
+#include "SequenceTask.h"
+
+namespace {
+    constexpr uint8_t focusBinding = 1 << static_cast<size_t>(CarBinding::Focus);
+
+    struct Fixture {
+        SequenceRuntime runtime;
+        WorldSnapshot snapshot;
+        std::string log;
+        uint64_t tick = 0;
+
+        bool Dispatch(GameEvent event, uint8_t bindings = focusBinding) {
+            return runtime.Dispatch({ event }, bindings, snapshot, tick);
+        }
+    };
+
+    SequenceTask LogAfter(Fixture& f, GameEvent event, char mark) {
+        co_await WaitFor(event);
+        f.log += mark;
+    }
+
+    SequenceTask LogEvery(Fixture& f, GameEvent event, char mark) {
+        for (;;) {
+            co_await WaitFor(event);
+            f.log += mark;
+        }
+    }
+
+    // Dispatches inner from inside its own resume
+    SequenceTask DispatchInside(Fixture& f, GameEvent event, GameEvent inner) {
+        co_await WaitFor(event);
+        f.log += '(';
+        f.Dispatch(inner);
+        f.log += ')';
+    }
+
+    SequenceTask CancelOther(Fixture& f, GameEvent event, SequenceRuntime::TaskId& other) {
+        co_await WaitFor(event);
+        f.runtime.Cancel(other);
+        f.log += 'c';
+    }
+
+    SequenceTask Sleep(Fixture& f, uint32_t ticks) {
+        co_await WaitTicks(ticks);
+        f.log += 't';
+    }
+
+    SequenceTask WaitWithin(Fixture& f, GameEvent event, uint32_t ticks) {
+        SequenceEvent arrived = co_await WaitFor(event).Within(ticks);
+        f.log += arrived.event == GameEvent::Invalid ? 'x' : 'e';
+    }
+}
+
+CCP_TEST(SequenceRuntime, WaitersResumeInOrder) {
+    Fixture f;
+    f.runtime.Spawn(LogAfter(f, GameEvent::Jump, 'a'), 0);
+    f.runtime.Spawn(LogAfter(f, GameEvent::Jump, 'b'), 0);
+    f.runtime.Spawn(LogAfter(f, GameEvent::Flip, 'f'), 0);
+    CCP_CHECK(f.runtime.GetTaskCount() == 3);
+    CCP_CHECK(f.runtime.GetWaitedEvents() == (EventBit(GameEvent::Jump) | EventBit(GameEvent::Flip)));
+
+    CCP_CHECK(!f.Dispatch(GameEvent::BallTouch));
+    CCP_CHECK(f.Dispatch(GameEvent::Jump));
+    CCP_CHECK(f.log == "ab");
+    // Finished frames are gone
+    CCP_CHECK(f.runtime.GetTaskCount() == 1);
+}
+
+CCP_TEST(SequenceRuntime, WaitingAgainIsNotResumedTwice) {
+    Fixture f;
+    SequenceRuntime::TaskId id = f.runtime.Spawn(LogEvery(f, GameEvent::Jump, 'j'), 0);
+    f.Dispatch(GameEvent::Jump);
+    CCP_CHECK(f.log == "j");
+    f.Dispatch(GameEvent::Jump);
+    CCP_CHECK(f.log == "jj");
+
+    f.runtime.Cancel(id);
+    CCP_CHECK(!f.runtime.IsAlive(id));
+    CCP_CHECK(f.runtime.GetWaitedEvents() == 0);
+    CCP_CHECK(!f.Dispatch(GameEvent::Jump));
+}
+
+CCP_TEST(SequenceRuntime, BindingsFilterCarEvents) {
+    Fixture f;
+    f.runtime.Spawn(LogAfter(f, GameEvent::BallTouch, 't'), 0);
+    uint8_t otherCar = 1 << static_cast<size_t>(CarBinding::AnyCar);
+    CCP_CHECK(!f.runtime.IsWaiting(GameEvent::BallTouch, otherCar, f.snapshot));
+    CCP_CHECK(!f.Dispatch(GameEvent::BallTouch, otherCar));
+    CCP_CHECK(f.Dispatch(GameEvent::BallTouch, focusBinding | otherCar));
+    CCP_CHECK(f.log == "t");
+}
+
+CCP_TEST(SequenceRuntime, EarlierTaskCancelsALaterOne) {
+    Fixture f;
+    SequenceRuntime::TaskId later = 0;
+    f.runtime.Spawn(CancelOther(f, GameEvent::Jump, later), 0);
+    later = f.runtime.Spawn(LogAfter(f, GameEvent::Jump, 'l'), 0);
+    f.Dispatch(GameEvent::Jump);
+    CCP_CHECK(f.log == "c");
+    CCP_CHECK(!f.runtime.IsAlive(later));
+    CCP_CHECK(f.runtime.GetTaskCount() == 0);
+}
+
+CCP_TEST(SequenceRuntime, NestedDispatchKeepsTheOuterResumeList) {
+    Fixture f;
+    f.runtime.Spawn(DispatchInside(f, GameEvent::Jump, GameEvent::Flip), 0);
+    f.runtime.Spawn(LogAfter(f, GameEvent::Flip, 'f'), 0);
+    f.runtime.Spawn(LogAfter(f, GameEvent::Jump, 'j'), 0);
+    // A nested dispatch of the same event finds nothing left waiting on it
+    f.runtime.Spawn(DispatchInside(f, GameEvent::Landing, GameEvent::Landing), 0);
+    f.runtime.Spawn(LogAfter(f, GameEvent::Landing, 'l'), 0);
+
+    f.Dispatch(GameEvent::Jump);
+    CCP_CHECK(f.log == "(f)j");
+    f.Dispatch(GameEvent::Landing);
+    CCP_CHECK(f.log == "(f)j()l");
+    CCP_CHECK(f.runtime.GetTaskCount() == 0);
+}
+
+CCP_TEST(SequenceRuntime, WaitTicksResumesOnItsTick) {
+    Fixture f;
+    f.runtime.Spawn(Sleep(f, 3), 10);
+    CCP_CHECK(f.runtime.HasTickWaiters());
+    f.runtime.Tick(12);
+    CCP_CHECK(f.log.empty());
+    f.runtime.Tick(13);
+    CCP_CHECK(f.log == "t");
+    CCP_CHECK(!f.runtime.HasTickWaiters());
+
+    // Zero ticks doesn't suspend
+    f.runtime.Spawn(Sleep(f, 0), 13);
+    CCP_CHECK(f.log == "tt");
+}
+
+CCP_TEST(SequenceRuntime, TimedWaitsGiveUp) {
+    Fixture f;
+    f.runtime.Spawn(WaitWithin(f, GameEvent::Jump, 5), 0);
+    f.runtime.Spawn(WaitWithin(f, GameEvent::Flip, 5), 0);
+    f.tick = 2;
+    f.Dispatch(GameEvent::Flip);
+    CCP_CHECK(f.log == "e");
+    f.runtime.Tick(4);
+    CCP_CHECK(f.log == "e");
+    f.runtime.Tick(5);
+    CCP_CHECK(f.log == "ex");
+    CCP_CHECK(f.runtime.GetWaitedEvents() == 0);
+    CCP_CHECK(f.runtime.GetTaskCount() == 0);
+}
+
+CCP_TEST(SequenceRuntime, FramesComeBackFromThePool) {
+    Fixture f;
+    f.runtime.Spawn(LogAfter(f, GameEvent::Jump, 'a'), 0);
+    f.Dispatch(GameEvent::Jump);
+    uint64_t reused = FramePool::GetReused();
+    f.runtime.Spawn(LogAfter(f, GameEvent::Jump, 'b'), 0);
+    CCP_CHECK(FramePool::GetReused() == reused + 1);
+}
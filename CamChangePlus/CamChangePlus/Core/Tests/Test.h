@@ -0,0 +1,44 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "Sequence.h"
+
+// Minimal self-registering harness for the headless behaviour tests:
+// camchange_tests runs every test, camchange_tests <suite> just that
+// suite's, and exits non-zero when any check failed.
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& GetTestCases();
+void ReportFailure(const char* file, int line, const std::string& expression);
+
+struct TestRegistrar {
+    TestRegistrar(const char* suite, const char* name, void (*run)()) { GetTestCases().push_back({ suite, name, run }); }
+};
+
+#define CCP_TEST(suite, name) \
+    static void suite##_##name(); \
+    static TestRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+// Checks keep going after a failure so one run reports every broken expectation
+#define CCP_CHECK(expression) \
+    do { if (!(expression)) ReportFailure(__FILE__, __LINE__, #expression); } while (0)
+#define CCP_CHECK_NEAR(actual, expected, tolerance) \
+    CCP_CHECK(std::abs(static_cast<double>(actual) - static_cast<double>(expected)) <= (tolerance))
+
+// A step reacting to event with action after delay; the other fields keep
+// their defaults, so tests set only what they exercise
+inline ActionMapping Step(const char* event, const char* action, float delay = 0.0f) {
+    ActionMapping mapping;
+    mapping.eventName = event;
+    mapping.actionName = action;
+    mapping.delay = delay;
+    mapping.customValue = 0.0f;
+    return mapping;
+}
@@ -0,0 +1,40 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    size_t failures = 0;
+}
+
+std::vector<TestCase>& GetTestCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+void ReportFailure(const char* file, int line, const std::string& expression) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression.c_str());
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    const char* suite = argc > 1 ? argv[1] : nullptr;
+    size_t run = 0, failed = 0;
+    for (const TestCase& test : GetTestCases()) {
+        if (suite && std::strcmp(suite, test.suite) != 0) continue;
+
+        size_t before = failures;
+        test.run();
+        run++;
+        bool passed = failures == before;
+        if (!passed) failed++;
+        std::printf("[%s] %s.%s\n", passed ? "PASS" : "FAIL", test.suite, test.name);
+    }
+
+    if (run == 0) {
+        std::fprintf(stderr, "no tests%s%s\n", suite ? " in suite " : "", suite ? suite : "");
+        return 1;
+    }
+    std::printf("%zu/%zu passed\n", run - failed, run);
+    return failed ? 1 : 0;
+}
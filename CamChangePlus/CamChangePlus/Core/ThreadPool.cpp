@@ -0,0 +1,114 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+    // Index of the pool worker running on this thread, or npos outside the pool
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local size_t currentWorker = static_cast<size_t>(-1);
+}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    // Tasks spawned by a worker stay local; external ones are spread round-robin
+    size_t target = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    queued++;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeWorkers.notify_one();
+}
+
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    allDone.wait(lock, [this]() { return pending == 0; });
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) return;
+
+    // A few chunks per worker leaves room for stealing without per-index overhead
+    size_t chunkCount = std::min(count, workers.size() * 4);
+    size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        Submit([&body, begin, end]() {
+            for (size_t i = begin; i < end; ++i) body(i);
+            });
+    }
+    Wait();
+}
+
+bool ThreadPool::TryPop(size_t index, std::function<void()>& task) {
+    auto& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued--;
+    return true;
+}
+
+bool ThreadPool::TrySteal(size_t thief, std::function<void()>& task) {
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        auto& queue = *queues[(thief + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (TryPop(index, task) || TrySteal(index, task)) {
+            task();
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping && queued == 0) return;
+        // Re-check under the lock so a Submit between the scan and the wait is not missed
+        wakeWorkers.wait(lock, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
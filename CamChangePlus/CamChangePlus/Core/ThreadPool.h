@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers, each with its own task deque. A worker pops from
+// the back of its own deque and, when that is empty, steals from the front
+// of the others, so uneven (sequence x trace) jobs still keep every core busy.
+class ThreadPool {
+public:
+    // 0 = one worker per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task);
+    // Blocks until every submitted task has finished; not callable from a task
+    void Wait();
+
+    // Runs body(i) for i in [0, count) in chunks and waits for completion
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    size_t GetThreadCount() const { return workers.size(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    bool TryPop(size_t index, std::function<void()>& task);
+    bool TrySteal(size_t thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable allDone;
+    std::atomic<size_t> pending{ 0 };   // Submitted but not finished
+    std::atomic<size_t> queued{ 0 };    // Sitting in a deque, not yet picked up
+    std::atomic<size_t> nextQueue{ 0 }; // Round-robin target for external submits
+    bool stopping = false;
+};
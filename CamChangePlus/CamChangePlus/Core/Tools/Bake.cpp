@@ -0,0 +1,98 @@
+// camchange_bake: bakes the camera path a shot produces over a recorded
+// trace or a scanned replay index into a packed camera path file, or dumps
+// such a file to CSV
+//
+//   camchange_bake <trace file | replay .idx> <shots json> <sequence> <out file>
+//   camchange_bake --dump <camera path file>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "CameraPath.h"
+#include "ReplayIndex.h"
+#include "ShotLibrary.h"
+#include "TraceRecorder.h"
+#include "TraceReplay.h"
+
+namespace {
+    int Dump(const char* filepath) {
+        CameraPathReader reader;
+        if (!reader.Open(filepath)) {
+            std::fprintf(stderr, "error: %s\n", reader.GetError().c_str());
+            return 1;
+        }
+
+        std::printf("tick,time,yaw,pitch,fov,distance,height,angle,behind_view,ball_cam\n");
+        CameraPathSample sample;
+        while (reader.Next(sample)) {
+            std::printf("%llu,%.6f,%d,%d,%g,%g,%g,%g,%d,%d\n", static_cast<unsigned long long>(sample.tick),
+                sample.tick / reader.GetTickRate(), sample.yaw, sample.pitch, sample.fov, sample.distance,
+                sample.height, sample.angle, (sample.flags & CameraPathFlag_BehindView) != 0,
+                (sample.flags & CameraPathFlag_BallCam) != 0);
+        }
+        if (!reader.GetError().empty()) {
+            std::fprintf(stderr, "error: %s\n", reader.GetError().c_str());
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--dump") == 0) return Dump(argv[2]);
+    if (argc < 5) {
+        std::fprintf(stderr, "usage: %s <trace file | replay .idx> <shots json> <sequence> <out file>\n"
+            "       %s --dump <camera path file>\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    TraceReplay replay;
+    std::string source = argv[1];
+    if (source.size() > 4 && source.compare(source.size() - 4, 4, ".idx") == 0) {
+        ReplayIndex index;
+        if (!index.Load(source)) {
+            std::fprintf(stderr, "error: cannot read replay index %s\n", argv[1]);
+            return 1;
+        }
+        replay = TraceReplay(index);
+    }
+    else {
+        TraceReader reader;
+        if (!reader.Open(source)) {
+            std::fprintf(stderr, "error: %s\n", reader.GetError().c_str());
+            return 1;
+        }
+        replay = TraceReplay(reader.GetRecords());
+    }
+
+    ShotLibrary library(argv[2]);
+    std::vector<ActionMapping> sequence;
+    if (!library.Load(argv[3], sequence)) {
+        std::fprintf(stderr, "error: sequence '%s' not found in %s\n", argv[3], argv[2]);
+        return 1;
+    }
+
+    CameraPathWriter writer;
+    if (!writer.Open(argv[4])) {
+        std::fprintf(stderr, "error: cannot write %s\n", argv[4]);
+        return 1;
+    }
+
+    auto wallStart = std::chrono::steady_clock::now();
+    ReplayResult result = replay.Bake(sequence, writer);
+    if (!writer.Close()) {
+        std::fprintf(stderr, "error: writing %s failed\n", argv[4]);
+        return 1;
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::fprintf(stderr, "%s: %zu/%zu steps matched%s\n", argv[3], result.stepsMatched, sequence.size(),
+        result.completed ? " (completed)" : "");
+    std::fprintf(stderr, "%llu ticks baked in %.3f ms, %llu bytes (%.2f per tick)\n",
+        static_cast<unsigned long long>(writer.GetSampleCount()), wallSeconds * 1000.0,
+        static_cast<unsigned long long>(writer.GetByteCount()),
+        writer.GetSampleCount() ? static_cast<double>(writer.GetByteCount()) / writer.GetSampleCount() : 0.0);
+    return 0;
+}
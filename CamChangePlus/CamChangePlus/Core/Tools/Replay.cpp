@@ -0,0 +1,67 @@
+// camchange_replay: runs shots from the library against a recorded trace on
+// a virtual clock and prints the action timeline each one produces
+//
+//   camchange_replay <trace file> <shots json> [sequence ...]
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TraceRecorder.h"
+#include "TraceReplay.h"
+#include "ShotLibrary.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <trace file> <shots json> [sequence ...]\n", argv[0]);
+        return 2;
+    }
+
+    TraceReader reader;
+    if (!reader.Open(argv[1])) {
+        std::fprintf(stderr, "error: %s\n", reader.GetError().c_str());
+        return 1;
+    }
+
+    ShotLibrary library(argv[2]);
+    auto shots = library.LoadAll();
+    if (argc > 3) {
+        std::map<std::string, std::vector<ActionMapping>> selected;
+        for (int i = 3; i < argc; ++i) {
+            auto it = shots.find(argv[i]);
+            if (it == shots.end()) {
+                std::fprintf(stderr, "error: sequence '%s' not found in %s\n", argv[i], argv[2]);
+                return 1;
+            }
+            selected.insert(*it);
+        }
+        shots = std::move(selected);
+    }
+    if (shots.empty()) {
+        std::fprintf(stderr, "error: no sequences in %s\n", argv[2]);
+        return 1;
+    }
+
+    TraceReplay replay(reader.GetRecords());
+
+    auto wallStart = std::chrono::steady_clock::now();
+    std::printf("sequence,time,tick,step,action,value\n");
+    for (const auto& [name, sequence] : shots) {
+        ReplayResult result = replay.Run(sequence);
+        for (const auto& entry : result.timeline) {
+            std::printf("%s,%.6f,%llu,%zu,%s,%g\n", name.c_str(), entry.time - replay.GetStartTime(),
+                static_cast<unsigned long long>(entry.tick), entry.step, GetActionName(entry.action), entry.value);
+        }
+        std::fprintf(stderr, "%s: %zu/%zu steps matched%s\n", name.c_str(), result.stepsMatched, sequence.size(),
+            result.completed ? " (completed)" : "");
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    double simulated = replay.GetDuration() * shots.size();
+    std::fprintf(stderr, "%zu events, %.1f s simulated in %.3f ms (%.0fx real time)\n",
+        replay.GetEvents().size(), simulated, wallSeconds * 1000.0,
+        wallSeconds > 0.0 ? simulated / wallSeconds : 0.0);
+    return 0;
+}
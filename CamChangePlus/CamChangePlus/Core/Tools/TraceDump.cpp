@@ -0,0 +1,69 @@
+// camchange_tracedump: converts a CamChangePlus ring trace to CSV or JSON
+//
+//   camchange_tracedump <trace file> [--json]
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "TraceRecorder.h"
+#include "GameEvents.h"
+#include "Sequence.h"
+
+namespace {
+    const char* TypeName(uint8_t type) {
+        return type == static_cast<uint8_t>(TraceRecordType::Event) ? "event" : "action";
+    }
+
+    const char* ActionName(uint8_t action) {
+        return action == static_cast<uint8_t>(CameraAction::Invalid) ? "" : GetActionName(static_cast<CameraAction>(action));
+    }
+
+    void WriteCsv(const TraceReader& reader) {
+        std::printf("tick,time,type,event,action,step,bindings,flags,latency_us,value,x,y,z,vx,vy,vz,boost\n");
+        for (const auto& r : reader.GetRecords()) {
+            std::printf("%llu,%.6f,%s,%s,%s,%u,%u,%u,%d,%g,%g,%g,%g,%g,%g,%g,%g\n",
+                static_cast<unsigned long long>(r.tick), r.time, TypeName(r.type),
+                GetEventName(static_cast<GameEvent>(r.eventId)), ActionName(r.actionId),
+                r.step, r.bindings, r.flags, r.latencyUs, r.value,
+                r.location[0], r.location[1], r.location[2],
+                r.velocity[0], r.velocity[1], r.velocity[2], r.boost);
+        }
+    }
+
+    void WriteJson(const TraceReader& reader) {
+        const auto& records = reader.GetRecords();
+        std::printf("{\"dropped\":%llu,\"records\":[\n", static_cast<unsigned long long>(reader.GetDroppedCount()));
+        for (size_t i = 0; i < records.size(); ++i) {
+            const auto& r = records[i];
+            std::printf("{\"tick\":%llu,\"time\":%.6f,\"type\":\"%s\",\"event\":\"%s\",\"action\":\"%s\","
+                "\"step\":%u,\"bindings\":%u,\"flags\":%u,\"latency_us\":%d,\"value\":%g,"
+                "\"location\":[%g,%g,%g],\"velocity\":[%g,%g,%g],\"boost\":%g}%s\n",
+                static_cast<unsigned long long>(r.tick), r.time, TypeName(r.type),
+                GetEventName(static_cast<GameEvent>(r.eventId)), ActionName(r.actionId),
+                r.step, r.bindings, r.flags, r.latencyUs, r.value,
+                r.location[0], r.location[1], r.location[2],
+                r.velocity[0], r.velocity[1], r.velocity[2], r.boost,
+                i + 1 < records.size() ? "," : "");
+        }
+        std::printf("]}\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <trace file> [--json]\n", argv[0]);
+        return 2;
+    }
+
+    TraceReader reader;
+    if (!reader.Open(argv[1])) {
+        std::fprintf(stderr, "error: %s\n", reader.GetError().c_str());
+        return 1;
+    }
+
+    bool json = argc > 2 && std::strcmp(argv[2], "--json") == 0;
+    if (json) WriteJson(reader);
+    else WriteCsv(reader);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// camchange_tune: fits a sequence's delays (and optionally values) to target
+// cut times over recorded traces and saves the result to the library
+//
+//   camchange_tune <shots json> <sequence> --targets targets.csv [--threads N]
+//                  [--values] [--save name] <trace> [trace ...]
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "AutoTuner.h"
+#include "ShotLibrary.h"
+#include "TraceRecorder.h"
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::fprintf(stderr, "usage: %s <shots json> <sequence> --targets targets.csv [--threads N] [--values] [--save name] <trace> [trace ...]\n", argv[0]);
+        return 2;
+    }
+
+    std::string sequenceName = argv[2];
+    std::string saveName = sequenceName + " (tuned)";
+    std::string targetsPath;
+    size_t threads = 0;
+    TuneOptions options;
+    std::vector<std::string> tracePaths;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = std::stoul(argv[++i]);
+        else if (std::strcmp(argv[i], "--targets") == 0 && i + 1 < argc) targetsPath = argv[++i];
+        else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc) saveName = argv[++i];
+        else if (std::strcmp(argv[i], "--values") == 0) options.tuneValues = true;
+        else tracePaths.push_back(argv[i]);
+    }
+    if (targetsPath.empty() || tracePaths.empty()) {
+        std::fprintf(stderr, "error: --targets and at least one trace are required\n");
+        return 2;
+    }
+
+    ShotLibrary library(argv[1]);
+    std::vector<ActionMapping> sequence;
+    if (!library.Load(sequenceName, sequence)) {
+        std::fprintf(stderr, "error: sequence '%s' not found in %s\n", sequenceName.c_str(), argv[1]);
+        return 1;
+    }
+
+    std::vector<BatchTrace> traces;
+    for (const auto& path : tracePaths) {
+        TraceReader reader;
+        if (!reader.Open(path)) {
+            std::fprintf(stderr, "error: %s: %s\n", path.c_str(), reader.GetError().c_str());
+            return 1;
+        }
+        traces.push_back({ std::filesystem::path(path).filename().string(), TraceReplay(reader.GetRecords()), {} });
+    }
+    if (!LoadFireTargets(targetsPath, traces)) {
+        std::fprintf(stderr, "error: cannot read %s\n", targetsPath.c_str());
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    AutoTuner tuner(pool, traces);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    TuneResult result = tuner.Tune(sequenceName, sequence, options);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    for (size_t i = 0; i < result.sequence.size(); ++i) {
+        const auto& before = sequence[i];
+        const auto& after = result.sequence[i];
+        std::printf("step %zu %s -> %s: delay %.3f -> %.3f, value %.2f -> %.2f\n", i,
+            after.eventName.c_str(), after.actionName.c_str(), before.delay, after.delay, before.customValue, after.customValue);
+    }
+    std::fprintf(stderr, "cost %.6f -> %.6f s/target, %zu replays on %zu threads in %.3f s\n",
+        result.initialCost, result.finalCost, result.evaluations, pool.GetThreadCount(), wallSeconds);
+
+    if (!library.Save(saveName, result.sequence)) {
+        std::fprintf(stderr, "error: could not save '%s'\n", saveName.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "saved as '%s'\n", saveName.c_str());
+    return 0;
+}
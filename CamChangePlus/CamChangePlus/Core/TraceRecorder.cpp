@@ -0,0 +1,129 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+TraceRecorder::~TraceRecorder() {
+    Close();
+}
+
+bool TraceRecorder::Open(const std::filesystem::path& path, uint64_t capacity) {
+    Close();
+    if (capacity == 0) return false;
+
+    size_t size = sizeof(TraceFileHeader) + capacity * sizeof(TraceRecord);
+    void* view = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+#else
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    fileDescriptor = fd;
+#endif
+
+    filepath = path;
+    mappedSize = size;
+    header = static_cast<TraceFileHeader*>(view);
+    records = reinterpret_cast<TraceRecord*>(header + 1);
+    *header = { TraceFileMagic, TraceFileVersion, sizeof(TraceRecord), 0, capacity, 0 };
+    return true;
+}
+
+void TraceRecorder::Close() {
+    if (!header) return;
+
+#ifdef _WIN32
+    FlushViewOfFile(header, mappedSize);
+    UnmapViewOfFile(header);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    msync(header, mappedSize, MS_ASYNC);
+    munmap(header, mappedSize);
+    close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+
+    header = nullptr;
+    records = nullptr;
+    mappedSize = 0;
+}
+
+bool TraceReader::Open(const std::filesystem::path& filepath) {
+    records.clear();
+    dropped = 0;
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        error = "cannot open " + filepath.string();
+        return false;
+    }
+
+    TraceFileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != TraceFileMagic || header.recordSize != sizeof(TraceRecord) || header.capacity == 0) {
+        error = "not a CamChangePlus trace file";
+        return false;
+    }
+    if (header.version != TraceFileVersion) {
+        error = "unsupported trace version " + std::to_string(header.version);
+        return false;
+    }
+
+    // Once the ring has wrapped the oldest record lives at writeCount % capacity
+    uint64_t count = std::min(header.writeCount, header.capacity);
+    uint64_t first = header.writeCount > header.capacity ? header.writeCount % header.capacity : 0;
+    dropped = header.writeCount - count;
+
+    std::vector<TraceRecord> slots(count);
+    if (!file.read(reinterpret_cast<char*>(slots.data()), count * sizeof(TraceRecord))) {
+        error = "trace file is truncated";
+        return false;
+    }
+
+    records.reserve(count);
+    records.insert(records.end(), slots.begin() + first, slots.end());
+    records.insert(records.end(), slots.begin(), slots.begin() + first);
+    return true;
+}
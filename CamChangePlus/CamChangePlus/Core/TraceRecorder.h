@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+// Tick rate used to stamp records; matches the game's physics rate
+constexpr double TraceTickRate = 120.0;
+
+enum class TraceRecordType : uint8_t {
+    Event,        // A game event reached the sequence engine
+    ActionFired   // A scheduled camera action executed
+};
+
+enum TraceFlags : uint8_t {
+    TraceFlag_Matched    = 1 << 0, // Event advanced the running sequence
+    TraceFlag_Running    = 1 << 1, // A sequence was running
+    TraceFlag_HasCar     = 1 << 2, // Snapshot of the event's car is valid
+    TraceFlag_OnGround   = 1 << 3,
+    TraceFlag_Supersonic = 1 << 4,
+};
+
+// Fixed-size record; written straight into the mapped ring file
+struct TraceRecord {
+    uint64_t tick;
+    double time;          // Host time in seconds
+    uint8_t type;         // TraceRecordType
+    uint8_t eventId;      // GameEvent
+    uint8_t actionId;     // CameraAction, 0xFF for none
+    uint8_t flags;        // TraceFlags
+    uint16_t step;        // Sequence step the record refers to
+    uint8_t bindings;     // Event: bit per CarBinding that accepted the event's car
+    uint8_t reserved;
+    int32_t latencyUs;    // ActionFired: actual minus intended fire time
+    float value;          // Action value / customValue; event lead (s) for predicted events
+    float location[3];    // Event: the car that raised it (the focus car for non-car events)
+    float velocity[3];
+    float boost;
+};
+static_assert(sizeof(TraceRecord) == 64, "TraceRecord must stay 64 bytes");
+
+// On-disk header at offset 0 of a ring file, records follow
+struct TraceFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t capacity;     // Number of record slots
+    uint64_t writeCount;   // Total records ever written; slot = writeCount % capacity
+};
+static_assert(sizeof(TraceFileHeader) == 32, "TraceFileHeader must stay 32 bytes");
+
+constexpr uint32_t TraceFileMagic = 0x54504343; // "CCPT"
+constexpr uint32_t TraceFileVersion = 2;
+
+// Writes records into a memory-mapped ring file. Recording is a slot copy
+// and a counter bump; the OS flushes pages in the background, so the game
+// thread never blocks on file I/O. When full, the oldest records are
+// overwritten. Single writer (the game thread).
+class TraceRecorder {
+public:
+    TraceRecorder() = default;
+    ~TraceRecorder();
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    bool Open(const std::filesystem::path& filepath, uint64_t capacity);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+    void Record(const TraceRecord& record) {
+        TraceRecord* slot = records + (header->writeCount % header->capacity);
+        *slot = record;
+        header->writeCount++;
+    }
+
+    uint64_t GetWriteCount() const { return header ? header->writeCount : 0; }
+    const std::filesystem::path& GetPath() const { return filepath; }
+
+private:
+    std::filesystem::path filepath;
+    TraceFileHeader* header = nullptr;
+    TraceRecord* records = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+};
+
+// Reads a ring file back in write order (oldest surviving record first)
+class TraceReader {
+public:
+    bool Open(const std::filesystem::path& filepath);
+
+    const std::vector<TraceRecord>& GetRecords() const { return records; }
+    uint64_t GetDroppedCount() const { return dropped; }
+    const std::string& GetError() const { return error; }
+
+private:
+    std::vector<TraceRecord> records;
+    uint64_t dropped = 0;
+    std::string error;
+};
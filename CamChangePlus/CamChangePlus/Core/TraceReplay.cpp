@@ -0,0 +1,224 @@
+#include "TraceReplay.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include "BallPredictor.h"
+#include "MockHost.h"
+#include "SequenceEngine.h"
+
+namespace {
+    // Stands in for whichever other car raised an event: not the mock
+    // host's local car, so only bindings that take other cars accept it
+    constexpr CarHandle otherCarHandle = 2;
+
+    // Puts the event's car where the engine looks for its caller and
+    // returns the handle to dispatch with
+    CarHandle PlaceCar(MockHost& host, const TraceEvent& event) {
+        host.cars.clear();
+        if (!event.otherCar) {
+            host.hasLocalCar = event.hasCar;
+            host.localCar = event.car;
+            return 0;
+        }
+        if (event.hasCar) host.cars.push_back({ otherCarHandle, 0, event.car });
+        return otherCarHandle;
+    }
+
+    // A timeout that drops the last armed branch finishes the sequence too
+    void TickTasks(MockHost& host, SequenceEngine& engine, ReplayResult& result) {
+        bool wasRunning = engine.IsRunning();
+        engine.TickTasks();
+        if (wasRunning && !engine.IsRunning()) {
+            result.completed = true;
+            result.completedTime = host.GetTime();
+        }
+    }
+
+    // Steps the clock to time a tick at a time while a task waits on ticks
+    // (WaitTicks, step timeouts), so they run out as they would live; with
+    // none waiting it jumps straight there
+    void AdvanceTicks(MockHost& host, SequenceEngine& engine, double time, ReplayResult& result) {
+        auto tick = static_cast<uint64_t>(host.GetTime() * TraceTickRate) + 1;
+        for (; engine.GetRuntime().HasTickWaiters() && tick / TraceTickRate <= time; ++tick) {
+            host.AdvanceTo(tick / TraceTickRate);
+            TickTasks(host, engine, result);
+        }
+        host.AdvanceTo(time);
+    }
+
+    // Counted off the graph, so an event that fires two branches counts both
+    void Finish(const SequenceEngine& engine, ReplayResult& result) {
+        result.graph = engine.GetGraphState();
+        result.stepsMatched = static_cast<size_t>(std::popcount(result.graph.fired));
+    }
+}
+
+TraceReplay::TraceReplay(const std::vector<TraceRecord>& records) {
+    auto focus = static_cast<uint8_t>(1 << static_cast<size_t>(CarBinding::Focus));
+    events.reserve(records.size());
+    for (const auto& record : records) {
+        if (record.type != static_cast<uint8_t>(TraceRecordType::Event)) continue;
+
+        TraceEvent event{};
+        event.time = record.time;
+        event.tick = record.tick;
+        event.event = static_cast<GameEvent>(record.eventId);
+        event.lead = record.value;
+        event.otherCar = !(record.bindings & focus);
+        event.hasCar = (record.flags & TraceFlag_HasCar) != 0;
+        event.car.location = { record.location[0], record.location[1], record.location[2] };
+        event.car.velocity = { record.velocity[0], record.velocity[1], record.velocity[2] };
+        event.car.boost = record.boost;
+        event.car.onGround = (record.flags & TraceFlag_OnGround) != 0;
+        event.car.supersonic = (record.flags & TraceFlag_Supersonic) != 0;
+        events.push_back(event);
+    }
+}
+
+TraceReplay::TraceReplay(const ReplayIndex& index) : predictedAtHit(true) {
+    auto focus = static_cast<uint8_t>(1 << static_cast<size_t>(CarBinding::Focus));
+    for (const auto& entry : index.GetEntries()) {
+        TraceEvent event{};
+        event.time = entry.time;
+        event.tick = static_cast<uint64_t>(entry.time * TraceTickRate);
+        event.event = static_cast<GameEvent>(entry.event);
+        event.otherCar = !(entry.bindings & focus);
+        events.push_back(event);
+    }
+}
+
+TraceReplay::TraceReplay(std::vector<TraceEvent> events) : events(std::move(events)) {
+    std::stable_sort(this->events.begin(), this->events.end(),
+        [](const TraceEvent& a, const TraceEvent& b) { return a.time < b.time; });
+}
+
+const std::vector<TraceEvent>& TraceReplay::GetRunEvents(const std::vector<ActionMapping>& sequence,
+    std::vector<TraceEvent>& raised) const {
+    if (!predictedAtHit) return events;
+
+    // Live, the predictor raises the event once the earliest step on it is
+    // due, never more than its horizon before the hit
+    std::array<float, BallHitKindCount> leads{};
+    float horizon = BallPredictorOptions{}.horizon;
+    bool anyLead = false;
+    for (const auto& mapping : sequence) {
+        BallHitKind kind = GetBallHitKind(FindEventByName(mapping.eventName));
+        if (kind == BallHitKind::Count || mapping.delay >= 0.0f) continue;
+        float& lead = leads[static_cast<size_t>(kind)];
+        lead = std::max(lead, std::min(-mapping.delay, horizon));
+        anyLead = true;
+    }
+    if (!anyLead) return events;
+
+    raised = events;
+    for (auto& event : raised) {
+        BallHitKind kind = GetBallHitKind(event.event);
+        if (kind == BallHitKind::Count) continue;
+        event.lead = leads[static_cast<size_t>(kind)];
+        event.time = std::max(event.time - event.lead, 0.0);
+        event.tick = static_cast<uint64_t>(event.time * TraceTickRate);
+    }
+    std::stable_sort(raised.begin(), raised.end(),
+        [](const TraceEvent& a, const TraceEvent& b) { return a.time < b.time; });
+    return raised;
+}
+
+ReplayResult TraceReplay::Run(const std::vector<ActionMapping>& sequence) const {
+    ReplayResult result;
+    if (events.empty()) return result;
+
+    std::vector<TraceEvent> raised;
+    const std::vector<TraceEvent>& events = GetRunEvents(sequence, raised);
+
+    MockHost host;
+    host.keepLog = false;
+    host.AdvanceTo(events.front().time);
+
+    SequenceEngine engine(host);
+    engine.SetSequence("replay", sequence);
+    engine.SetActionObserver([&](size_t step, CameraAction action, float value) {
+        double now = host.GetTime();
+        result.timeline.push_back({ now, static_cast<uint64_t>(now * TraceTickRate), step, action, value });
+        });
+    engine.StartSequencePlayback();
+
+    for (const auto& event : events) {
+        // Sequence finished and every pending action has fired: nothing left to produce
+        if (!engine.IsRunning() && host.PendingTimers() == 0) break;
+
+        AdvanceTicks(host, engine, event.time, result);
+        CarHandle car = PlaceCar(host, event);
+
+        bool wasRunning = engine.IsRunning();
+        engine.ProcessEventActions(event.event, event.lead, car);
+        if (wasRunning && !engine.IsRunning()) {
+            result.completed = true;
+            result.completedTime = event.time;
+        }
+    }
+
+    AdvanceTicks(host, engine, host.GetTime() + drainTime, result);
+    Finish(engine, result);
+    return result;
+}
+
+ReplayResult TraceReplay::Bake(const std::vector<ActionMapping>& sequence, CameraPathWriter& writer) const {
+    ReplayResult result;
+    if (events.empty()) return result;
+
+    std::vector<TraceEvent> raised;
+    const std::vector<TraceEvent>& events = GetRunEvents(sequence, raised);
+
+    MockHost host;
+    host.keepLog = false;
+    host.AdvanceTo(events.front().time);
+
+    SequenceEngine engine(host);
+    engine.SetSequence("bake", sequence);
+    engine.SetActionObserver([&](size_t step, CameraAction action, float value) {
+        double now = host.GetTime();
+        result.timeline.push_back({ now, static_cast<uint64_t>(now * TraceTickRate), step, action, value });
+        });
+    engine.StartSequencePlayback();
+
+    auto firstTick = static_cast<uint64_t>(std::ceil(events.front().time * TraceTickRate));
+    auto lastTick = static_cast<uint64_t>((events.back().time + drainTime) * TraceTickRate);
+    size_t next = 0;
+    for (uint64_t tick = firstTick; tick <= lastTick; ++tick) {
+        double time = tick / TraceTickRate;
+        for (; next < events.size() && events[next].time <= time; ++next) {
+            const TraceEvent& event = events[next];
+            host.AdvanceTo(event.time);
+            CarHandle car = PlaceCar(host, event);
+
+            bool wasRunning = engine.IsRunning();
+            engine.ProcessEventActions(event.event, event.lead, car);
+            if (wasRunning && !engine.IsRunning()) {
+                result.completed = true;
+                result.completedTime = event.time;
+            }
+        }
+
+        // WaitTicks and step timeouts resume after the tick's events, as in OnTick
+        host.AdvanceTo(time);
+        TickTasks(host, engine, result);
+        if (host.IsHooked(CameraController::applySwivelHook)) host.FireEvent(CameraController::applySwivelHook);
+
+        CameraPathSample sample;
+        sample.tick = tick;
+        sample.yaw = host.swivel.Yaw;
+        sample.pitch = host.swivel.Pitch;
+        sample.fov = host.cameraSettings.fov;
+        sample.distance = host.cameraSettings.distance;
+        sample.height = host.cameraSettings.height;
+        sample.angle = host.cameraSettings.angle;
+        sample.flags = (host.usingBehindView ? CameraPathFlag_BehindView : 0) |
+            (host.usingSecondaryCamera ? CameraPathFlag_BallCam : 0);
+        writer.Append(sample);
+    }
+    Finish(engine, result);
+    return result;
+}
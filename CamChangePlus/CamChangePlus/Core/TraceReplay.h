@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "CamHost.h"
+#include "CameraPath.h"
+#include "GameEvents.h"
+#include "ReplayIndex.h"
+#include "Sequence.h"
+#include "SequenceGraph.h"
+#include "TraceRecorder.h"
+
+// Event taken from a recorded trace, as the engine saw it
+struct TraceEvent {
+    double time;
+    uint64_t tick;
+    GameEvent event;
+    float lead; // Seconds ahead of a predicted event it was raised
+    bool otherCar; // Raised by a car the Focus binding doesn't accept
+    bool hasCar;
+    CarState car;  // The car that raised it
+};
+
+// One camera action a sequence fired during a replay
+struct TimelineEntry {
+    double time;
+    uint64_t tick;
+    size_t step;
+    CameraAction action;
+    float value;
+};
+
+struct ReplayResult {
+    std::vector<TimelineEntry> timeline;
+    size_t stepsMatched = 0;     // Steps that fired
+    SequenceGraphState graph;    // Fired, dropped and still armed steps when the run ended
+    bool completed = false;      // Every step fired or timed out
+    double completedTime = 0.0;  // Time of the final match or timeout
+};
+
+// Feeds the events of a recorded trace through a fresh SequenceEngine on a
+// MockHost, jumping the virtual clock from event to event instead of waiting
+// for it; only while a task waits on ticks (WaitTicks, step timeouts) does
+// it step the clock tick by tick. Run() is const and builds its own
+// host/engine, so one TraceReplay can be shared by many threads.
+class TraceReplay {
+public:
+    TraceReplay() = default;
+    explicit TraceReplay(const std::vector<TraceRecord>& records);
+    explicit TraceReplay(std::vector<TraceEvent> events);
+    // The events of a scanned replay, on the replay's clock. Predicted
+    // events sit at the hit; Run() and Bake() raise them as far ahead as the
+    // sequence's earliest step on them needs, up to the predictor's horizon.
+    explicit TraceReplay(const ReplayIndex& index);
+
+    ReplayResult Run(const std::vector<ActionMapping>& sequence) const;
+    // Same run, stepped every tick through drainTime with the camera frame
+    // hook fired, writing the camera the sequence leaves on the host at
+    // each tick
+    ReplayResult Bake(const std::vector<ActionMapping>& sequence, CameraPathWriter& writer) const;
+
+    const std::vector<TraceEvent>& GetEvents() const { return events; }
+    double GetStartTime() const { return events.empty() ? 0.0 : events.front().time; }
+    double GetDuration() const { return events.empty() ? 0.0 : events.back().time - events.front().time; }
+
+    // How long after the last event pending actions may still fire
+    constexpr static double drainTime = 10.0;
+
+private:
+    // The events a run of sequence sees: these, or a copy with predicted
+    // events moved ahead of the hit when they came from an index
+    const std::vector<TraceEvent>& GetRunEvents(const std::vector<ActionMapping>& sequence,
+        std::vector<TraceEvent>& raised) const;
+
+    std::vector<TraceEvent> events;
+    bool predictedAtHit = false; // Index events: predicted ones carry no lead
+};